@@ -0,0 +1,116 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofApp.h"
+#include <cassert>
+
+
+void ofApp::setup()
+{
+    using ofxGeo::PolygonMeasure;
+
+    // A 1 x 1 degree cell on the equator has 12308.776 km^2 on WGS84.
+    ofxGeo::CoordinatePolyline cell;
+    cell.addVertex(ofxGeo::Coordinate(0, 0));
+    cell.addVertex(ofxGeo::Coordinate(0, 1));
+    cell.addVertex(ofxGeo::Coordinate(1, 1));
+    cell.addVertex(ofxGeo::Coordinate(1, 0));
+
+    check("WGS84 1x1 degree cell area (km^2)",
+          PolygonMeasure::area(cell, PolygonMeasure::ELLIPSOID),
+          12308.776,
+          0.001);
+
+    // The equator bounds a hemisphere, half of the 510065621.7 km^2 surface
+    // of WGS84.
+    ofxGeo::CoordinatePolyline equator;
+
+    for (int longitude = -180; longitude < 180; longitude += 90)
+        equator.addVertex(ofxGeo::Coordinate(0, longitude));
+
+    check("WGS84 surface area (km^2)",
+          2 * std::abs(PolygonMeasure::area(equator, PolygonMeasure::ELLIPSOID)),
+          510065621.7,
+          0.1);
+
+    // An octant of the sphere, bounded by the equator and two meridians.
+    ofxGeo::CoordinatePolyline octant;
+    octant.addVertex(ofxGeo::Coordinate(0, 0));
+    octant.addVertex(ofxGeo::Coordinate(0, 90));
+    octant.addVertex(ofxGeo::Coordinate(90, 0));
+
+    const double radius = ofxGeo::GeoUtils::EARTH_RADIUS_KM;
+
+    check("Spherical octant area (km^2)",
+          PolygonMeasure::area(octant),
+          glm::pi<double>() * radius * radius / 2,
+          1e-6);
+
+    check("Spherical octant centroid latitude (degrees)",
+          PolygonMeasure::centroid(octant).getLatitude(),
+          glm::degrees(std::atan(1 / std::sqrt(2.0))),
+          1e-9);
+
+    // A quarter of the equator and two quarter meridians, 10018.754 km and
+    // 10001.966 km on WGS84.
+    check("WGS84 octant perimeter (km)",
+          PolygonMeasure::perimeter(octant, PolygonMeasure::ELLIPSOID),
+          10018.754171 + 2 * 10001.965729,
+          1e-5);
+
+    // Vincenty's reference line from Flinders Peak to Buninyong.
+    ofxGeo::Coordinate flindersPeak(-(37 + 57 / 60.0 + 3.72030 / 3600.0),
+                                    144 + 25 / 60.0 + 29.52440 / 3600.0);
+
+    ofxGeo::Coordinate buninyong(-(37 + 39 / 60.0 + 10.15610 / 3600.0),
+                                 143 + 55 / 60.0 + 35.38390 / 3600.0);
+
+    check("Flinders Peak to Buninyong (km)",
+          ofxGeo::GeoUtils::distanceVincenty(flindersPeak, buninyong),
+          54.972271,
+          1e-6);
+}
+
+
+void ofApp::draw()
+{
+    ofBackground(0);
+
+    std::stringstream ss;
+
+    for (const Result& result: results)
+    {
+        ss << (result.passed ? "PASS " : "FAIL ") << result.name << std::endl;
+        ss << "     " << std::setprecision(12) << result.value;
+        ss << " (expected " << result.expected << ")" << std::endl;
+    }
+
+    ofDrawBitmapString(ss.str(), ofVec2f(8, 14));
+}
+
+
+void ofApp::check(const std::string& name,
+                  double value,
+                  double expected,
+                  double tolerance)
+{
+    Result result;
+    result.name = name;
+    result.value = value;
+    result.expected = expected;
+    result.passed = std::abs(value - expected) <= tolerance;
+
+    if (!result.passed)
+    {
+        ofLogError("ofApp::check") << name << ": " << std::setprecision(12)
+                                   << value << " != " << expected;
+    }
+
+    assert(result.passed);
+
+    results.push_back(result);
+}
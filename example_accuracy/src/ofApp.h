@@ -0,0 +1,41 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include "ofMain.h"
+#include "ofxGeo.h"
+
+
+class ofApp: public ofBaseApp
+{
+public:
+    void setup() override;
+    void draw() override;
+
+    /// \brief Compare a measured value with a published reference.
+    /// \param name The name of the check.
+    /// \param value The measured value.
+    /// \param expected The reference value.
+    /// \param tolerance The largest accepted absolute difference.
+    void check(const std::string& name,
+               double value,
+               double expected,
+               double tolerance);
+
+    struct Result
+    {
+        std::string name;
+        double value = 0;
+        double expected = 0;
+        bool passed = false;
+    };
+
+    std::vector<Result> results;
+
+};
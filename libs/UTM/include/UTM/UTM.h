@@ -22,7 +22,6 @@
  */
 
 #include <cmath>
-#include <stdio.h>
 #include <stdlib.h>
 #include "ofMathConstants.h"
 
@@ -87,17 +86,48 @@ namespace UTM
     }
 
     /**
-     * Convert lat/long to UTM coords.  Equations from USGS Bulletin 1532
+     * Determine the UTM zone number for the given latitude and longitude,
+     * including the special zones for Norway and Svalbard.
+     *
+     * Lat and Long are in fractional degrees.
+     */
+    static inline int UTMZoneNumber(const double Lat, const double Long)
+    {
+        //Make sure the longitude is between -180.00 .. 179.9
+        double LongTemp = (Long+180)-int((Long+180)/360)*360-180;
+
+        int ZoneNumber = int((LongTemp + 180)/6) + 1;
+
+        if( Lat >= 56.0 && Lat < 64.0 && LongTemp >= 3.0 && LongTemp < 12.0 )
+            ZoneNumber = 32;
+
+        // Special zones for Svalbard
+        if( Lat >= 72.0 && Lat < 84.0 )
+        {
+            if(      LongTemp >= 0.0  && LongTemp <  9.0 ) ZoneNumber = 31;
+            else if( LongTemp >= 9.0  && LongTemp < 21.0 ) ZoneNumber = 33;
+            else if( LongTemp >= 21.0 && LongTemp < 33.0 ) ZoneNumber = 35;
+            else if( LongTemp >= 33.0 && LongTemp < 42.0 ) ZoneNumber = 37;
+        }
+
+        return ZoneNumber;
+    }
+
+    /**
+     * Convert lat/long to UTM coords in the given zone.  Equations from USGS
+     * Bulletin 1532
      *
      * East Longitudes are positive, West longitudes are negative.
      * North latitudes are positive, South latitudes are negative
      * Lat and Long are in fractional degrees
      *
+     * The conversion is reentrant and does not allocate.
+     *
      * Written by Chuck Gantz- chuck.gantz@globalstar.com
      */
     static inline void LLtoUTM(const double Lat, const double Long,
-                               double &UTMNorthing, double &UTMEasting,
-                               char* UTMZone)
+                               const int ZoneNumber,
+                               double &UTMNorthing, double &UTMEasting)
     {
         double a = WGS84_A;
         double eccSquared = UTM_E2;
@@ -113,27 +143,15 @@ namespace UTM
         double LatRad = Lat*DEG_TO_RAD;
         double LongRad = LongTemp*DEG_TO_RAD;
         double LongOriginRad;
-        int    ZoneNumber;
-
-        ZoneNumber = int((LongTemp + 180)/6) + 1;
-
-        if( Lat >= 56.0 && Lat < 64.0 && LongTemp >= 3.0 && LongTemp < 12.0 )
-            ZoneNumber = 32;
 
-        // Special zones for Svalbard
-        if( Lat >= 72.0 && Lat < 84.0 )
-        {
-            if(      LongTemp >= 0.0  && LongTemp <  9.0 ) ZoneNumber = 31;
-            else if( LongTemp >= 9.0  && LongTemp < 21.0 ) ZoneNumber = 33;
-            else if( LongTemp >= 21.0 && LongTemp < 33.0 ) ZoneNumber = 35;
-            else if( LongTemp >= 33.0 && LongTemp < 42.0 ) ZoneNumber = 37;
-        }
         // +3 puts origin in middle of zone
         LongOrigin = (ZoneNumber - 1)*6 - 180 + 3;
         LongOriginRad = LongOrigin * DEG_TO_RAD;
 
-        //compute the UTM Zone from the latitude and longitude
-        sprintf(UTMZone, "%d%c", ZoneNumber, UTMLetterDesignator(Lat));
+        // Keep the longitude continuous with the zone origin across the
+        // antimeridian.
+        if (LongRad - LongOriginRad > PI) LongRad -= TWO_PI;
+        else if (LongRad - LongOriginRad < -PI) LongRad += TWO_PI;
 
         eccPrimeSquared = (eccSquared)/(1-eccSquared);
 
@@ -167,6 +185,53 @@ namespace UTM
         }
     }
 
+    /**
+     * Convert lat/long to UTM coords.  Equations from USGS Bulletin 1532
+     *
+     * East Longitudes are positive, West longitudes are negative.
+     * North latitudes are positive, South latitudes are negative
+     * Lat and Long are in fractional degrees
+     *
+     * The conversion is reentrant and does not allocate.
+     *
+     * Written by Chuck Gantz- chuck.gantz@globalstar.com
+     */
+    static inline void LLtoUTM(const double Lat, const double Long,
+                               double &UTMNorthing, double &UTMEasting,
+                               int& ZoneNumber, char& ZoneLetter)
+    {
+        ZoneNumber = UTMZoneNumber(Lat, Long);
+        ZoneLetter = UTMLetterDesignator(Lat);
+        LLtoUTM(Lat, Long, ZoneNumber, UTMNorthing, UTMEasting);
+    }
+
+    /**
+     * Convert lat/long to UTM coords.  Equations from USGS Bulletin 1532
+     *
+     * East Longitudes are positive, West longitudes are negative.
+     * North latitudes are positive, South latitudes are negative
+     * Lat and Long are in fractional degrees
+     *
+     * UTMZone must point to a buffer of at least 4 characters.
+     *
+     * Written by Chuck Gantz- chuck.gantz@globalstar.com
+     */
+    static inline void LLtoUTM(const double Lat, const double Long,
+                               double &UTMNorthing, double &UTMEasting,
+                               char* UTMZone)
+    {
+        int ZoneNumber;
+        char ZoneLetter;
+
+        LLtoUTM(Lat, Long, UTMNorthing, UTMEasting, ZoneNumber, ZoneLetter);
+
+        //compute the UTM Zone from the latitude and longitude
+        if (ZoneNumber >= 10) *UTMZone++ = char('0' + ZoneNumber / 10);
+        *UTMZone++ = char('0' + ZoneNumber % 10);
+        *UTMZone++ = ZoneLetter;
+        *UTMZone = '\0';
+    }
+
     /**
      * Converts UTM coords to lat/long.  Equations from USGS Bulletin 1532
      *
@@ -174,10 +239,13 @@ namespace UTM
      * North latitudes are positive, South latitudes are negative
      * Lat and Long are in fractional degrees.
      *
+     * The conversion is reentrant and does not allocate.
+     *
      * Written by Chuck Gantz- chuck.gantz@globalstar.com
      */
     static inline void UTMtoLL(const double UTMNorthing, const double UTMEasting,
-                               const char* UTMZone, double& Lat,  double& Long )
+                               const int ZoneNumber, const bool NorthernHemisphere,
+                               double& Lat,  double& Long )
     {
         double k0 = UTM_K0;
         double a = WGS84_A;
@@ -188,14 +256,11 @@ namespace UTM
         double LongOrigin;
         double mu, phi1Rad;
         double x, y;
-        int ZoneNumber;
-        char* ZoneLetter;
 
         x = UTMEasting - 500000.0; //remove 500,000 meter offset for longitude
         y = UTMNorthing;
 
-        ZoneNumber = strtoul(UTMZone, &ZoneLetter, 10);
-        if((*ZoneLetter - 'N') < 0)
+        if(!NorthernHemisphere)
         {
             //remove 10,000,000 meter offset used for southern hemisphere
             y -= 10000000.0;
@@ -234,6 +299,23 @@ namespace UTM
         Long = LongOrigin + Long * RAD_TO_DEG;
         
     }
+
+    /**
+     * Converts UTM coords to lat/long.  Equations from USGS Bulletin 1532
+     *
+     * East Longitudes are positive, West longitudes are negative.
+     * North latitudes are positive, South latitudes are negative
+     * Lat and Long are in fractional degrees.
+     *
+     * Written by Chuck Gantz- chuck.gantz@globalstar.com
+     */
+    static inline void UTMtoLL(const double UTMNorthing, const double UTMEasting,
+                               const char* UTMZone, double& Lat,  double& Long )
+    {
+        char* ZoneLetter;
+        int ZoneNumber = strtoul(UTMZone, &ZoneLetter, 10);
+        UTMtoLL(UTMNorthing, UTMEasting, ZoneNumber, (*ZoneLetter - 'N') >= 0, Lat, Long);
+    }
 } // end namespace UTM
 
 #endif // _UTM_H
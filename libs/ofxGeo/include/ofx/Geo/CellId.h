@@ -0,0 +1,240 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ofx/Geo/Coordinate.h"
+#include "ofx/Geo/CoordinateBounds.h"
+#include "ofx/Geo/NVector.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+/// \brief A hierarchical 64-bit spatial cell identifier.
+///
+/// The sphere is projected onto the six faces of a cube and each face is
+/// recursively divided into four children, down to MAX_LEVEL. Cells are
+/// numbered along a Hilbert curve, so the id's top three bits are the face,
+/// followed by two bits per level and a trailing 1 bit that marks the level.
+///
+/// All descendants of a cell lie in the contiguous id range
+/// [getRangeMin(), getRangeMax()], which makes sorted arrays of leaf cell
+/// ids searchable by range scans.
+///
+/// The layout is compatible with the S2 geometry library's cell ids.
+///
+/// \sa CellIndex
+class CellId
+{
+public:
+    /// \brief Create an invalid CellId.
+    CellId();
+
+    /// \brief Create a CellId from its 64-bit representation.
+    /// \param id The 64-bit cell id.
+    explicit CellId(uint64_t id);
+
+    /// \brief Create the CellId containing a Coordinate.
+    /// \param coordinate The location.
+    /// \param level The level of the cell in [0, MAX_LEVEL].
+    CellId(const Coordinate& coordinate, int level = MAX_LEVEL);
+
+    /// \brief Create the CellId containing an NVector.
+    /// \param vector The location.
+    /// \param level The level of the cell in [0, MAX_LEVEL].
+    CellId(const NVector& vector, int level = MAX_LEVEL);
+
+    /// \brief Destroy the CellId.
+    virtual ~CellId();
+
+    /// \returns the 64-bit representation of the cell.
+    uint64_t getId() const;
+
+    /// \returns true if the id refers to a cell.
+    bool isValid() const;
+
+    /// \returns the cube face in [0, 5].
+    int getFace() const;
+
+    /// \returns the level in [0, MAX_LEVEL], 0 being a whole face.
+    int getLevel() const;
+
+    /// \returns true if the cell is at MAX_LEVEL.
+    bool isLeaf() const;
+
+    /// \returns true if the cell is a whole face.
+    bool isFace() const;
+
+    /// \returns the cell's position among its parent's children in [0, 3].
+    int getChildPosition() const;
+
+    /// \returns the cell one level up, or this cell if it is a face.
+    CellId getParent() const;
+
+    /// \brief Get an ancestor of the cell.
+    /// \param level The level of the ancestor, not greater than getLevel().
+    /// \returns the ancestor at the given level.
+    CellId getParent(int level) const;
+
+    /// \brief Get a child of the cell.
+    /// \param position The child position along the Hilbert curve in [0, 3].
+    /// \returns the child, or an invalid CellId for a leaf.
+    CellId getChild(int position) const;
+
+    /// \brief Get the four children of the cell in Hilbert curve order.
+    /// \param children The output array of four children.
+    /// \returns false if the cell is a leaf.
+    bool getChildren(CellId children[4]) const;
+
+    /// \brief Get the four cells that share an edge with this cell.
+    ///
+    /// Neighbors are at the same level and are returned in the order
+    /// bottom, right, top, left in the face's (i, j) frame. Neighbors across
+    /// cube face edges are handled.
+    ///
+    /// \param neighbors The output array of four neighbors.
+    void getEdgeNeighbors(CellId neighbors[4]) const;
+
+    /// \returns the first leaf cell contained by this cell.
+    CellId getRangeMin() const;
+
+    /// \returns the last leaf cell contained by this cell.
+    CellId getRangeMax() const;
+
+    /// \brief Determine if a cell is this cell or one of its descendants.
+    /// \param cell The cell to test.
+    /// \returns true if the cell is contained.
+    bool contains(const CellId& cell) const;
+
+    /// \brief Determine if this cell and another share any leaf cell.
+    /// \param cell The cell to test.
+    /// \returns true if one cell contains the other.
+    bool intersects(const CellId& cell) const;
+
+    /// \returns the center of the cell.
+    Coordinate getCenter() const;
+
+    /// \brief Get the corners of the cell.
+    /// \param vertices The output array of four corners in counter-clockwise order.
+    void getVertices(Coordinate vertices[4]) const;
+
+    /// \brief Get a latitude / longitude box containing the cell.
+    ///
+    /// Cell edges are great-circle arcs, so the latitude range includes
+    /// the arcs' extrema as well as the corners. Cells containing a pole
+    /// span all longitudes.
+    ///
+    /// \returns the bounding box.
+    CoordinateBounds getBounds() const;
+
+    /// \brief Get the cell's id as a compact hexadecimal token.
+    /// \returns the token with trailing zeros removed.
+    std::string toToken() const;
+
+    /// \brief Create a CellId from a token.
+    /// \param token The token created by toToken().
+    /// \returns the cell, or an invalid CellId if the token is malformed.
+    static CellId fromToken(const std::string& token);
+
+    /// \brief Create the CellId for a whole cube face.
+    /// \param face The face in [0, 5].
+    /// \returns the face cell.
+    static CellId fromFace(int face);
+
+    /// \brief Create the CellId containing face-relative leaf coordinates.
+    /// \param face The face in [0, 5].
+    /// \param i The leaf column in [0, MAX_SIZE).
+    /// \param j The leaf row in [0, MAX_SIZE).
+    /// \returns the leaf cell.
+    static CellId fromFaceIJ(int face, int i, int j);
+
+    /// \brief Cover a region with at most maxCells cells.
+    ///
+    /// The cells are disjoint, sorted by id and together contain the whole
+    /// region. Cells that lie completely inside the region are kept as
+    /// large as possible; cells on its edges are subdivided while the
+    /// budget allows.
+    ///
+    /// \param bounds The region to cover.
+    /// \param maxCells The maximum number of cells, at least 4 is recommended.
+    /// \param maxLevel The deepest level to subdivide to.
+    /// \returns the covering.
+    static std::vector<CellId> cover(const CoordinateBounds& bounds,
+                                     std::size_t maxCells = DEFAULT_MAX_CELLS,
+                                     int maxLevel = MAX_LEVEL);
+
+    /// \brief Stream output.
+    /// \param os the std::ostream.
+    /// \param cell The CellId to output.
+    /// \returns the updated std::ostream reference.
+    friend std::ostream& operator << (std::ostream& os, const CellId& cell);
+
+    /// \brief Compare ids for equality.
+    /// \param cell The cell to compare.
+    /// \returns true if the ids are equal.
+    bool operator == (const CellId& cell) const;
+
+    /// \brief Compare ids for inequality.
+    /// \param cell The cell to compare.
+    /// \returns true if the ids differ.
+    bool operator != (const CellId& cell) const;
+
+    /// \brief Order cells by id, which is Hilbert curve order within a face.
+    /// \param cell The cell to compare.
+    /// \returns true if this id is less than the other.
+    bool operator < (const CellId& cell) const;
+
+    /// \brief The number of cube faces.
+    static const int NUM_FACES;
+
+    /// \brief The deepest level; leaf cells are about 1 cm across.
+    static const int MAX_LEVEL;
+
+    /// \brief The number of leaf cells along a face edge.
+    static const int MAX_SIZE;
+
+    /// \brief The default cell budget for cover().
+    static const std::size_t DEFAULT_MAX_CELLS;
+
+private:
+    /// \returns the lowest set bit, which marks the level.
+    uint64_t _lsb() const;
+
+    /// \brief Get the face and leaf coordinates of the cell's first leaf.
+    /// \param i The output leaf column.
+    /// \param j The output leaf row.
+    /// \returns the face.
+    int _toFaceIJ(int& i, int& j) const;
+
+    /// \brief Get the unit vector at face-relative leaf coordinates.
+    /// \param face The face.
+    /// \param i The leaf column, which may be fractional or outside the face.
+    /// \param j The leaf row, which may be fractional or outside the face.
+    /// \returns the unit vector.
+    static NVector _faceIJToVector(int face, double i, double j);
+
+    /// \brief The 64-bit representation.
+    uint64_t _id = 0;
+
+};
+
+
+inline std::ostream& operator << (std::ostream& os, const CellId& cell)
+{
+    os << cell.getFace() << "/" << cell.getLevel() << "/" << cell.toToken();
+    return os;
+}
+
+
+} } // namespace ofx::Geo
@@ -0,0 +1,141 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include <cstdint>
+#include <vector>
+#include "ofx/Geo/CellId.h"
+#include "ofx/Geo/Coordinate.h"
+#include "ofx/Geo/CoordinateBounds.h"
+#include "ofx/Geo/Executor.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+/// \brief A point index stored as a flat array sorted by leaf CellId.
+///
+/// Because every cell's descendants form a contiguous id range, a region
+/// query covers the region with a few cells and binary searches each
+/// cell's range in the array. Points in the covering but outside the
+/// region are removed by an exact bounds test.
+///
+/// Points are added in bulk and the array is sorted once by build().
+class CellIndex
+{
+public:
+    /// \brief An indexed point.
+    struct Entry
+    {
+        /// \brief The leaf cell id of the point.
+        uint64_t cellId;
+
+        /// \brief The latitude in degrees.
+        double latitude;
+
+        /// \brief The longitude in degrees.
+        double longitude;
+
+        /// \brief The caller's id for the point.
+        std::size_t id;
+    };
+
+    /// \brief Create an empty CellIndex.
+    CellIndex();
+
+    /// \brief Destroy the CellIndex.
+    virtual ~CellIndex();
+
+    /// \brief Add a point.
+    ///
+    /// The index must be rebuilt with build() before it is queried.
+    ///
+    /// \param coordinate The location of the point.
+    /// \param id The caller's id for the point.
+    void add(const Coordinate& coordinate, std::size_t id);
+
+    /// \brief Add points, computing their cell ids on an Executor.
+    ///
+    /// The index must be rebuilt with build() before it is queried.
+    ///
+    /// \param coordinates The array of size locations.
+    /// \param ids The array of size ids.
+    /// \param size The number of points.
+    /// \param executor The Executor used to compute the cell ids.
+    void add(const Coordinate* coordinates,
+             const std::size_t* ids,
+             std::size_t size,
+             const Executor& executor = Executor::serial());
+
+    /// \brief Sort the points by cell id.
+    void build();
+
+    /// \returns true if no points were added since the last build().
+    bool isBuilt() const;
+
+    /// \brief Find the points inside a region.
+    ///
+    /// An unbuilt index is searched linearly.
+    ///
+    /// \param bounds The region to search.
+    /// \param ids The vector the ids of the matching points are appended to.
+    /// \param maxCells The number of cells used to cover the region.
+    /// \returns the number of ids appended.
+    std::size_t query(const CoordinateBounds& bounds,
+                      std::vector<std::size_t>& ids,
+                      std::size_t maxCells = DEFAULT_MAX_CELLS) const;
+
+    /// \brief Find the points inside a cell.
+    ///
+    /// An unbuilt index is searched linearly.
+    ///
+    /// \param cell The cell to search.
+    /// \param ids The vector the ids of the matching points are appended to.
+    /// \returns the number of ids appended.
+    std::size_t query(const CellId& cell, std::vector<std::size_t>& ids) const;
+
+    /// \brief Remove all points.
+    void clear();
+
+    /// \brief Reserve storage for points.
+    /// \param size The number of points to reserve.
+    void reserve(std::size_t size);
+
+    /// \returns the number of points.
+    std::size_t size() const;
+
+    /// \returns true if there are no points.
+    bool empty() const;
+
+    /// \returns the points, sorted by cell id if the index is built.
+    const std::vector<Entry>& getEntries() const;
+
+    /// \brief The default cell budget for region queries.
+    static const std::size_t DEFAULT_MAX_CELLS;
+
+private:
+    /// \brief Get the entries whose cell ids lie in a cell's range.
+    /// \param cell The cell.
+    /// \param first The output first entry.
+    /// \param last The output end entry.
+    void _range(const CellId& cell,
+                std::vector<Entry>::const_iterator& first,
+                std::vector<Entry>::const_iterator& last) const;
+
+    /// \brief The points.
+    std::vector<Entry> _entries;
+
+    /// \brief True if _entries is sorted.
+    bool _built = true;
+
+};
+
+
+} } // namespace ofx::Geo
@@ -0,0 +1,176 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include <cstdint>
+#include <vector>
+#include "ofx/Geo/CellId.h"
+#include "ofx/Geo/Coordinate.h"
+#include "ofx/Geo/Executor.h"
+#include "ofx/Geo/WebMercator.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+/// \brief The number of points that fall in a grid cell.
+struct CellCount
+{
+    /// \brief The cell.
+    CellId cell;
+
+    /// \brief The number of points in the cell.
+    std::size_t count;
+
+    /// \brief The mean location of the points in the cell.
+    Coordinate center;
+};
+
+
+/// \brief The number of points that fall in a map tile.
+struct TileCount
+{
+    /// \brief The tile.
+    Tile tile;
+
+    /// \brief The number of points in the tile.
+    std::size_t count;
+
+    /// \brief The mean location of the points in the tile.
+    Coordinate center;
+};
+
+
+/// \brief Density clustering and grid aggregation of points.
+///
+/// All operations run on an Executor and give the same result regardless of
+/// the number of threads.
+class Clustering
+{
+public:
+    /// \brief Cluster points with DBSCAN.
+    ///
+    /// Points with at least minPoints points (including themselves) within
+    /// epsilon are core points. Core points within epsilon of each other
+    /// share a cluster, and other points within epsilon of a core point join
+    /// the cluster of the nearest one. Neighborhoods are found with a
+    /// SpatialHash whose cells are about epsilon across, using haversine
+    /// distances.
+    ///
+    /// Clusters are numbered in order of their lowest point index.
+    ///
+    /// \param coordinates The array of size points.
+    /// \param size The number of points.
+    /// \param epsilon The neighborhood radius in kilometers.
+    /// \param minPoints The minimum neighborhood size of a core point.
+    /// \param labels The output array of size cluster labels, NOISE for
+    ///     points in no cluster.
+    /// \param executor The Executor used to run the neighborhood queries.
+    /// \returns the number of clusters.
+    static std::size_t dbscan(const Coordinate* coordinates,
+                              std::size_t size,
+                              double epsilon,
+                              std::size_t minPoints,
+                              std::size_t* labels,
+                              const Executor& executor = Executor::serial());
+
+    /// \brief Cluster points with DBSCAN.
+    /// \param coordinates The points.
+    /// \param epsilon The neighborhood radius in kilometers.
+    /// \param minPoints The minimum neighborhood size of a core point.
+    /// \param labels Set to the cluster label of each point, NOISE for points
+    ///     in no cluster.
+    /// \param executor The Executor used to run the neighborhood queries.
+    /// \returns the number of clusters.
+    static std::size_t dbscan(const std::vector<Coordinate>& coordinates,
+                              double epsilon,
+                              std::size_t minPoints,
+                              std::vector<std::size_t>& labels,
+                              const Executor& executor = Executor::serial());
+
+    /// \brief Count the points in each CellId at a level.
+    /// \param coordinates The array of size points.
+    /// \param size The number of points.
+    /// \param level The cell level in [0, CellId::MAX_LEVEL].
+    /// \param counts Set to the occupied cells, in CellId order.
+    /// \param executor The Executor used to run the aggregation.
+    static void aggregate(const Coordinate* coordinates,
+                          std::size_t size,
+                          int level,
+                          std::vector<CellCount>& counts,
+                          const Executor& executor = Executor::serial());
+
+    /// \brief Count the points in each CellId at a level.
+    /// \param coordinates The points.
+    /// \param level The cell level in [0, CellId::MAX_LEVEL].
+    /// \param counts Set to the occupied cells, in CellId order.
+    /// \param executor The Executor used to run the aggregation.
+    static void aggregate(const std::vector<Coordinate>& coordinates,
+                          int level,
+                          std::vector<CellCount>& counts,
+                          const Executor& executor = Executor::serial());
+
+    /// \brief Count the points in each map tile at a zoom level.
+    /// \param coordinates The array of size points.
+    /// \param size The number of points.
+    /// \param zoom The zoom level in [0, WebMercator::MAX_ZOOM].
+    /// \param counts Set to the occupied tiles, row by row.
+    /// \param executor The Executor used to run the aggregation.
+    static void aggregate(const Coordinate* coordinates,
+                          std::size_t size,
+                          int zoom,
+                          std::vector<TileCount>& counts,
+                          const Executor& executor = Executor::serial());
+
+    /// \brief Count the points in each map tile at a zoom level.
+    /// \param coordinates The points.
+    /// \param zoom The zoom level in [0, WebMercator::MAX_ZOOM].
+    /// \param counts Set to the occupied tiles, row by row.
+    /// \param executor The Executor used to run the aggregation.
+    static void aggregate(const std::vector<Coordinate>& coordinates,
+                          int zoom,
+                          std::vector<TileCount>& counts,
+                          const Executor& executor = Executor::serial());
+
+    /// \brief The label of points that belong to no cluster.
+    static const std::size_t NOISE;
+
+private:
+    Clustering() = delete;
+    ~Clustering() = delete;
+
+    /// \brief The points of a grid cell with a key.
+    struct _Bin
+    {
+        uint64_t key;
+        std::size_t count;
+        glm::dvec3 sum;
+    };
+
+    /// \brief Count points per key.
+    /// \param coordinates The array of size points.
+    /// \param size The number of points.
+    /// \param key The function giving the key of a point.
+    /// \param bins Set to the occupied bins in key order.
+    /// \param executor The Executor used to run the aggregation.
+    template <typename Key>
+    static void _aggregate(const Coordinate* coordinates,
+                           std::size_t size,
+                           const Key& key,
+                           std::vector<_Bin>& bins,
+                           const Executor& executor);
+
+    /// \returns the mean location of a bin.
+    static Coordinate _center(const _Bin& bin);
+
+};
+
+
+} } // namespace ofx::Geo
@@ -0,0 +1,66 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include <cstddef>
+
+
+namespace ofx {
+namespace Geo {
+
+
+/// \brief A running sum with Neumaier's compensated summation.
+///
+/// The rounding error of each addition is carried in a second term, so the
+/// error of the sum stays near one rounding regardless of the number of
+/// values or their order of magnitude.
+///
+/// \sa https://en.wikipedia.org/wiki/Kahan_summation_algorithm
+class CompensatedSum
+{
+public:
+    /// \brief Create a CompensatedSum.
+    /// \param value The initial value.
+    CompensatedSum(double value = 0);
+
+    /// \brief Destroy the CompensatedSum.
+    virtual ~CompensatedSum();
+
+    /// \brief Add a value.
+    /// \param value The value to add.
+    void add(double value);
+
+    /// \brief Add a value.
+    /// \param value The value to add.
+    /// \returns this sum.
+    CompensatedSum& operator += (double value);
+
+    /// \brief Reset the sum to zero.
+    void clear();
+
+    /// \returns the compensated sum.
+    double getSum() const;
+
+    /// \brief Sum an array of values.
+    /// \param values The array of size values.
+    /// \param size The number of values.
+    /// \returns the compensated sum.
+    static double sum(const double* values, std::size_t size);
+
+private:
+    /// \brief The uncompensated sum.
+    double _sum = 0;
+
+    /// \brief The accumulated rounding error.
+    double _compensation = 0;
+
+};
+
+
+} } // namespace ofx::Geo
@@ -0,0 +1,138 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include <vector>
+#include "ofVectorMath.h"
+#include "ofx/Geo/Coordinate.h"
+#include "ofx/Geo/Executor.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+/// \brief The smallest circle that contains a set of points.
+struct BoundingCircle
+{
+    /// \brief The center of the circle.
+    Coordinate center;
+
+    /// \brief The great-circle (haversine) radius in kilometers.
+    double radius;
+};
+
+
+/// \brief The smallest rectangle, at any orientation, that contains a set of
+///     points. Its sides are great circle arcs.
+struct BoundingRectangle
+{
+    /// \brief The corners in counterclockwise order.
+    Coordinate corners[4];
+
+    /// \brief The center of the rectangle.
+    Coordinate center;
+
+    /// \brief The great-circle length in kilometers between the midpoints of
+    ///     the sides across the bearing.
+    double length;
+
+    /// \brief The great-circle length in kilometers between the midpoints of
+    ///     the sides along the bearing.
+    double width;
+
+    /// \brief The direction of the length sides in degrees clockwise from
+    ///     north, in [0, 180).
+    double bearing;
+};
+
+
+/// \brief Convex hulls and minimum bounding shapes of point sets.
+///
+/// Points are projected with a gnomonic projection centered on their bounds,
+/// which maps great circles to straight lines, so the hull is the exact hull
+/// on the sphere at any scale. Every point must be less than 90 degrees
+/// from the center of the bounds, so sets should fit well inside a
+/// hemisphere.
+///
+/// The hull is found with Andrew's monotone chain. Each Executor block drops
+/// the points inside the polygon of its extreme points in eight directions
+/// and takes the hull of the rest. The block hulls are merged with one more
+/// pass, so large sets are hulled in parallel without copying them. The
+/// bounding circle and rectangle only depend on the hull and are found from
+/// it. The circle is the smallest spherical cap, and its radius is the
+/// haversine distance to the farthest point. The rectangle is the smallest
+/// in the projection, and its sides are measured on the sphere.
+class ConvexHull
+{
+public:
+    /// \brief Get the convex hull of points.
+    /// \param coordinates The array of size points.
+    /// \param size The number of points.
+    /// \param hull Set to the hull vertices in counterclockwise order,
+    ///     without collinear vertices.
+    /// \param executor The Executor used to run the hull.
+    static void hull(const Coordinate* coordinates,
+                     std::size_t size,
+                     std::vector<Coordinate>& hull,
+                     const Executor& executor = Executor::serial());
+
+    /// \brief Get the convex hull of points.
+    /// \param coordinates The points.
+    /// \param hull Set to the hull vertices in counterclockwise order,
+    ///     without collinear vertices.
+    /// \param executor The Executor used to run the hull.
+    static void hull(const std::vector<Coordinate>& coordinates,
+                     std::vector<Coordinate>& hull,
+                     const Executor& executor = Executor::serial());
+
+    /// \brief Get the smallest circle containing points, with Welzl's
+    ///     algorithm on the hull's unit vectors.
+    /// \param coordinates The array of size points.
+    /// \param size The number of points.
+    /// \param executor The Executor used to run the hull.
+    /// \returns the circle, with a radius of 0 if there are no points.
+    static BoundingCircle boundingCircle(const Coordinate* coordinates,
+                                         std::size_t size,
+                                         const Executor& executor = Executor::serial());
+
+    /// \brief Get the smallest circle containing points.
+    /// \param coordinates The points.
+    /// \param executor The Executor used to run the hull.
+    /// \returns the circle, with a radius of 0 if there are no points.
+    static BoundingCircle boundingCircle(const std::vector<Coordinate>& coordinates,
+                                         const Executor& executor = Executor::serial());
+
+    /// \brief Get the smallest-area rectangle containing points, with
+    ///     rotating calipers on the hull.
+    /// \param coordinates The array of size points.
+    /// \param size The number of points.
+    /// \param executor The Executor used to run the hull.
+    /// \returns the rectangle, with a length and width of 0 if there are no
+    ///     points.
+    static BoundingRectangle boundingRectangle(const Coordinate* coordinates,
+                                               std::size_t size,
+                                               const Executor& executor = Executor::serial());
+
+    /// \brief Get the smallest-area rectangle containing points.
+    /// \param coordinates The points.
+    /// \param executor The Executor used to run the hull.
+    /// \returns the rectangle, with a length and width of 0 if there are no
+    ///     points.
+    static BoundingRectangle boundingRectangle(const std::vector<Coordinate>& coordinates,
+                                               const Executor& executor = Executor::serial());
+
+private:
+    ConvexHull() = delete;
+    ~ConvexHull() = delete;
+
+};
+
+
+} } // namespace ofx::Geo
@@ -9,6 +9,7 @@
 
 
 #include <iostream>
+#include <vector>
 #include "ofx/Geo/Coordinate.h"
 
 
@@ -17,25 +18,109 @@ namespace Geo {
 
 
 /// \brief A bounding box using Geo Coordinates.
+///
+/// The box spans the longitudes eastward from its west edge to its east
+/// edge. When the west edge is greater than the east edge, the box crosses
+/// the antimeridian. Growing the box always extends it by the smaller of
+/// the eastward and westward arcs, so a track crossing 180 degrees yields
+/// a narrow box rather than one spanning the whole globe.
+///
+/// A box reaching latitude 90 or -90 contains that pole, which has every
+/// longitude.
 class CoordinateBounds
 {
 public:
-    /// \brief Create a MAXIMUM_BOUNDS CooridinateBounds.
+    /// \brief Create an empty CoordinateBounds.
     CoordinateBounds();
 
-    /// \brief Create CoordinateBounds from two Coordinates.
+    /// \brief Create CoordinateBounds from two corner Coordinates.
+    ///
+    /// The box spans from the smaller to the larger longitude and never
+    /// crosses the antimeridian.
+    ///
     /// \param coordinate0 The first coordinate.
     /// \param coordinate1 The second coordinate.
     CoordinateBounds(const Coordinate& coordinate0,
                      const Coordinate& coordinate1);
 
+    /// \brief Create CoordinateBounds from its edges.
+    ///
+    /// A west edge greater than the east edge creates a box crossing the
+    /// antimeridian.
+    ///
+    /// \param south The southern latitude in degrees.
+    /// \param west The western longitude in degrees.
+    /// \param north The northern latitude in degrees.
+    /// \param east The eastern longitude in degrees.
+    CoordinateBounds(double south, double west, double north, double east);
+
     /// \brief Destroy the CooridinateBounds.
     virtual ~CoordinateBounds();
 
     /// \brief Expand the coordinate bounds to incorporate the given coordinate.
+    ///
+    /// Longitude grows by the smaller arc. Coordinates at a pole only
+    /// extend the latitude.
+    ///
     /// \param coordinate The coordinate to use for expansion.
     void growToInclude(const Coordinate& coordinate);
 
+    /// \brief Expand the coordinate bounds to incorporate the given bounds.
+    ///
+    /// The result is the smaller of the two boxes that join the bounds
+    /// eastward or westward.
+    ///
+    /// \param bounds The bounds to use for expansion.
+    void growToInclude(const CoordinateBounds& bounds);
+
+    /// \brief Determine if the coordinate is inside of the bounds.
+    /// \param coordinate The coordinate to test.
+    /// \returns true if the coordinate is inside or on the edge of the bounds.
+    bool contains(const Coordinate& coordinate) const;
+
+    /// \brief Determine if the bounds are completely inside of these bounds.
+    /// \param bounds The bounds to test.
+    /// \returns true if the bounds are inside or on the edge of these bounds.
+    bool contains(const CoordinateBounds& bounds) const;
+
+    /// \brief Determine if the bounds overlap.
+    /// \param bounds The bounds to test.
+    /// \returns true if the bounds share any area or edge.
+    bool intersects(const CoordinateBounds& bounds) const;
+
+    /// \returns true if no coordinates have been added to the bounds.
+    bool isEmpty() const;
+
+    /// \returns true if the bounds cross the antimeridian.
+    bool crossesAntimeridian() const;
+
+    /// \brief Split the bounds at the antimeridian.
+    /// \param bounds The output array of at least two boxes, none of which
+    ///     cross the antimeridian.
+    /// \returns the number of boxes written; 0 if empty, else 1 or 2.
+    std::size_t split(CoordinateBounds bounds[2]) const;
+
+    /// \returns the southern latitude in degrees.
+    double getSouth() const;
+
+    /// \returns the western longitude in degrees.
+    double getWest() const;
+
+    /// \returns the northern latitude in degrees.
+    double getNorth() const;
+
+    /// \returns the eastern longitude in degrees.
+    double getEast() const;
+
+    /// \returns the eastward longitude span from west to east in [0, 360].
+    double getWidth() const;
+
+    /// \returns the latitude span in degrees.
+    double getHeight() const;
+
+    /// \returns the center of the bounds.
+    Coordinate getCenter() const;
+
     /// \brief Get the northwest corner of the CooridinateBounds.
     /// \returns the northwest corner of the CooridinateBounds.
     Coordinate northwest() const;
@@ -50,6 +135,18 @@ public:
     /// \returns the northeast corner of the CooridinateBounds.
     Coordinate northeast() const;
 
+    /// \brief Get the smallest bounds containing many bounds.
+    ///
+    /// Unlike repeated growToInclude(), the result does not depend on the
+    /// order of the bounds: the longitude span is the complement of the
+    /// largest gap between them.
+    ///
+    /// \param bounds The array of size bounds.
+    /// \param size The number of bounds.
+    /// \returns the merged bounds.
+    static CoordinateBounds merge(const CoordinateBounds* bounds,
+                                  std::size_t size);
+
     /// \brief The maximum coordinate bounds possible.
     static const CoordinateBounds MAXIMUM_BOUNDS;
 
@@ -69,10 +166,24 @@ public:
                                       const CoordinateBounds& bounds);
 
 private:
+    /// \brief Determine if a longitude is inside an eastward span.
+    /// \param west The western longitude of the span.
+    /// \param east The eastern longitude of the span.
+    /// \param longitude The longitude to test.
+    /// \returns true if the longitude is inside or on the edge of the span.
+    static bool _containsLongitude(double west, double east, double longitude);
+
+    /// \returns the eastward span from west to east in [0, 360].
+    static double _width(double west, double east);
+
     bool _unset = true;
     double _minLatitude = -90.0;
     double _maxLatitude =  90.00;
+
+    /// \brief The western edge; greater than _maxLongitude when wrapped.
     double _minLongitude = -180.00;
+
+    /// \brief The eastern edge.
     double _maxLongitude =  180.00;
 
 };
@@ -0,0 +1,158 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include <cstdint>
+#include <vector>
+#include "ofx/Geo/Coordinate.h"
+#include "ofx/Geo/UTMLocation.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+/// \brief A compact binary codec for arrays of locations.
+///
+/// This is a binary sibling of the encoded polyline format decoded by
+/// GeoUtils::decodeGeoPolyline(). Values are quantized to fixed-point with a
+/// configurable number of decimal digits, delta encoded, zigzag encoded and
+/// packed with group varint encoding.
+///
+/// Group varint stores four values behind one tag byte. Each two bit field
+/// of the tag selects a 1, 2, 4 or 8 byte little endian lane, so decoding a
+/// group needs no per-byte continuation tests.
+///
+/// Each component is stored as its own column, so slowly changing columns
+/// (elevation, UTM zone) compress to about one byte per value.
+///
+///     uint8   type (CoordinateCodec::Type)
+///     uint8   precision in decimal digits
+///     uint8   secondary precision (elevation digits), or 0
+///     varint  count
+///     columns
+class CoordinateCodec
+{
+public:
+    /// \brief The kind of data in an encoded buffer.
+    enum Type: std::uint8_t
+    {
+        /// \brief Latitude and longitude columns.
+        COORDINATE = 1,
+        /// \brief Latitude, longitude and elevation columns.
+        ELEVATED_COORDINATE = 2,
+        /// \brief Easting, northing, zone number, band and hemisphere columns.
+        UTM_POINT = 3
+    };
+
+    /// \brief Encode an array of Coordinates.
+    /// \param coordinates The array of size coordinates.
+    /// \param size The number of coordinates.
+    /// \param buffer The buffer that the encoded bytes are appended to.
+    /// \param precision The number of decimal digits of degrees to keep.
+    static void encode(const Coordinate* coordinates,
+                       std::size_t size,
+                       std::vector<std::uint8_t>& buffer,
+                       int precision = DEFAULT_PRECISION);
+
+    /// \brief Encode an array of ElevatedCoordinates.
+    /// \param coordinates The array of size coordinates.
+    /// \param size The number of coordinates.
+    /// \param buffer The buffer that the encoded bytes are appended to.
+    /// \param precision The number of decimal digits of degrees to keep.
+    /// \param elevationPrecision The number of decimal digits of meters to keep.
+    static void encode(const ElevatedCoordinate* coordinates,
+                       std::size_t size,
+                       std::vector<std::uint8_t>& buffer,
+                       int precision = DEFAULT_PRECISION,
+                       int elevationPrecision = DEFAULT_ELEVATION_PRECISION);
+
+    /// \brief Encode an array of UTMPoints.
+    /// \param points The array of size points.
+    /// \param size The number of points.
+    /// \param buffer The buffer that the encoded bytes are appended to.
+    /// \param precision The number of decimal digits of meters to keep.
+    static void encode(const UTMPoint* points,
+                       std::size_t size,
+                       std::vector<std::uint8_t>& buffer,
+                       int precision = DEFAULT_UTM_PRECISION);
+
+    /// \brief Decode an array of Coordinates.
+    /// \param data The encoded bytes.
+    /// \param byteSize The number of encoded bytes.
+    /// \param coordinates The decoded coordinates, replacing any contents.
+    /// \returns true if the data was a valid encoded COORDINATE buffer.
+    static bool decode(const std::uint8_t* data,
+                       std::size_t byteSize,
+                       std::vector<Coordinate>& coordinates);
+
+    /// \brief Decode an array of ElevatedCoordinates.
+    /// \param data The encoded bytes.
+    /// \param byteSize The number of encoded bytes.
+    /// \param coordinates The decoded coordinates, replacing any contents.
+    /// \returns true if the data was a valid encoded ELEVATED_COORDINATE buffer.
+    static bool decode(const std::uint8_t* data,
+                       std::size_t byteSize,
+                       std::vector<ElevatedCoordinate>& coordinates);
+
+    /// \brief Decode an array of UTMPoints.
+    /// \param data The encoded bytes.
+    /// \param byteSize The number of encoded bytes.
+    /// \param points The decoded points, replacing any contents.
+    /// \returns true if the data was a valid encoded UTM_POINT buffer.
+    static bool decode(const std::uint8_t* data,
+                       std::size_t byteSize,
+                       std::vector<UTMPoint>& points);
+
+    /// \brief Encode a single column of values.
+    ///
+    /// The column has no header; the decoder must know size and scale.
+    ///
+    /// \param values The array of size values.
+    /// \param size The number of values.
+    /// \param scale The fixed-point scale, e.g. 1e7.
+    /// \param buffer The buffer that the encoded bytes are appended to.
+    static void encodeColumn(const double* values,
+                             std::size_t size,
+                             double scale,
+                             std::vector<std::uint8_t>& buffer);
+
+    /// \brief Decode a single column of values.
+    /// \param data A pointer to the encoded bytes, advanced past the column.
+    /// \param end The end of the encoded bytes.
+    /// \param scale The fixed-point scale used to encode the column.
+    /// \param values The output array of size values.
+    /// \param size The number of values.
+    /// \returns true if the column was decoded without running past end.
+    static bool decodeColumn(const std::uint8_t*& data,
+                             const std::uint8_t* end,
+                             double scale,
+                             double* values,
+                             std::size_t size);
+
+    /// \brief The default precision of degrees, 7 digits (~1 cm).
+    static const int DEFAULT_PRECISION;
+
+    /// \brief The default precision of elevations, 2 digits (1 cm).
+    static const int DEFAULT_ELEVATION_PRECISION;
+
+    /// \brief The default precision of UTM eastings and northings, 2 digits (1 cm).
+    static const int DEFAULT_UTM_PRECISION;
+
+    /// \brief The maximum supported precision, 9 digits.
+    static const int MAX_PRECISION;
+
+private:
+    CoordinateCodec() = delete;
+    ~CoordinateCodec() = delete;
+
+};
+
+
+} } // namespace ofx::Geo
@@ -8,21 +8,82 @@
 #pragma once
 
 
+#include <vector>
 #include "ofx/Geo/Coordinate.h"
+#include "ofx/Geo/CoordinateBounds.h"
 
 
 namespace ofx {
 namespace Geo {
 
 
+/// \brief An ordered sequence of Coordinates joined by great-circle segments.
 class CoordinatePolyline
 {
 public:
+    typedef std::vector<Coordinate>::const_iterator const_iterator;
+
+    /// \brief Create an empty CoordinatePolyline.
     CoordinatePolyline();
+
+    /// \brief Create a CoordinatePolyline from Coordinates.
+    /// \param coordinates The vertices of the polyline.
+    CoordinatePolyline(const std::vector<Coordinate>& coordinates);
+
+    /// \brief Destroy the CoordinatePolyline.
     virtual ~CoordinatePolyline();
 
+    /// \brief Add a vertex to the end of the polyline.
+    /// \param coordinate The vertex to add.
+    void addVertex(const Coordinate& coordinate);
+
+    /// \brief Add vertices to the end of the polyline.
+    /// \param coordinates The vertices to add.
+    void addVertices(const std::vector<Coordinate>& coordinates);
+
+    /// \brief Remove all vertices.
+    void clear();
+
+    /// \brief Reserve storage for vertices.
+    /// \param size The number of vertices to reserve.
+    void reserve(std::size_t size);
+
+    /// \returns the number of vertices.
+    std::size_t size() const;
+
+    /// \returns true if there are no vertices.
+    bool empty() const;
+
+    /// \brief Get a vertex.
+    /// \param index The vertex index.
+    /// \returns the vertex.
+    const Coordinate& operator [] (std::size_t index) const;
+
+    /// \returns the vertices.
+    const std::vector<Coordinate>& getVertices() const;
+
+    /// \returns the vertices.
+    std::vector<Coordinate>& getVertices();
+
+    /// \returns the haversine length of the polyline in kilometers.
+    double getLength() const;
+
+    /// \returns the bounds of the vertices.
+    CoordinateBounds getBounds() const;
+
+    /// \brief Get a copy with great-circle points added along long segments.
+    /// \param maxSegmentLength The maximum distance between vertices in kilometers.
+    /// \returns the densified polyline.
+    CoordinatePolyline getDensified(double maxSegmentLength) const;
+
+    /// \returns an iterator to the first vertex.
+    const_iterator begin() const;
+
+    /// \returns an iterator past the last vertex.
+    const_iterator end() const;
 
 private:
+    /// \brief The vertices.
     std::vector<Coordinate> _coordinates;
 
 };
@@ -0,0 +1,151 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include <vector>
+#include "ofx/Geo/Coordinate.h"
+#include "ofx/Geo/CoordinatePolyline.h"
+#include "ofx/Geo/RollingStatistics.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+/// \brief The kinematics of the segment ending at a track point.
+struct TrackSegment
+{
+    /// \brief The haversine distance from the previous point in kilometers.
+    double distance;
+
+    /// \brief The time since the previous point in seconds.
+    double duration;
+
+    /// \brief The ground speed in meters per second.
+    double speed;
+
+    /// \brief The bearing from the previous point in degrees.
+    double heading;
+
+    /// \brief The rate of elevation change in meters per second.
+    double climbRate;
+
+    /// \brief The change in speed from the previous segment in meters per second squared.
+    double acceleration;
+
+};
+
+
+/// \brief A timestamped track of ElevatedCoordinates.
+///
+/// The track keeps its positions in a CoordinatePolyline, with elevations,
+/// times and TrackSegment kinematics stored alongside. Kinematics and rolling
+/// statistics are derived as each point is added, in O(1) per point, so the
+/// track never needs to be rescanned.
+class CoordinateTrack
+{
+public:
+    /// \brief Create an empty CoordinateTrack.
+    /// \param statisticsWindow The rolling statistics window in seconds.
+    CoordinateTrack(double statisticsWindow = RollingStatistics::DEFAULT_WINDOW);
+
+    /// \brief Destroy the CoordinateTrack.
+    virtual ~CoordinateTrack();
+
+    /// \brief Add a point to the end of the track.
+    ///
+    /// Points should be added in non-decreasing time order. A segment with a
+    /// non-positive duration keeps the previous segment's speed, climb rate
+    /// and acceleration.
+    ///
+    /// \param coordinate The position.
+    /// \param time The time in seconds.
+    void add(const ElevatedCoordinate& coordinate, double time);
+
+    /// \brief Remove all points and statistics.
+    void clear();
+
+    /// \brief Reserve storage for points.
+    /// \param size The number of points to reserve.
+    void reserve(std::size_t size);
+
+    /// \returns the number of points.
+    std::size_t size() const;
+
+    /// \returns true if there are no points.
+    bool empty() const;
+
+    /// \returns the positions of the track.
+    const CoordinatePolyline& getPolyline() const;
+
+    /// \brief Get a point's position and elevation.
+    /// \param index The point index.
+    /// \returns the ElevatedCoordinate.
+    ElevatedCoordinate getCoordinate(std::size_t index) const;
+
+    /// \brief Get a point's time.
+    /// \param index The point index.
+    /// \returns the time in seconds.
+    double getTime(std::size_t index) const;
+
+    /// \brief Get the segment ending at a point.
+    ///
+    /// The segment of the first point is all zeros.
+    ///
+    /// \param index The point index.
+    /// \returns the segment's kinematics.
+    const TrackSegment& getSegment(std::size_t index) const;
+
+    /// \returns the elevations in meters.
+    const std::vector<double>& getElevations() const;
+
+    /// \returns the times in seconds.
+    const std::vector<double>& getTimes() const;
+
+    /// \returns the segments, one per point.
+    const std::vector<TrackSegment>& getSegments() const;
+
+    /// \returns the total haversine distance in kilometers.
+    double getDistance() const;
+
+    /// \returns the time between the first and last point in seconds.
+    double getDuration() const;
+
+    /// \returns the rolling statistics of segment speeds in meters per second.
+    const RollingStatistics& getSpeedStatistics() const;
+
+    /// \returns the rolling statistics of segment climb rates in meters per second.
+    const RollingStatistics& getClimbRateStatistics() const;
+
+private:
+    /// \brief The positions.
+    CoordinatePolyline _polyline;
+
+    /// \brief The elevations in meters.
+    std::vector<double> _elevations;
+
+    /// \brief The times in seconds.
+    std::vector<double> _times;
+
+    /// \brief The segment ending at each point.
+    std::vector<TrackSegment> _segments;
+
+    /// \brief The total distance in kilometers.
+    double _distance = 0;
+
+    /// \brief The rolling speed statistics.
+    RollingStatistics _speedStatistics;
+
+    /// \brief The rolling climb rate statistics.
+    RollingStatistics _climbRateStatistics;
+
+};
+
+
+} } // namespace ofx::Geo
@@ -0,0 +1,187 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "ofVectorMath.h"
+#include "ofx/Geo/Coordinate.h"
+#include "ofx/Geo/CoordinatePolyline.h"
+#include "ofx/Geo/Executor.h"
+#include "ofx/Geo/UTMLocation.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+/// \brief The region within a fixed distance of a route.
+///
+/// The route is projected into the UTM zone of its center, so the corridor
+/// is built in meters with round joins and caps. UTM is conformal, so
+/// distances are accurate to about 0.1% across a zone and degrade slowly
+/// for routes that extend past it.
+///
+/// The corridor is prepared for membership tests. Route segments are binned
+/// in a sparse grid; cells that lie entirely within the distance of a
+/// segment are marked as inside, so most tests are one projection and one
+/// lookup, and the rest check the few segments that reach the cell.
+/// Membership is exact: a point is inside if it is within the distance of
+/// the route, wherever the route turns or crosses itself.
+///
+/// The outline is a single counterclockwise ring traced around the route.
+/// Outline vertices that fall inside the corridor, at sharp inner turns or
+/// where the route doubles back, are removed. This is exact only while the
+/// corridor does not close on itself. Where separate stretches of the route
+/// come within twice the distance of each other, the ring can cut across
+/// the corridor or the gap between them, and a corridor that encloses a
+/// hole, around a crossing or a nearly closed loop, has no single ring at
+/// all. isOutlineValid() reports the outlines that enclose holes.
+/// Membership is unaffected.
+class Corridor
+{
+public:
+    /// \brief Create an empty Corridor.
+    Corridor();
+
+    /// \brief Create a Corridor around a route.
+    /// \param route The route.
+    /// \param distance The distance from the route in meters.
+    /// \param quadrantSegments The number of outline segments per quarter
+    ///     circle in joins and caps.
+    Corridor(const CoordinatePolyline& route,
+             double distance,
+             int quadrantSegments = DEFAULT_QUADRANT_SEGMENTS);
+
+    /// \brief Destroy the Corridor.
+    virtual ~Corridor();
+
+    /// \brief Rebuild the Corridor around a route.
+    /// \param route The route.
+    /// \param distance The distance from the route in meters.
+    /// \param quadrantSegments The number of outline segments per quarter
+    ///     circle in joins and caps.
+    void setRoute(const CoordinatePolyline& route,
+                  double distance,
+                  int quadrantSegments = DEFAULT_QUADRANT_SEGMENTS);
+
+    /// \returns the route.
+    const CoordinatePolyline& getRoute() const;
+
+    /// \returns the distance from the route in meters.
+    double getDistance() const;
+
+    /// \returns the outline of the corridor, closed implicitly, or an empty
+    ///     polyline if the route is empty or the distance is not positive.
+    const CoordinatePolyline& getOutline() const;
+
+    /// \brief Determine if the outline can be used as an area.
+    ///
+    /// Whenever the corridor encloses a hole, the outline crosses itself or
+    /// cuts through the corridor to join the boundaries inside and outside
+    /// the hole. A valid outline can still cut across a gap between
+    /// stretches of the route whose corridors overlap.
+    ///
+    /// \returns false if the outline crosses itself or cuts through the
+    ///     corridor.
+    bool isOutlineValid() const;
+
+    /// \brief Determine if a location is in the corridor.
+    /// \param coordinate The location to test.
+    /// \returns true if the location is within the distance of the route.
+    bool contains(const Coordinate& coordinate) const;
+
+    /// \brief Determine if locations are in the corridor.
+    /// \param coordinates The array of size locations.
+    /// \param size The number of locations.
+    /// \param results The output array of size results.
+    /// \param executor The Executor used to run the tests.
+    void contains(const Coordinate* coordinates,
+                  std::size_t size,
+                  bool* results,
+                  const Executor& executor = Executor::serial()) const;
+
+    /// \brief The default number of outline segments per quarter circle.
+    static const int DEFAULT_QUADRANT_SEGMENTS;
+
+private:
+    /// \brief A grid cell's range of route segments.
+    struct Cell
+    {
+        /// \brief The index of the cell's first entry in _cellSegments.
+        uint32_t begin;
+
+        /// \brief The index past the cell's last entry in _cellSegments.
+        uint32_t end;
+
+        /// \brief True if the whole cell is within the distance of the route.
+        bool inside;
+    };
+
+    /// \returns the position of a location in the projected plane.
+    glm::dvec2 _project(const Coordinate& coordinate) const;
+
+    /// \returns the grid key of the cell holding a position.
+    uint64_t _key(const glm::dvec2& position) const;
+
+    /// \brief Bin the route segments into the grid.
+    void _buildGrid();
+
+    /// \brief Trace the outline, convert it to Coordinates and check that it
+    ///     neither crosses itself nor cuts through the corridor.
+    /// \param quadrantSegments The number of segments per quarter circle.
+    void _buildOutline(int quadrantSegments);
+
+    /// \brief Determine if a position is within a distance of the route.
+    /// \param position The position in the projected plane.
+    /// \param distance The distance in meters, at most the corridor distance.
+    /// \returns true if the position is within the distance.
+    bool _within(const glm::dvec2& position, double distance) const;
+
+    /// \brief The route.
+    CoordinatePolyline _route;
+
+    /// \brief The outline.
+    CoordinatePolyline _outline;
+
+    /// \brief True if the outline neither crosses itself nor cuts through
+    ///     the corridor.
+    bool _outlineValid = true;
+
+    /// \brief The distance from the route in meters.
+    double _distance = 0;
+
+    /// \brief The projected route with repeated vertices removed. A route
+    ///     of one vertex is stored twice, as one segment of zero length.
+    std::vector<glm::dvec2> _points;
+
+    /// \brief The route center, which sets the UTM zone and hemisphere of
+    ///     the projection.
+    UTMPoint _center;
+
+    /// \brief The projected position of the grid origin.
+    glm::dvec2 _gridOrigin;
+
+    /// \brief The projected position of the grid's far corner.
+    glm::dvec2 _gridMax;
+
+    /// \brief The size of a grid cell in meters.
+    double _cellSize = 1;
+
+    /// \brief The occupied grid cells by key.
+    std::unordered_map<uint64_t, Cell> _cells;
+
+    /// \brief The segment indices of each cell, stored cell by cell.
+    std::vector<uint32_t> _cellSegments;
+
+};
+
+
+} } // namespace ofx::Geo
@@ -0,0 +1,198 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include <vector>
+#include "ofx/Geo/Coordinate.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+/// \brief A point of an elevation profile.
+struct ProfileSample
+{
+    /// \brief The horizontal distance along the track in meters.
+    double distance;
+
+    /// \brief The elevation in meters.
+    double elevation;
+};
+
+
+/// \brief Distance, elevation gain and loss of a track, measured in one pass.
+///
+/// Vertices are added in track order and every statistic is updated in
+/// constant time with no allocation, apart from appending profile samples.
+/// Horizontal distances are haversine distances and lengths include the
+/// change in elevation.
+///
+/// Ascent and descent are filtered with hysteresis: a climb or a drop only
+/// counts once the elevation has moved by the threshold, and then counts in
+/// full from the last turning point. The first move counts from the lowest
+/// or highest elevation before it. Noise smaller than the threshold is
+/// ignored.
+///
+/// If an interval is set, the profile is resampled at every multiple of the
+/// interval along the horizontal distance, interpolating elevations
+/// linearly. The end of the track is only sampled if it falls on a multiple
+/// of the interval.
+///
+/// After clear() the ElevationProfile keeps its storage, so one instance can
+/// measure many tracks without allocating.
+class ElevationProfile
+{
+public:
+    /// \brief Create an ElevationProfile.
+    /// \param threshold The ascent and descent hysteresis in meters.
+    /// \param interval The profile sample interval in meters, or 0 to not
+    ///     sample a profile.
+    ElevationProfile(double threshold = DEFAULT_THRESHOLD,
+                     double interval = 0);
+
+    /// \brief Destroy the ElevationProfile.
+    virtual ~ElevationProfile();
+
+    /// \brief Add the next vertex of the track.
+    /// \param coordinate The vertex.
+    void add(const ElevatedCoordinate& coordinate);
+
+    /// \brief Add the next vertices of the track.
+    /// \param coordinates The array of size vertices.
+    /// \param size The number of vertices.
+    void add(const ElevatedCoordinate* coordinates, std::size_t size);
+
+    /// \brief Add the next vertices of the track.
+    /// \param coordinates The vertices.
+    void add(const std::vector<ElevatedCoordinate>& coordinates);
+
+    /// \brief Remove all vertices, keeping the threshold and interval.
+    void clear();
+
+    /// \brief Set the ascent and descent hysteresis. Call before adding
+    ///     vertices.
+    /// \param threshold The hysteresis in meters.
+    void setThreshold(double threshold);
+
+    /// \returns the ascent and descent hysteresis in meters.
+    double getThreshold() const;
+
+    /// \brief Set the profile sample interval. Call before adding vertices.
+    /// \param interval The interval in meters, or 0 to not sample a profile.
+    void setInterval(double interval);
+
+    /// \returns the profile sample interval in meters.
+    double getInterval() const;
+
+    /// \returns the number of vertices added.
+    std::size_t getCount() const;
+
+    /// \returns the horizontal distance in meters.
+    double getDistance() const;
+
+    /// \returns the length in meters, including changes in elevation.
+    double getLength() const;
+
+    /// \returns the filtered elevation gain in meters, including a climb in
+    ///     progress once it exceeds the threshold.
+    double getAscent() const;
+
+    /// \returns the filtered elevation loss in meters, as a positive value,
+    ///     including a drop in progress once it exceeds the threshold.
+    double getDescent() const;
+
+    /// \returns the lowest elevation in meters, or 0 if empty.
+    double getMinimumElevation() const;
+
+    /// \returns the highest elevation in meters, or 0 if empty.
+    double getMaximumElevation() const;
+
+    /// \returns the length of the last segment in meters, including the
+    ///     change in elevation, or 0 if there is no segment.
+    double getSegmentLength() const;
+
+    /// \returns the grade of the last segment, the change in elevation over
+    ///     the horizontal distance, or 0 if there is no horizontal distance.
+    double getSegmentGrade() const;
+
+    /// \returns the profile samples.
+    const std::vector<ProfileSample>& getSamples() const;
+
+    /// \brief The default ascent and descent hysteresis, 5 meters.
+    static const double DEFAULT_THRESHOLD;
+
+private:
+    /// \brief The direction of the elevation trend.
+    enum Trend
+    {
+        /// \brief No move has exceeded the threshold yet.
+        LEVEL,
+        /// \brief Climbing since the last turning point.
+        CLIMBING,
+        /// \brief Dropping since the last turning point.
+        DROPPING
+    };
+
+    /// \brief Update the ascent and descent with a new elevation.
+    /// \param elevation The elevation in meters.
+    void _filter(double elevation);
+
+    /// \brief The ascent and descent hysteresis in meters.
+    double _threshold = DEFAULT_THRESHOLD;
+
+    /// \brief The profile sample interval in meters.
+    double _interval = 0;
+
+    /// \brief The previous vertex.
+    ElevatedCoordinate _previous;
+
+    /// \brief The number of vertices added.
+    std::size_t _count = 0;
+
+    /// \brief The horizontal distance in meters.
+    double _distance = 0;
+
+    /// \brief The length in meters.
+    double _length = 0;
+
+    /// \brief The confirmed elevation gain in meters.
+    double _ascent = 0;
+
+    /// \brief The confirmed elevation loss in meters.
+    double _descent = 0;
+
+    /// \brief The elevation of the last turning point.
+    double _anchor = 0;
+
+    /// \brief The extreme elevation of the current trend.
+    double _extreme = 0;
+
+    /// \brief The current trend.
+    Trend _trend = LEVEL;
+
+    /// \brief The lowest elevation in meters.
+    double _minimumElevation = 0;
+
+    /// \brief The highest elevation in meters.
+    double _maximumElevation = 0;
+
+    /// \brief The length of the last segment in meters.
+    double _segmentLength = 0;
+
+    /// \brief The grade of the last segment.
+    double _segmentGrade = 0;
+
+    /// \brief The profile samples.
+    std::vector<ProfileSample> _samples;
+
+};
+
+
+} } // namespace ofx::Geo
@@ -0,0 +1,119 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <functional>
+
+
+namespace ofx {
+namespace Geo {
+
+
+/// \brief An Executor runs a range of work items in fixed-size blocks.
+///
+/// The range [0, size) is always split into the same blocks of at most
+/// getBlockSize() items, independent of how many threads run them. Bulk
+/// operations write each item (or each block's partial result) to its own
+/// slot, so their output order is deterministic regardless of the executor.
+///
+/// To run bulk operations on an existing thread pool, subclass Executor and
+/// implement run() by submitting the blocks to the pool.
+class Executor
+{
+public:
+    /// \brief A function that processes the items in [begin, end).
+    typedef std::function<void(std::size_t begin, std::size_t end)> Task;
+
+    /// \brief Create an Executor with the given block size.
+    /// \param blockSize The maximum number of items per block.
+    Executor(std::size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+    /// \brief Destroy the Executor.
+    virtual ~Executor();
+
+    /// \brief Run the task over each block in [0, size).
+    ///
+    /// The call returns when all blocks have completed. If a task throws, the
+    /// first exception is rethrown to the caller.
+    ///
+    /// \param size The number of items to process.
+    /// \param task The task to run for each block.
+    virtual void run(std::size_t size, const Task& task) const = 0;
+
+    /// \returns the maximum number of items per block.
+    std::size_t getBlockSize() const;
+
+    /// \brief Get the number of blocks that will be used for a range.
+    /// \param size The number of items to process.
+    /// \returns the number of blocks.
+    std::size_t getNumBlocks(std::size_t size) const;
+
+    /// \brief The default block size.
+    ///
+    /// Sized so that a block of Coordinates and its results fit in L2 cache.
+    static const std::size_t DEFAULT_BLOCK_SIZE;
+
+    /// \returns a shared Executor that runs all blocks on the calling thread.
+    static const Executor& serial();
+
+protected:
+    /// \brief The maximum number of items per block.
+    std::size_t _blockSize = DEFAULT_BLOCK_SIZE;
+
+};
+
+
+/// \brief An Executor that runs all blocks on the calling thread.
+class SerialExecutor: public Executor
+{
+public:
+    /// \brief Create a SerialExecutor with the given block size.
+    /// \param blockSize The maximum number of items per block.
+    SerialExecutor(std::size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+    /// \brief Destroy the SerialExecutor.
+    virtual ~SerialExecutor();
+
+    void run(std::size_t size, const Task& task) const override;
+
+};
+
+
+/// \brief An Executor that runs blocks on a set of std::threads.
+///
+/// Threads are started for each call to run() and pull blocks from a shared
+/// counter, so uneven blocks are balanced across threads. The calling thread
+/// also processes blocks.
+class ThreadedExecutor: public Executor
+{
+public:
+    /// \brief Create a ThreadedExecutor.
+    /// \param numThreads The number of threads to use, or 0 to use
+    ///        std::thread::hardware_concurrency().
+    /// \param blockSize The maximum number of items per block.
+    ThreadedExecutor(std::size_t numThreads = 0,
+                     std::size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+    /// \brief Destroy the ThreadedExecutor.
+    virtual ~ThreadedExecutor();
+
+    void run(std::size_t size, const Task& task) const override;
+
+    /// \returns the number of threads used, including the calling thread.
+    std::size_t getNumThreads() const;
+
+private:
+    /// \brief The number of threads used, including the calling thread.
+    std::size_t _numThreads = 1;
+
+};
+
+
+} } // namespace ofx::Geo
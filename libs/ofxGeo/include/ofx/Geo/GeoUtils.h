@@ -11,6 +11,7 @@
 #include <string>
 #include <vector>
 #include "ofVectorMath.h"
+#include "ofx/Geo/Executor.h"
 
 
 namespace ofx {
@@ -18,7 +19,12 @@ namespace Geo {
 
 
 class Coordinate;
+class CoordinateBounds;
+class ElevatedCoordinate;
+class ECEFLocation;
+class NVector;
 class UTMLocation;
+struct UTMPoint;
 
 
 /// \brief A collection of utilities for geographic tasks.
@@ -52,6 +58,19 @@ public:
     static double distanceHaversine(const Coordinate& coordinate0,
                                     const Coordinate& coordinate1);
 
+    /// \brief Get the geodesic distance in kilometers on the WGS84 ellipsoid.
+    ///
+    /// Uses Vincenty's inverse formula. It converges to well below a
+    /// millimeter except for nearly antipodal points, where the spherical
+    /// distance scaled to the ellipsoid's mean radius is returned instead.
+    ///
+    /// \sa https://en.wikipedia.org/wiki/Vincenty%27s_formulae
+    /// \param coordinate0 The first location.
+    /// \param coordinate1 The second location.
+    /// \returns the ellipsoidal distance in kilometers.
+    static double distanceVincenty(const Coordinate& coordinate0,
+                                   const Coordinate& coordinate1);
+
     /// \brief Get the bearing in degrees between two Coordinates.
     /// \param coordinate0 The first location.
     /// \param coordinate1 The second location.
@@ -59,13 +78,64 @@ public:
     static double bearingHaversine(const Coordinate& coordinate0,
                                    const Coordinate& coordinate1);
 
-    /// \brief Get the bearing in degrees between two Coordinates.
+    /// \brief Get the great-circle midpoint between two Coordinates.
     /// \param coordinate0 The first location.
     /// \param coordinate1 The second location.
-    /// \returns the bearing in degrees between two GeoLocations.
+    /// \returns the midpoint with a longitude in [-180, 180).
+    /// \sa GreatCircleArc for other intermediate points.
     static Coordinate midpoint(const Coordinate& coordinate0,
                                const Coordinate& coordinate1);
 
+    /// \brief Get the destination given a start, bearing and distance.
+    /// \sa http://www.movable-type.co.uk/scripts/latlong.html
+    /// \param coordinate The start location.
+    /// \param bearing The initial bearing in degrees.
+    /// \param distance The great-circle distance in kilometers.
+    /// \returns the destination with a longitude in [-180, 180).
+    static Coordinate destination(const Coordinate& coordinate,
+                                  double bearing,
+                                  double distance);
+
+    /// \brief Get destinations given starts, bearings and distances.
+    /// \param coordinates The array of size start locations.
+    /// \param bearings The array of size initial bearings in degrees.
+    /// \param distances The array of size distances in kilometers.
+    /// \param size The number of destinations.
+    /// \param destinations The output array of size destinations.
+    /// \param executor The Executor used to run the calculation.
+    static void destination(const Coordinate* coordinates,
+                            const double* bearings,
+                            const double* distances,
+                            std::size_t size,
+                            Coordinate* destinations,
+                            const Executor& executor = Executor::serial());
+
+    /// \brief Get the distance from a point to the great circle through two points.
+    ///
+    /// To test many points against one path, use GreatCircleArc, which
+    /// precomputes the path's normal vector.
+    ///
+    /// \sa http://www.movable-type.co.uk/scripts/latlong.html
+    /// \param start The start of the path.
+    /// \param end The end of the path.
+    /// \param coordinate The point.
+    /// \returns the signed distance in kilometers, positive to the right of
+    ///     the direction of travel.
+    static double crossTrackDistance(const Coordinate& start,
+                                     const Coordinate& end,
+                                     const Coordinate& coordinate);
+
+    /// \brief Get the distance along the great circle through two points to
+    ///     the point closest to the given point.
+    /// \sa http://www.movable-type.co.uk/scripts/latlong.html
+    /// \param start The start of the path.
+    /// \param end The end of the path.
+    /// \param coordinate The point.
+    /// \returns the signed distance in kilometers, negative behind the start.
+    static double alongTrackDistance(const Coordinate& start,
+                                     const Coordinate& end,
+                                     const Coordinate& coordinate);
+
     /// \brief Convert the Coordinate to a UTMLocation using the WGS84 Datum.
     /// \param coordinate The location.
     /// \returns the converted UTMLocation.
@@ -76,12 +146,228 @@ public:
     /// \returns the converted Coordinate.
     static Coordinate toCoordinate(const UTMLocation& location);
 
+    /// \brief Convert the Coordinate to a UTMPoint using the WGS84 Datum.
+    ///
+    /// This conversion is reentrant and does not allocate, so it may be called
+    /// concurrently from many threads.
+    ///
+    /// \param coordinate The location.
+    /// \returns the converted UTMPoint.
+    static UTMPoint toUTMPoint(const Coordinate& coordinate);
+
+    /// \brief Convert the Coordinate to a UTMPoint in the given zone.
+    ///
+    /// This is used to extend a zone's projection to nearby locations so that
+    /// positions near zone boundaries can be compared in one metric space.
+    /// Accuracy decreases with distance from the zone's central meridian.
+    ///
+    /// \param coordinate The location.
+    /// \param zoneNumber The UTM zone number to project into.
+    /// \param hemisphere The hemisphere whose false northing should be used.
+    /// \returns the converted UTMPoint.
+    static UTMPoint toUTMPoint(const Coordinate& coordinate,
+                               int zoneNumber,
+                               char hemisphere);
+
+    /// \brief Convert the UTMLocation to a UTMPoint.
+    /// \param location The UTMLocation with a zone such as "33T".
+    /// \returns the converted UTMPoint.
+    static UTMPoint toUTMPoint(const UTMLocation& location);
+
+    /// \brief Convert the UTMPoint to a Coordinate using the WGS84 Datum.
+    ///
+    /// This conversion is reentrant and does not allocate, so it may be called
+    /// concurrently from many threads.
+    ///
+    /// \param point The UTMPoint.
+    /// \returns the converted Coordinate.
+    static Coordinate toCoordinate(const UTMPoint& point);
+
+    /// \brief Convert the UTMPoint to a UTMLocation.
+    /// \param point The UTMPoint.
+    /// \returns the converted UTMLocation with a zone such as "33T".
+    static UTMLocation toUTMLocation(const UTMPoint& point);
+
+    /// \brief Convert Coordinates to UTMPoints using the WGS84 Datum.
+    /// \param coordinates The input array of size elements.
+    /// \param size The number of elements to convert.
+    /// \param points The output array of size elements.
+    /// \param executor The Executor used to run the conversion.
+    static void toUTMPoint(const Coordinate* coordinates,
+                           std::size_t size,
+                           UTMPoint* points,
+                           const Executor& executor = Executor::serial());
+
+    /// \brief Convert UTMPoints to Coordinates using the WGS84 Datum.
+    /// \param points The input array of size elements.
+    /// \param size The number of elements to convert.
+    /// \param coordinates The output array of size elements.
+    /// \param executor The Executor used to run the conversion.
+    static void toCoordinate(const UTMPoint* points,
+                             std::size_t size,
+                             Coordinate* coordinates,
+                             const Executor& executor = Executor::serial());
+
+    /// \brief Get the haversine distances between pairs of Coordinates.
+    ///
+    /// distances[i] is the distance between coordinates0[i] and
+    /// coordinates1[i].
+    ///
+    /// \param coordinates0 The first array of size locations.
+    /// \param coordinates1 The second array of size locations.
+    /// \param size The number of pairs.
+    /// \param distances The output array of size distances in kilometers.
+    /// \param executor The Executor used to run the calculation.
+    static void distanceHaversine(const Coordinate* coordinates0,
+                                  const Coordinate* coordinates1,
+                                  std::size_t size,
+                                  double* distances,
+                                  const Executor& executor = Executor::serial());
+
+    /// \brief Get the bearings between pairs of Coordinates.
+    ///
+    /// bearings[i] is the bearing from coordinates0[i] to coordinates1[i].
+    ///
+    /// \param coordinates0 The first array of size locations.
+    /// \param coordinates1 The second array of size locations.
+    /// \param size The number of pairs.
+    /// \param bearings The output array of size bearings in degrees.
+    /// \param executor The Executor used to run the calculation.
+    static void bearingHaversine(const Coordinate* coordinates0,
+                                 const Coordinate* coordinates1,
+                                 std::size_t size,
+                                 double* bearings,
+                                 const Executor& executor = Executor::serial());
+
+    /// \brief Get the haversine distances from one Coordinate to many.
+    ///
+    /// The first location's trigonometry is computed once.
+    ///
+    /// \param coordinate0 The first location.
+    /// \param coordinates The array of size locations.
+    /// \param size The number of locations.
+    /// \param distances The output array of size distances in kilometers.
+    /// \param executor The Executor used to run the calculation.
+    static void distanceHaversine(const Coordinate& coordinate0,
+                                  const Coordinate* coordinates,
+                                  std::size_t size,
+                                  double* distances,
+                                  const Executor& executor = Executor::serial());
+
+    /// \brief Get latitude / longitude boxes containing a circle.
+    ///
+    /// Circles reaching a pole span all longitudes. Circles crossing the
+    /// antimeridian are split into an eastern and a western box, so
+    /// backends that only handle plain boxes can use the result directly.
+    ///
+    /// \param center The center of the circle.
+    /// \param radius The radius in kilometers.
+    /// \param bounds The output array of at least two boxes.
+    /// \returns the number of boxes written, 1 or 2.
+    static std::size_t radiusBounds(const Coordinate& center,
+                                    double radius,
+                                    CoordinateBounds bounds[2]);
+
+    /// \brief Get the CoordinateBounds of an array of Coordinates.
+    /// \param coordinates The array of size locations.
+    /// \param size The number of locations.
+    /// \param executor The Executor used to run the calculation.
+    /// \returns the bounds of the coordinates.
+    static CoordinateBounds bounds(const Coordinate* coordinates,
+                                   std::size_t size,
+                                   const Executor& executor = Executor::serial());
+
+    /// \brief Convert the Coordinate to an NVector.
+    /// \param coordinate The location.
+    /// \returns the unit vector of the location.
+    static NVector toNVector(const Coordinate& coordinate);
+
+    /// \brief Convert Coordinates to NVectors.
+    /// \param coordinates The input array of size locations.
+    /// \param size The number of locations.
+    /// \param vectors The output array of size unit vectors.
+    /// \param executor The Executor used to run the conversion.
+    static void toNVector(const Coordinate* coordinates,
+                          std::size_t size,
+                          NVector* vectors,
+                          const Executor& executor = Executor::serial());
+
+    /// \brief Convert the NVector to a Coordinate.
+    /// \param vector The unit vector.
+    /// \returns the location.
+    static Coordinate toCoordinate(const NVector& vector);
+
+    /// \brief Convert the ElevatedCoordinate to an ECEFLocation using the WGS84 Datum.
+    /// \param coordinate The location, with elevation above the ellipsoid.
+    /// \returns the earth-centered, earth-fixed location in meters.
+    static ECEFLocation toECEF(const ElevatedCoordinate& coordinate);
+
+    /// \brief Convert the Coordinate to an ECEFLocation on the WGS84 ellipsoid.
+    /// \param coordinate The location.
+    /// \returns the earth-centered, earth-fixed location in meters.
+    static ECEFLocation toECEF(const Coordinate& coordinate);
+
+    /// \brief Convert ElevatedCoordinates to ECEFLocations using the WGS84 Datum.
+    /// \param coordinates The input array of size locations.
+    /// \param size The number of locations.
+    /// \param locations The output array of size locations.
+    /// \param executor The Executor used to run the conversion.
+    static void toECEF(const ElevatedCoordinate* coordinates,
+                       std::size_t size,
+                       ECEFLocation* locations,
+                       const Executor& executor = Executor::serial());
+
+    /// \brief Convert the ECEFLocation to an ElevatedCoordinate using the WGS84 Datum.
+    /// \param location The earth-centered, earth-fixed location in meters.
+    /// \returns the location, with elevation above the ellipsoid.
+    static ElevatedCoordinate toElevatedCoordinate(const ECEFLocation& location);
+
+    /// \brief Get the great-circle distance in kilometers between two NVectors.
+    ///
+    /// The distance uses atan2 of the cross and dot products, which is
+    /// accurate for all separations.
+    ///
+    /// \param vector0 The first location.
+    /// \param vector1 The second location.
+    /// \returns the spherical distance in kilometers.
+    static double distance(const NVector& vector0, const NVector& vector1);
+
+    /// \brief Get the great-circle distances from one NVector to many.
+    /// \param vector0 The first location.
+    /// \param vectors The array of size locations.
+    /// \param size The number of locations.
+    /// \param distances The output array of size distances in kilometers.
+    static void distance(const NVector& vector0,
+                         const NVector* vectors,
+                         std::size_t size,
+                         double* distances);
+
+    /// \brief Get the initial bearing in degrees from one NVector to another.
+    /// \param vector0 The first location.
+    /// \param vector1 The second location.
+    /// \returns the bearing in degrees in [0, 360).
+    static double bearing(const NVector& vector0, const NVector& vector1);
+
+    /// \brief Get the initial bearings from one NVector to many.
+    /// \param vector0 The first location.
+    /// \param vectors The array of size locations.
+    /// \param size The number of locations.
+    /// \param bearings The output array of size bearings in degrees.
+    static void bearing(const NVector& vector0,
+                        const NVector* vectors,
+                        std::size_t size,
+                        double* bearings);
+
     /// \brief Convert the UTMLocation to an glm::dvec2.
     /// \param location The UTMLocation.
     /// \returns the converted location.
     static glm::dvec2 toVec(const UTMLocation& location);
 
     /// \brief Convert the Coordinate to an glm::dvec2 via a UTM Location.
+    ///
+    /// The result is discontinuous across UTM zones.
+    ///
+    /// \sa WebMercator::toMeters() for a continuous map projection.
     /// \param coordinate The Coordinate.
     /// \returns the converted location.
     static glm::dvec2 toVec(const Coordinate& coordinate);
@@ -0,0 +1,156 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include <vector>
+#include "ofVectorMath.h"
+#include "ofx/Geo/Coordinate.h"
+#include "ofx/Geo/NVector.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+/// \brief The shorter great-circle arc between two Coordinates.
+///
+/// The arc's end points are converted to NVectors once on construction,
+/// together with an orthonormal basis of the arc's plane. Intermediate points
+/// then cost one sin / cos pair and one vector to latitude / longitude
+/// conversion each, with no per-point setup.
+///
+/// For antipodal end points the arc is not unique; the arc through the
+/// north (or, from a pole, the prime meridian) direction is used.
+class GreatCircleArc
+{
+public:
+    /// \brief Create a zero length arc at 0, 0.
+    GreatCircleArc();
+
+    /// \brief Create an arc between two Coordinates.
+    /// \param start The start of the arc.
+    /// \param end The end of the arc.
+    GreatCircleArc(const Coordinate& start, const Coordinate& end);
+
+    /// \brief Create an arc between two NVectors.
+    /// \param start The start of the arc.
+    /// \param end The end of the arc.
+    GreatCircleArc(const NVector& start, const NVector& end);
+
+    /// \brief Destroy the GreatCircleArc.
+    virtual ~GreatCircleArc();
+
+    /// \returns the start of the arc.
+    const Coordinate& getStart() const;
+
+    /// \returns the end of the arc.
+    const Coordinate& getEnd() const;
+
+    /// \returns the central angle of the arc in radians.
+    double getAngle() const;
+
+    /// \returns the length of the arc in kilometers on a spherical earth.
+    double getLength() const;
+
+    /// \brief Get an intermediate point.
+    /// \param fraction The fraction of the arc, 0 at the start and 1 at the end.
+    /// \returns the intermediate point.
+    Coordinate interpolate(double fraction) const;
+
+    /// \brief Get evenly spaced points along the arc.
+    ///
+    /// For count >= 2 the first point is the start and the last point is the
+    /// end. A count of 1 yields the start.
+    ///
+    /// \param count The number of points to write.
+    /// \param coordinates The output array of count coordinates.
+    void interpolate(std::size_t count, Coordinate* coordinates) const;
+
+    /// \brief Get the number of points needed to densify the arc.
+    /// \param maxSegmentLength The maximum distance between points in kilometers.
+    /// \returns the number of points including the start and end.
+    std::size_t getNumPoints(double maxSegmentLength) const;
+
+    /// \brief Append evenly spaced points no more than a distance apart.
+    /// \param maxSegmentLength The maximum distance between points in kilometers.
+    /// \param coordinates The vector the points are appended to.
+    /// \param includeEnd True if the end point should be appended.
+    void densify(double maxSegmentLength,
+                 std::vector<Coordinate>& coordinates,
+                 bool includeEnd = true) const;
+
+    /// \brief Get the distance from a point to the arc's great circle.
+    /// \param coordinate The point.
+    /// \returns the signed distance in kilometers, positive to the right of
+    ///     the direction of travel.
+    double crossTrackDistance(const Coordinate& coordinate) const;
+
+    /// \brief Get the distance from a point to the arc's great circle.
+    /// \param vector The point.
+    /// \returns the signed distance in kilometers, positive to the right of
+    ///     the direction of travel.
+    double crossTrackDistance(const NVector& vector) const;
+
+    /// \brief Get the distances from points to the arc's great circle.
+    /// \param coordinates The array of size points.
+    /// \param size The number of points.
+    /// \param distances The output array of size signed distances in kilometers.
+    void crossTrackDistance(const Coordinate* coordinates,
+                            std::size_t size,
+                            double* distances) const;
+
+    /// \brief Get the distance along the arc's great circle to a point.
+    ///
+    /// This is the distance from the start to the point on the great circle
+    /// closest to the given point.
+    ///
+    /// \param coordinate The point.
+    /// \returns the signed distance in kilometers, negative behind the start.
+    double alongTrackDistance(const Coordinate& coordinate) const;
+
+    /// \brief Get the distance along the arc's great circle to a point.
+    /// \param vector The point.
+    /// \returns the signed distance in kilometers, negative behind the start.
+    double alongTrackDistance(const NVector& vector) const;
+
+    /// \brief Get the distances along the arc's great circle to points.
+    /// \param coordinates The array of size points.
+    /// \param size The number of points.
+    /// \param distances The output array of size signed distances in kilometers.
+    void alongTrackDistance(const Coordinate* coordinates,
+                            std::size_t size,
+                            double* distances) const;
+
+private:
+    /// \brief Set the angle and basis vectors from _a toward the end.
+    /// \param end The unit vector of the end.
+    void _setup(const NVector& end);
+
+    /// \brief The start of the arc.
+    Coordinate _start;
+
+    /// \brief The end of the arc.
+    Coordinate _end;
+
+    /// \brief The unit vector of the start.
+    NVector _a;
+
+    /// \brief The unit vector orthogonal to _a, toward the end.
+    glm::dvec3 _u;
+
+    /// \brief The unit normal of the arc's plane, _a x _u.
+    glm::dvec3 _n;
+
+    /// \brief The central angle in radians.
+    double _angle = 0;
+
+};
+
+
+} } // namespace ofx::Geo
@@ -0,0 +1,88 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include "ofVectorMath.h"
+#include "ofx/Geo/Coordinate.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+/// \brief A local east / north plane in meters around an origin Coordinate.
+///
+/// Positions are projected with the WGS84 meridional and prime vertical
+/// radii of curvature at the origin. The projection costs a few
+/// multiplications per point, but its scale is fixed at the origin's
+/// latitude, so distances drift with the convergence of the meridians. The
+/// worst distance error is about tan(latitude) * d^2 / (5 * R) at a distance
+/// d from the origin, with R the radius of the earth: 3 cm at 1 km, 3 m at
+/// 10 km and 300 m at 100 km at 45 degrees, and 5 m at 10 km at 60 degrees.
+/// It is suited to filtering, simplification and other local metric work
+/// over a few kilometers. Longitudes are unwrapped across the antimeridian
+/// relative to the origin.
+class LocalTangentPlane
+{
+public:
+    /// \brief Create a LocalTangentPlane at 0, 0.
+    LocalTangentPlane();
+
+    /// \brief Create a LocalTangentPlane at the given origin.
+    /// \param origin The origin of the plane.
+    LocalTangentPlane(const Coordinate& origin);
+
+    /// \brief Destroy the LocalTangentPlane.
+    virtual ~LocalTangentPlane();
+
+    /// \brief Set the origin of the plane.
+    /// \param origin The origin of the plane.
+    void setOrigin(const Coordinate& origin);
+
+    /// \returns the origin of the plane.
+    const Coordinate& getOrigin() const;
+
+    /// \brief Project a Coordinate onto the plane.
+    /// \param coordinate The Coordinate to project.
+    /// \returns the east (x) and north (y) offsets in meters.
+    glm::dvec2 toLocal(const Coordinate& coordinate) const;
+
+    /// \brief Project Coordinates onto the plane.
+    /// \param coordinates The array of size coordinates.
+    /// \param size The number of coordinates.
+    /// \param positions The output array of size east / north offsets in meters.
+    void toLocal(const Coordinate* coordinates,
+                 std::size_t size,
+                 glm::dvec2* positions) const;
+
+    /// \brief Convert a position on the plane to a Coordinate.
+    /// \param position The east (x) and north (y) offsets in meters.
+    /// \returns the Coordinate.
+    Coordinate toCoordinate(const glm::dvec2& position) const;
+
+    /// \returns the number of meters per degree of latitude at the origin.
+    double getMetersPerDegreeLatitude() const;
+
+    /// \returns the number of meters per degree of longitude at the origin.
+    double getMetersPerDegreeLongitude() const;
+
+private:
+    /// \brief The origin of the plane.
+    Coordinate _origin;
+
+    /// \brief Meters per degree of latitude at the origin.
+    double _metersPerDegreeLatitude = 0;
+
+    /// \brief Meters per degree of longitude at the origin.
+    double _metersPerDegreeLongitude = 0;
+
+};
+
+
+} } // namespace ofx::Geo
@@ -0,0 +1,219 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include <limits>
+#include <vector>
+#include "ofVectorMath.h"
+#include "ofx/Geo/Coordinate.h"
+#include "ofx/Geo/CoordinateBounds.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+/// \brief A marker to draw: a single point or a cluster of points.
+struct MarkerCluster
+{
+    /// \brief True if this is a cluster, false if it is a single point.
+    bool cluster;
+
+    /// \brief The cluster id, or the index of the point.
+    std::size_t id;
+
+    /// \brief The number of points in the cluster, 1 for a single point.
+    std::size_t count;
+
+    /// \brief The location of the point, or the mean location of the cluster.
+    Coordinate coordinate;
+};
+
+
+/// \brief A hierarchical clustering of map markers over all zoom levels.
+///
+/// The index is built once. Starting at the deepest zoom, points within a
+/// pixel radius of each other are merged into weighted clusters, and those
+/// clusters are merged again at each shallower zoom. Each zoom level keeps a
+/// KD-tree over its clusters in normalized Web Mercator coordinates, so a
+/// viewport query is a range search that touches only visible clusters.
+///
+/// Cluster ids encode the zoom and position of the cluster, so children,
+/// leaves and expansion zooms are found without extra storage.
+///
+/// \sa https://github.com/mapbox/supercluster
+class MarkerIndex
+{
+public:
+    /// \brief Create an empty MarkerIndex.
+    /// \param radius The cluster radius in pixels.
+    /// \param minZoom The shallowest zoom level at which to cluster.
+    /// \param maxZoom The deepest zoom level at which to cluster.
+    /// \param minPoints The minimum number of points that form a cluster.
+    /// \param tileSize The size of a tile in pixels.
+    MarkerIndex(double radius = DEFAULT_RADIUS,
+                int minZoom = 0,
+                int maxZoom = DEFAULT_MAX_ZOOM,
+                std::size_t minPoints = 2,
+                double tileSize = DEFAULT_TILE_SIZE);
+
+    /// \brief Destroy the MarkerIndex.
+    virtual ~MarkerIndex();
+
+    /// \brief Build the index.
+    /// \param coordinates The points. Results refer to their indices.
+    void build(const std::vector<Coordinate>& coordinates);
+
+    /// \brief Build the index.
+    /// \param coordinates The array of size points.
+    /// \param size The number of points.
+    void build(const Coordinate* coordinates, std::size_t size);
+
+    /// \brief Get the clusters and points in a region at a zoom level.
+    ///
+    /// Regions crossing the antimeridian are handled. Zooms deeper than the
+    /// maximum zoom return the points themselves.
+    ///
+    /// \param bounds The region, usually the viewport.
+    /// \param zoom The zoom level.
+    /// \param clusters The vector the markers are appended to.
+    /// \returns the number of markers appended.
+    std::size_t getClusters(const CoordinateBounds& bounds,
+                            int zoom,
+                            std::vector<MarkerCluster>& clusters) const;
+
+    /// \brief Get the markers a cluster splits into at the next zoom level.
+    /// \param clusterId The cluster id.
+    /// \param children The vector the markers are appended to.
+    /// \returns false if the cluster id is not valid.
+    bool getChildren(std::size_t clusterId,
+                     std::vector<MarkerCluster>& children) const;
+
+    /// \brief Get the points in a cluster.
+    /// \param clusterId The cluster id.
+    /// \param leaves The vector the point indices are appended to.
+    /// \param limit The maximum number of indices to append.
+    /// \param offset The number of leading points to skip.
+    /// \returns false if the cluster id is not valid.
+    bool getLeaves(std::size_t clusterId,
+                   std::vector<std::size_t>& leaves,
+                   std::size_t limit = std::numeric_limits<std::size_t>::max(),
+                   std::size_t offset = 0) const;
+
+    /// \brief Get the zoom level at which a cluster splits into several markers.
+    /// \param clusterId The cluster id.
+    /// \returns the zoom level, or -1 if the cluster id is not valid.
+    int getExpansionZoom(std::size_t clusterId) const;
+
+    /// \returns the number of indexed points.
+    std::size_t size() const;
+
+    /// \brief The default cluster radius in pixels.
+    static const double DEFAULT_RADIUS;
+
+    /// \brief The default deepest zoom level at which to cluster.
+    static const int DEFAULT_MAX_ZOOM;
+
+    /// \brief The default tile size in pixels used to scale the radius.
+    static const double DEFAULT_TILE_SIZE;
+
+    /// \brief The number of leaf entries in a KD-tree node.
+    static const std::size_t KD_NODE_SIZE;
+
+private:
+    /// \brief A point or cluster at one zoom level.
+    struct Node
+    {
+        /// \brief The normalized Web Mercator position.
+        glm::dvec2 position;
+
+        /// \brief The cluster id, or the point index for points.
+        std::size_t id;
+
+        /// \brief The id of the cluster that absorbed the node, if any.
+        std::size_t parentId;
+
+        /// \brief The number of points.
+        std::size_t count;
+
+        /// \brief The shallowest zoom level the node has been clustered at.
+        int zoom;
+
+        /// \brief True if this is a cluster.
+        bool cluster;
+    };
+
+    /// \brief Sort nodes into a static KD-tree.
+    static void _sort(std::vector<Node>& nodes,
+                      std::size_t left,
+                      std::size_t right,
+                      int axis);
+
+    /// \brief Find the nodes in a box.
+    static void _range(const std::vector<Node>& nodes,
+                       const glm::dvec2& min,
+                       const glm::dvec2& max,
+                       std::vector<std::size_t>& indices);
+
+    /// \brief Find the nodes within a radius.
+    static void _within(const std::vector<Node>& nodes,
+                        const glm::dvec2& center,
+                        double radius,
+                        std::vector<std::size_t>& indices);
+
+    /// \brief Cluster the nodes of the next deeper level.
+    /// \param zoom The zoom level to create.
+    void _cluster(int zoom);
+
+    /// \returns the marker for a node.
+    MarkerCluster _toMarker(const Node& node) const;
+
+    /// \returns the cluster radius in normalized units at a zoom level.
+    double _radius(int zoom) const;
+
+    /// \brief Find the node of a cluster id.
+    /// \returns false if the id is not valid.
+    bool _origin(std::size_t clusterId, int& zoom, std::size_t& index) const;
+
+    /// \brief Collect the leaves of a cluster.
+    /// \param clusterId The cluster id.
+    /// \param leaves The vector the point indices are appended to.
+    /// \param remaining The number of indices still to append.
+    /// \param offset The number of leading points still to skip.
+    void _leaves(std::size_t clusterId,
+                 std::vector<std::size_t>& leaves,
+                 std::size_t& remaining,
+                 std::size_t& offset) const;
+
+    /// \brief The cluster radius in pixels.
+    double _radiusPx = DEFAULT_RADIUS;
+
+    /// \brief The shallowest zoom level at which to cluster.
+    int _minZoom = 0;
+
+    /// \brief The deepest zoom level at which to cluster.
+    int _maxZoom = DEFAULT_MAX_ZOOM;
+
+    /// \brief The minimum number of points that form a cluster.
+    std::size_t _minPoints = 2;
+
+    /// \brief The tile size in pixels.
+    double _tileSize = DEFAULT_TILE_SIZE;
+
+    /// \brief The indexed points.
+    std::vector<Coordinate> _coordinates;
+
+    /// \brief The nodes of each zoom level sorted into KD-trees, indexed by
+    ///     zoom. Level maxZoom + 1 holds the points.
+    std::vector<std::vector<Node>> _levels;
+
+};
+
+
+} } // namespace ofx::Geo
@@ -0,0 +1,114 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include <iostream>
+#include "ofVectorMath.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+/// \brief A position on a spherical earth as a unit normal vector.
+///
+/// x points to latitude 0, longitude 0, y to latitude 0, longitude 90 and
+/// z to the north pole. Converting a Coordinate to an NVector costs two
+/// sin / cos pairs, after which distances, bearings and interpolation are
+/// dot and cross products, so repeated queries pay for trigonometry once.
+///
+/// \sa GeoUtils::toNVector()
+/// \sa http://www.movable-type.co.uk/scripts/latlong-vectors.html
+class NVector: public glm::dvec3
+{
+public:
+    /// \brief Create an NVector at latitude 0, longitude 0.
+    NVector();
+
+    /// \brief Create an NVector from a vector.
+    /// \param vector A non-zero vector, which will be normalized.
+    NVector(const glm::dvec3& vector);
+
+    /// \brief Create an NVector from components.
+    ///
+    /// The components will be normalized.
+    ///
+    /// \param x The x component.
+    /// \param y The y component.
+    /// \param z The z component.
+    NVector(double x, double y, double z);
+
+    /// \brief Destroy the NVector.
+    virtual ~NVector();
+
+    /// \returns the latitude in degrees.
+    double getLatitude() const;
+
+    /// \returns the longitude in degrees.
+    double getLongitude() const;
+
+    /// \brief Stream output.
+    /// \param os the std::ostream.
+    /// \param vector The NVector to output.
+    /// \returns the updated std::ostream reference.
+    friend std::ostream& operator << (std::ostream& os,
+                                      const NVector& vector);
+
+    /// \brief The north pole.
+    static const NVector NORTH_POLE;
+
+};
+
+
+inline std::ostream& operator << (std::ostream& os, const NVector& vector)
+{
+    os << vector.x << ", " << vector.y << ", " << vector.z;
+    return os;
+}
+
+
+/// \brief An earth-centered, earth-fixed position on the WGS84 ellipsoid.
+///
+/// x points to latitude 0, longitude 0, y to latitude 0, longitude 90 and
+/// z to the north pole. Units are meters.
+///
+/// \sa GeoUtils::toECEF()
+class ECEFLocation: public glm::dvec3
+{
+public:
+    /// \brief Create an ECEFLocation at the earth's center.
+    ECEFLocation();
+
+    /// \brief Create an ECEFLocation from components in meters.
+    /// \param x The x component in meters.
+    /// \param y The y component in meters.
+    /// \param z The z component in meters.
+    ECEFLocation(double x, double y, double z);
+
+    /// \brief Destroy the ECEFLocation.
+    virtual ~ECEFLocation();
+
+    /// \brief Stream output.
+    /// \param os the std::ostream.
+    /// \param location The ECEFLocation to output.
+    /// \returns the updated std::ostream reference.
+    friend std::ostream& operator << (std::ostream& os,
+                                      const ECEFLocation& location);
+
+};
+
+
+inline std::ostream& operator << (std::ostream& os, const ECEFLocation& location)
+{
+    os << location.x << ", " << location.y << ", " << location.z;
+    return os;
+}
+
+
+} } // namespace ofx::Geo
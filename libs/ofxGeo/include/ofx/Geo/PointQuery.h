@@ -0,0 +1,198 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include <limits>
+#include <memory>
+#include <vector>
+#include "ofx/Geo/CellIndex.h"
+#include "ofx/Geo/Coordinate.h"
+#include "ofx/Geo/CoordinateBounds.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+/// \brief A spatial index backend for PointQuery.
+///
+/// A backend only needs to return a superset of the points inside a box;
+/// PointQuery performs the exact distance tests.
+class PointIndex
+{
+public:
+    /// \brief Destroy the PointIndex.
+    virtual ~PointIndex();
+
+    /// \brief Index points, replacing any previous points.
+    /// \param coordinates The array of size locations.
+    /// \param size The number of locations.
+    virtual void build(const Coordinate* coordinates, std::size_t size) = 0;
+
+    /// \brief Find the points that may lie inside a box.
+    /// \param bounds The box, which may cross the antimeridian.
+    /// \param indices The vector the point indices are appended to.
+    virtual void query(const CoordinateBounds& bounds,
+                       std::vector<std::size_t>& indices) const = 0;
+
+};
+
+
+/// \brief A PointIndex that tests every point against the box.
+class LinearPointIndex: public PointIndex
+{
+public:
+    /// \brief Destroy the LinearPointIndex.
+    virtual ~LinearPointIndex();
+
+    void build(const Coordinate* coordinates, std::size_t size) override;
+
+    void query(const CoordinateBounds& bounds,
+               std::vector<std::size_t>& indices) const override;
+
+private:
+    /// \brief The latitudes in degrees.
+    std::vector<double> _latitudes;
+
+    /// \brief The longitudes in degrees.
+    std::vector<double> _longitudes;
+
+};
+
+
+/// \brief A PointIndex backed by a CellIndex.
+class CellPointIndex: public PointIndex
+{
+public:
+    /// \brief Create a CellPointIndex.
+    /// \param maxCells The number of cells used to cover each box.
+    CellPointIndex(std::size_t maxCells = CellIndex::DEFAULT_MAX_CELLS);
+
+    /// \brief Destroy the CellPointIndex.
+    virtual ~CellPointIndex();
+
+    void build(const Coordinate* coordinates, std::size_t size) override;
+
+    void query(const CoordinateBounds& bounds,
+               std::vector<std::size_t>& indices) const override;
+
+    /// \returns the underlying CellIndex.
+    const CellIndex& getIndex() const;
+
+private:
+    /// \brief The index.
+    CellIndex _index;
+
+    /// \brief The number of cells used to cover each box.
+    std::size_t _maxCells = CellIndex::DEFAULT_MAX_CELLS;
+
+};
+
+
+/// \brief A point and its distance from a query location.
+struct PointQueryResult
+{
+    /// \brief The index of the point.
+    std::size_t index;
+
+    /// \brief The haversine distance in kilometers.
+    double distance;
+};
+
+
+/// \brief Radius and nearest-neighbor queries over a fixed set of points.
+///
+/// Queries derive latitude / longitude boxes from the search radius, ask
+/// the PointIndex backend for candidates and test them with a haversine
+/// kernel over precomputed per-point trigonometry. Candidates are compared
+/// in the haversine's squared-chord domain, so rejected points never pay
+/// for the inverse trigonometry.
+class PointQuery
+{
+public:
+    /// \brief Create a PointQuery with a CellPointIndex backend.
+    PointQuery();
+
+    /// \brief Create a PointQuery with a custom backend.
+    /// \param index The backend.
+    PointQuery(std::shared_ptr<PointIndex> index);
+
+    /// \brief Destroy the PointQuery.
+    virtual ~PointQuery();
+
+    /// \brief Set the points to query and rebuild the backend.
+    /// \param coordinates The points. Results refer to their indices.
+    void setPoints(const std::vector<Coordinate>& coordinates);
+
+    /// \brief Find the points within a distance of a location.
+    /// \param center The center of the search.
+    /// \param radius The search radius in kilometers.
+    /// \param results The vector the results are appended to, ordered by index.
+    /// \returns the number of results appended.
+    std::size_t radius(const Coordinate& center,
+                       double radius,
+                       std::vector<PointQueryResult>& results) const;
+
+    /// \brief Find the points nearest to a location.
+    ///
+    /// The search radius starts from an estimate based on the point
+    /// density and doubles until k points are found.
+    ///
+    /// \param center The center of the search.
+    /// \param k The maximum number of points to find.
+    /// \param results The vector the results are appended to, nearest first.
+    /// \param maxRadius The maximum distance of a result in kilometers.
+    /// \returns the number of results appended.
+    std::size_t nearest(const Coordinate& center,
+                        std::size_t k,
+                        std::vector<PointQueryResult>& results,
+                        double maxRadius = std::numeric_limits<double>::max()) const;
+
+    /// \returns the number of points.
+    std::size_t size() const;
+
+    /// \returns the backend.
+    std::shared_ptr<PointIndex> getIndex() const;
+
+private:
+    /// \brief Collect the candidates within an angular radius.
+    /// \param center The center of the search.
+    /// \param radius The search radius in kilometers.
+    /// \param candidates The output candidate indices.
+    void _candidates(const Coordinate& center,
+                     double radius,
+                     std::vector<std::size_t>& candidates) const;
+
+    /// \brief Get the haversine term for a point.
+    /// \param latitude The query latitude in radians.
+    /// \param longitude The query longitude in radians.
+    /// \param cosLatitude The cosine of the query latitude.
+    /// \param index The point index.
+    /// \returns the haversine of the central angle, in [0, 1].
+    double _haversine(double latitude,
+                      double longitude,
+                      double cosLatitude,
+                      std::size_t index) const;
+
+    /// \brief The backend.
+    std::shared_ptr<PointIndex> _index;
+
+    /// \brief The latitudes in radians.
+    std::vector<double> _latitudes;
+
+    /// \brief The longitudes in radians.
+    std::vector<double> _longitudes;
+
+    /// \brief The cosines of the latitudes.
+    std::vector<double> _cosLatitudes;
+
+};
+
+
+} } // namespace ofx::Geo
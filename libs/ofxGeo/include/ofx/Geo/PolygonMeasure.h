@@ -0,0 +1,132 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include "ofx/Geo/Coordinate.h"
+#include "ofx/Geo/CoordinatePolyline.h"
+#include "ofx/Geo/Executor.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+/// \brief The area, perimeter and centroid of a polygon.
+struct PolygonMeasurement
+{
+    /// \brief The signed area in square kilometers.
+    double area;
+
+    /// \brief The perimeter in kilometers.
+    double perimeter;
+
+    /// \brief The centroid of the enclosed surface.
+    Coordinate centroid;
+
+};
+
+
+/// \brief Measure polygons on the sphere or the WGS84 ellipsoid.
+///
+/// A polygon is a ring of vertices that is closed implicitly; repeating the
+/// first vertex at the end is allowed. Edges are great circles, and rings
+/// may cross the antimeridian or enclose a pole.
+///
+/// The area is signed: positive when the vertices run counter-clockwise
+/// around the enclosed region, negative when clockwise. The enclosed region
+/// is taken to be the smaller side of the ring, so the magnitude never
+/// exceeds half of the earth's surface.
+///
+/// Spherical areas use the exact spherical excess of each edge. Ellipsoidal
+/// areas map latitudes to authalic latitudes, which preserve area, and
+/// measure on the sphere of equal surface area. Ellipsoidal perimeters are
+/// geodesic lengths. All sums are compensated, so huge rings lose no
+/// accuracy to rounding.
+class PolygonMeasure
+{
+public:
+    /// \brief The earth model used for measurements.
+    enum Model
+    {
+        /// \brief A sphere of radius GeoUtils::EARTH_RADIUS_KM.
+        SPHERE,
+        /// \brief The WGS84 ellipsoid.
+        ELLIPSOID
+    };
+
+    /// \brief Get the area of a polygon.
+    /// \param ring The vertices of the polygon.
+    /// \param model The earth model.
+    /// \returns the signed area in square kilometers.
+    static double area(const CoordinatePolyline& ring, Model model = SPHERE);
+
+    /// \brief Get the perimeter of a polygon.
+    /// \param ring The vertices of the polygon.
+    /// \param model The earth model.
+    /// \returns the perimeter in kilometers.
+    static double perimeter(const CoordinatePolyline& ring, Model model = SPHERE);
+
+    /// \brief Get the centroid of the surface enclosed by a polygon.
+    ///
+    /// The centroid of the curved surface is projected back onto the earth.
+    ///
+    /// \param ring The vertices of the polygon.
+    /// \param model The earth model.
+    /// \returns the centroid.
+    static Coordinate centroid(const CoordinatePolyline& ring, Model model = SPHERE);
+
+    /// \brief Measure a polygon in one pass over its vertices.
+    /// \param ring The vertices of the polygon.
+    /// \param model The earth model.
+    /// \returns the measurement.
+    static PolygonMeasurement measure(const CoordinatePolyline& ring,
+                                      Model model = SPHERE);
+
+    /// \brief Measure a polygon in one pass over its vertices.
+    /// \param coordinates The array of size vertices.
+    /// \param size The number of vertices.
+    /// \param model The earth model.
+    /// \returns the measurement.
+    static PolygonMeasurement measure(const Coordinate* coordinates,
+                                      std::size_t size,
+                                      Model model = SPHERE);
+
+    /// \brief Measure many polygons.
+    /// \param rings The array of size polygons.
+    /// \param size The number of polygons.
+    /// \param measurements The output array of size measurements.
+    /// \param model The earth model.
+    /// \param executor The Executor used to run the calculation.
+    static void measure(const CoordinatePolyline* rings,
+                        std::size_t size,
+                        PolygonMeasurement* measurements,
+                        Model model = SPHERE,
+                        const Executor& executor = Executor::serial());
+
+    /// \brief Get the authalic latitude of a geodetic latitude on WGS84.
+    /// \param latitude The geodetic latitude in radians.
+    /// \returns the authalic latitude in radians.
+    static double toAuthalicLatitude(double latitude);
+
+    /// \brief Get the geodetic latitude of an authalic latitude on WGS84.
+    /// \param latitude The authalic latitude in radians.
+    /// \returns the geodetic latitude in radians.
+    static double fromAuthalicLatitude(double latitude);
+
+    /// \brief The radius in kilometers of the sphere with the surface area of WGS84.
+    static const double AUTHALIC_RADIUS_KM;
+
+private:
+    PolygonMeasure() = delete;
+    ~PolygonMeasure() = delete;
+
+};
+
+
+} } // namespace ofx::Geo
@@ -0,0 +1,206 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include <vector>
+#include "ofx/Geo/Coordinate.h"
+#include "ofx/Geo/CoordinateBounds.h"
+#include "ofx/Geo/CoordinatePolyline.h"
+#include "ofx/Geo/UTMLocationBounds.h"
+#include "ofx/Geo/WebMercator.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+/// \brief Receives clipped polylines as a stream of vertices.
+///
+/// Each clipped polyline is delivered as a call to begin(), one call to
+/// vertex() per vertex and a call to end(). Polylines are never nested.
+class PolylineSink
+{
+public:
+    /// \brief Destroy the PolylineSink.
+    virtual ~PolylineSink();
+
+    /// \brief Start a new polyline.
+    virtual void begin() = 0;
+
+    /// \brief Add a vertex to the current polyline.
+    /// \param coordinate The vertex.
+    virtual void vertex(const Coordinate& coordinate) = 0;
+
+    /// \brief Finish the current polyline.
+    virtual void end() = 0;
+
+};
+
+
+/// \brief Receives polylines split across map tiles as a stream of vertices.
+///
+/// \sa PolylineSink
+class TilePolylineSink
+{
+public:
+    /// \brief Destroy the TilePolylineSink.
+    virtual ~TilePolylineSink();
+
+    /// \brief Start a new polyline.
+    /// \param tile The tile containing the polyline.
+    virtual void begin(const Tile& tile) = 0;
+
+    /// \brief Add a vertex to the current polyline.
+    /// \param coordinate The vertex.
+    virtual void vertex(const Coordinate& coordinate) = 0;
+
+    /// \brief Finish the current polyline.
+    virtual void end() = 0;
+
+};
+
+
+/// \brief A PolylineSink that collects the clipped polylines.
+class PolylineCollector: public PolylineSink
+{
+public:
+    /// \brief Destroy the PolylineCollector.
+    virtual ~PolylineCollector();
+
+    void begin() override;
+    void vertex(const Coordinate& coordinate) override;
+    void end() override;
+
+    /// \brief Remove all collected polylines.
+    void clear();
+
+    /// \returns the collected polylines.
+    const std::vector<CoordinatePolyline>& getPolylines() const;
+
+private:
+    /// \brief The collected polylines.
+    std::vector<CoordinatePolyline> _polylines;
+
+};
+
+
+/// \brief Clip polylines to rectangles with the Liang-Barsky algorithm.
+///
+/// Vertices are streamed through a sink in one pass, so no intermediate
+/// polylines are built. Vertices inside the clip region are passed through
+/// unchanged and each crossing of the boundary adds an interpolated vertex on
+/// the boundary. A polyline that leaves and re-enters the region is split
+/// into several polylines.
+///
+/// Segments are clipped as straight lines in the plane of the clip region:
+/// latitude and longitude for CoordinateBounds, easting and northing for
+/// UTMLocationBounds and Web Mercator for tiles. Use
+/// CoordinatePolyline::getDensified() first if long segments should follow
+/// great circles.
+class PolylineClipper
+{
+public:
+    /// \brief Clip a polyline to CoordinateBounds.
+    ///
+    /// Bounds crossing the antimeridian are handled, and each segment takes
+    /// the shorter way around.
+    ///
+    /// \param polyline The polyline to clip.
+    /// \param bounds The clip region.
+    /// \param sink The sink receiving the clipped polylines.
+    /// \returns the number of polylines passed to the sink.
+    static std::size_t clip(const CoordinatePolyline& polyline,
+                            const CoordinateBounds& bounds,
+                            PolylineSink& sink);
+
+    /// \brief Clip an array of vertices to CoordinateBounds.
+    /// \param coordinates The array of size vertices.
+    /// \param size The number of vertices.
+    /// \param bounds The clip region.
+    /// \param sink The sink receiving the clipped polylines.
+    /// \returns the number of polylines passed to the sink.
+    static std::size_t clip(const Coordinate* coordinates,
+                            std::size_t size,
+                            const CoordinateBounds& bounds,
+                            PolylineSink& sink);
+
+    /// \brief Clip a polyline to UTMLocationBounds.
+    ///
+    /// Vertices are projected into the zone of the bounds.
+    ///
+    /// \param polyline The polyline to clip.
+    /// \param bounds The clip region.
+    /// \param sink The sink receiving the clipped polylines.
+    /// \returns the number of polylines passed to the sink.
+    static std::size_t clip(const CoordinatePolyline& polyline,
+                            const UTMLocationBounds& bounds,
+                            PolylineSink& sink);
+
+    /// \brief Clip an array of vertices to UTMLocationBounds.
+    /// \param coordinates The array of size vertices.
+    /// \param size The number of vertices.
+    /// \param bounds The clip region.
+    /// \param sink The sink receiving the clipped polylines.
+    /// \returns the number of polylines passed to the sink.
+    static std::size_t clip(const Coordinate* coordinates,
+                            std::size_t size,
+                            const UTMLocationBounds& bounds,
+                            PolylineSink& sink);
+
+    /// \brief Split a polyline across the map tiles of a zoom level.
+    ///
+    /// Each segment walks the tiles it passes through, so the whole track is
+    /// split in one pass regardless of the number of tiles. The pieces are
+    /// passed to the sink in track order; a tile visited more than once
+    /// receives several polylines. Segments take the shorter way around the
+    /// antimeridian. Vertices on a tile edge belong to the pieces on either
+    /// side that have a segment; tiles the track only touches get no piece.
+    ///
+    /// \param polyline The polyline to split.
+    /// \param zoom The zoom level in [0, WebMercator::MAX_ZOOM].
+    /// \param sink The sink receiving the pieces.
+    /// \returns the number of polylines passed to the sink.
+    static std::size_t clip(const CoordinatePolyline& polyline,
+                            int zoom,
+                            TilePolylineSink& sink);
+
+    /// \brief Split an array of vertices across the map tiles of a zoom level.
+    /// \param coordinates The array of size vertices.
+    /// \param size The number of vertices.
+    /// \param zoom The zoom level in [0, WebMercator::MAX_ZOOM].
+    /// \param sink The sink receiving the pieces.
+    /// \returns the number of polylines passed to the sink.
+    static std::size_t clip(const Coordinate* coordinates,
+                            std::size_t size,
+                            int zoom,
+                            TilePolylineSink& sink);
+
+    /// \brief Clip a segment to a rectangle with the Liang-Barsky algorithm.
+    /// \param p0 The start of the segment.
+    /// \param p1 The end of the segment.
+    /// \param min The minimum corner of the rectangle.
+    /// \param max The maximum corner of the rectangle.
+    /// \param t0 Set to the segment parameter where the clipped segment starts.
+    /// \param t1 Set to the segment parameter where the clipped segment ends.
+    /// \returns true if the segment intersects the rectangle.
+    static bool clip(const glm::dvec2& p0,
+                     const glm::dvec2& p1,
+                     const glm::dvec2& min,
+                     const glm::dvec2& max,
+                     double& t0,
+                     double& t1);
+
+private:
+    PolylineClipper() = delete;
+    ~PolylineClipper() = delete;
+
+};
+
+
+} } // namespace ofx::Geo
@@ -0,0 +1,238 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include <cstdint>
+#include <vector>
+#include "ofVectorMath.h"
+#include "ofx/Geo/Coordinate.h"
+#include "ofx/Geo/CoordinateBounds.h"
+#include "ofx/Geo/CoordinatePolyline.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+/// \brief A level-of-detail index over a CoordinatePolyline.
+///
+/// Each vertex stores its significance, the Douglas-Peucker tolerance in
+/// Web Mercator map units at which it drops out, and the first zoom level
+/// at which it is visible for a given pixel tolerance. Extracting the
+/// vertices for a zoom level or viewport is then a filter with no
+/// re-simplification.
+///
+/// Vertices are simplified in fixed-size blocks. The end points of whole
+/// blocks are simplified together as a coarse skeleton, and the last block
+/// is simplified between its own end points, so appending vertices only
+/// recomputes the last block, and the skeleton once per block. Dropped
+/// vertices stay within the tolerance of the extracted polyline. Each block
+/// keeps its bounds, so viewport queries skip blocks that are off screen,
+/// and keeps the visible vertices of each zoom level in index order, so
+/// queries do not sort.
+class PolylinePyramid
+{
+public:
+    /// \brief Create an empty PolylinePyramid.
+    /// \param tolerance The simplification tolerance in pixels.
+    /// \param blockSize The number of segments per block.
+    PolylinePyramid(double tolerance = DEFAULT_TOLERANCE,
+                    std::size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+    /// \brief Create a PolylinePyramid from a polyline.
+    /// \param polyline The polyline to index.
+    /// \param tolerance The simplification tolerance in pixels.
+    /// \param blockSize The number of segments per block.
+    PolylinePyramid(const CoordinatePolyline& polyline,
+                    double tolerance = DEFAULT_TOLERANCE,
+                    std::size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+    /// \brief Destroy the PolylinePyramid.
+    virtual ~PolylinePyramid();
+
+    /// \brief Append a vertex.
+    /// \param coordinate The vertex to add.
+    void addVertex(const Coordinate& coordinate);
+
+    /// \brief Append vertices, updating the index once.
+    /// \param coordinates The vertices to add.
+    void addVertices(const std::vector<Coordinate>& coordinates);
+
+    /// \brief Remove all vertices.
+    void clear();
+
+    /// \returns the number of vertices.
+    std::size_t size() const;
+
+    /// \returns the indexed polyline.
+    const CoordinatePolyline& getPolyline() const;
+
+    /// \brief Get the significance of a vertex.
+    /// \param index The vertex index.
+    /// \returns the tolerance in normalized Web Mercator units (the world is
+    ///     1 unit across) below which the vertex is kept; infinite for end
+    ///     points and the first vertex of the last block.
+    double getSignificance(std::size_t index) const;
+
+    /// \brief Get the first zoom level at which a vertex is visible.
+    /// \param index The vertex index.
+    /// \returns the zoom level.
+    int getMinZoom(std::size_t index) const;
+
+    /// \brief Get the vertices visible at a zoom level.
+    /// \param zoom The zoom level; fractional levels round down.
+    /// \param indices The vector the vertex indices are appended to, in order.
+    /// \returns the number of indices appended.
+    std::size_t getIndices(double zoom, std::vector<std::size_t>& indices) const;
+
+    /// \brief Get the vertices visible at a zoom level inside a viewport.
+    ///
+    /// Vertices are grouped into runs of connected vertices. Segments
+    /// leaving the viewport keep their outside end point.
+    ///
+    /// \param zoom The zoom level; fractional levels round down.
+    /// \param viewport The visible region.
+    /// \param indices The vector the vertex indices are appended to, in order.
+    /// \param runs The vector the offsets into indices at which each run
+    ///     starts are appended to.
+    /// \returns the number of indices appended.
+    std::size_t getIndices(double zoom,
+                           const CoordinateBounds& viewport,
+                           std::vector<std::size_t>& indices,
+                           std::vector<std::size_t>& runs) const;
+
+    /// \returns the simplification tolerance in pixels.
+    double getTolerance() const;
+
+    /// \returns the number of segments per block.
+    std::size_t getBlockSize() const;
+
+    /// \brief The default simplification tolerance in pixels.
+    static const double DEFAULT_TOLERANCE;
+
+    /// \brief The default number of segments per block.
+    static const std::size_t DEFAULT_BLOCK_SIZE;
+
+    /// \brief The deepest zoom level; every vertex is visible here.
+    static const int MAX_ZOOM;
+
+private:
+    /// \brief A run of vertices simplified together.
+    struct Block
+    {
+        /// \brief The bounds of the block's vertices, including both ends.
+        CoordinateBounds bounds;
+
+        /// \brief The minimum of the block's points in map units.
+        glm::dvec2 minimum;
+
+        /// \brief The maximum of the block's points in map units.
+        glm::dvec2 maximum;
+
+        /// \brief The visible interior vertex indices of each zoom level in
+        ///     index order, one run per level with new vertices.
+        std::vector<uint32_t> order;
+
+        /// \brief The offset in order of each zoom level's run.
+        std::vector<uint32_t> starts;
+
+        /// \brief The number of interior vertices visible at each zoom level.
+        std::vector<uint32_t> counts;
+
+        /// \brief The lowest minimum zoom of the interior vertices, or
+        ///     MAX_ZOOM if there are none.
+        uint8_t minZoom = uint8_t(MAX_ZOOM);
+    };
+
+    /// \brief Project a vertex and append its per-vertex state.
+    /// \param coordinate The vertex, already added to the polyline.
+    void _addPoint(const Coordinate& coordinate);
+
+    /// \brief Update the blocks from a vertex onward and the skeleton.
+    /// \param first The first vertex that changed.
+    void _update(std::size_t first);
+
+    /// \brief Simplify a block's interior and rebuild its order.
+    /// \param index The block index.
+    void _buildBlock(std::size_t index);
+
+    /// \brief Simplify the first vertices of the blocks.
+    ///
+    /// Each range's deviation includes the map-space boxes of the blocks it
+    /// spans, so dropping block end points never moves interior vertices
+    /// further than the tolerance. A block end point stays visible while
+    /// either adjacent block shows interior vertices.
+    void _buildSkeleton();
+
+    /// \brief Assign Douglas-Peucker significance to the vertices between
+    ///     indices[first] and indices[last].
+    /// \param indices The vertex indices of the candidate vertices.
+    /// \param first The first end point.
+    /// \param last The last end point.
+    void _simplify(const std::vector<std::size_t>& indices,
+                   std::size_t first,
+                   std::size_t last);
+
+    /// \brief Get the distance from a point to a segment in map units.
+    /// \param point The point.
+    /// \param a The start of the segment.
+    /// \param b The end of the segment.
+    /// \returns the distance.
+    static double _distance(const glm::dvec2& point,
+                            const glm::dvec2& a,
+                            const glm::dvec2& b);
+
+    /// \returns the first zoom level at which a significance is visible.
+    uint8_t _toMinZoom(double significance) const;
+
+    /// \returns the first vertex of a block.
+    std::size_t _blockBegin(std::size_t block) const;
+
+    /// \returns the last vertex of a block.
+    std::size_t _blockEnd(std::size_t block) const;
+
+    /// \brief Append a block's visible vertices, excluding its last vertex.
+    /// \param block The block index.
+    /// \param level The zoom level.
+    /// \param forceStart True if the first vertex is always appended.
+    /// \param indices The vector the vertex indices are appended to.
+    void _appendBlock(std::size_t block,
+                      uint8_t level,
+                      bool forceStart,
+                      std::vector<std::size_t>& indices) const;
+
+    /// \brief The simplification tolerance in pixels.
+    double _tolerance = DEFAULT_TOLERANCE;
+
+    /// \brief The number of segments per block.
+    std::size_t _blockSize = DEFAULT_BLOCK_SIZE;
+
+    /// \brief The vertices.
+    CoordinatePolyline _polyline;
+
+    /// \brief The vertices in normalized Web Mercator units, with x
+    ///     unwrapped across the antimeridian.
+    std::vector<glm::dvec2> _points;
+
+    /// \brief The significance of each vertex.
+    std::vector<double> _significance;
+
+    /// \brief The first visible zoom level of each vertex.
+    std::vector<uint8_t> _minZoom;
+
+    /// \brief The blocks.
+    std::vector<Block> _blocks;
+
+    /// \brief Scratch indices for simplification.
+    std::vector<std::size_t> _scratch;
+
+};
+
+
+} } // namespace ofx::Geo
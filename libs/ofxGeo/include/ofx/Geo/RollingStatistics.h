@@ -0,0 +1,110 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <deque>
+
+
+namespace ofx {
+namespace Geo {
+
+
+/// \brief Statistics of values within a sliding time window.
+///
+/// Samples older than the newest sample time minus the window are evicted as
+/// new samples are added. Count, sum, mean and variance are updated
+/// incrementally, the mean and variance with Welford's method so that large
+/// offsets don't cancel, and the minimum and maximum are tracked with
+/// monotonic queues, so adding a sample is amortized O(1) and queries are O(1).
+class RollingStatistics
+{
+public:
+    /// \brief Create RollingStatistics with the given window.
+    /// \param window The window duration in seconds.
+    RollingStatistics(double window = DEFAULT_WINDOW);
+
+    /// \brief Destroy the RollingStatistics.
+    virtual ~RollingStatistics();
+
+    /// \brief Add a sample.
+    ///
+    /// Samples must be added in non-decreasing time order.
+    ///
+    /// \param time The sample time in seconds.
+    /// \param value The sample value.
+    void add(double time, double value);
+
+    /// \brief Remove all samples.
+    void clear();
+
+    /// \brief Set the window duration.
+    /// \param window The window duration in seconds.
+    void setWindow(double window);
+
+    /// \returns the window duration in seconds.
+    double getWindow() const;
+
+    /// \returns the number of samples in the window.
+    std::size_t getCount() const;
+
+    /// \returns the sum of the samples in the window.
+    double getSum() const;
+
+    /// \returns the mean of the samples in the window, or 0 if empty.
+    double getMean() const;
+
+    /// \returns the population variance of the samples in the window, or 0 if empty.
+    double getVariance() const;
+
+    /// \returns the minimum of the samples in the window, or 0 if empty.
+    double getMinimum() const;
+
+    /// \returns the maximum of the samples in the window, or 0 if empty.
+    double getMaximum() const;
+
+    /// \brief The default window duration, 60 seconds.
+    static const double DEFAULT_WINDOW;
+
+private:
+    struct Sample
+    {
+        double time;
+        double value;
+    };
+
+    /// \brief Evict samples that are older than the window.
+    /// \param time The newest sample time in seconds.
+    void _evict(double time);
+
+    /// \brief The window duration in seconds.
+    double _window = DEFAULT_WINDOW;
+
+    /// \brief The samples in the window, oldest first.
+    std::deque<Sample> _samples;
+
+    /// \brief Candidate minimums with increasing values.
+    std::deque<Sample> _minimums;
+
+    /// \brief Candidate maximums with decreasing values.
+    std::deque<Sample> _maximums;
+
+    /// \brief The sum of the samples in the window.
+    double _sum = 0;
+
+    /// \brief The running mean of the samples in the window.
+    double _mean = 0;
+
+    /// \brief The sum of squared deviations from the mean in the window.
+    double _squaredDeviations = 0;
+
+};
+
+
+} } // namespace ofx::Geo
@@ -0,0 +1,98 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include <vector>
+#include "ofx/Geo/Coordinate.h"
+#include "ofx/Geo/CoordinatePolyline.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+/// \brief A point where two polyline segments meet.
+///
+/// Segment i joins vertices i and i + 1 of its polyline. The closing segment
+/// of a ring joins the last vertex to the first and has index size() - 1.
+struct SegmentIntersection
+{
+    /// \brief The index of the segment in the first polyline.
+    std::size_t segment0;
+
+    /// \brief The index of the segment in the second polyline, or the
+    ///     larger index of a self-intersection.
+    std::size_t segment1;
+
+    /// \brief The crossing, or the start of the overlap of collinear segments.
+    Coordinate coordinate;
+};
+
+
+/// \brief Finds crossings between polyline segments.
+///
+/// Vertices are projected onto a LocalTangentPlane centered on the
+/// polylines, and segments are straight lines in that plane. Segments are
+/// sorted by their extent along the longer axis of the polylines' bounds and
+/// swept in that order, so each segment is only tested against segments
+/// whose extents overlap its own. Tracks and rings cost about O(n log n)
+/// rather than the O(n²) of testing all pairs.
+///
+/// Touching counts as intersecting. Repeated vertices are ignored, and
+/// consecutive segments meeting at their shared vertex do not intersect
+/// unless the polyline doubles back over itself.
+class SegmentIntersector
+{
+public:
+    /// \brief Find the points where a polyline crosses itself.
+    /// \param polyline The polyline.
+    /// \param intersections The vector the intersections are appended to,
+    ///     ordered by segment0 and then segment1.
+    /// \param closed True if the polyline is a ring whose last vertex joins
+    ///     its first.
+    /// \returns the number of intersections appended.
+    static std::size_t findSelfIntersections(const CoordinatePolyline& polyline,
+                                             std::vector<SegmentIntersection>& intersections,
+                                             bool closed = false);
+
+    /// \brief Determine if a polyline crosses itself, stopping at the first
+    ///     crossing found.
+    /// \param polyline The polyline.
+    /// \param closed True if the polyline is a ring whose last vertex joins
+    ///     its first.
+    /// \returns true if the polyline crosses itself.
+    static bool hasSelfIntersection(const CoordinatePolyline& polyline,
+                                    bool closed = false);
+
+    /// \brief Find the points where two polylines cross.
+    /// \param polyline0 The first polyline.
+    /// \param polyline1 The second polyline.
+    /// \param intersections The vector the intersections are appended to,
+    ///     ordered by segment0 and then segment1.
+    /// \returns the number of intersections appended.
+    static std::size_t findIntersections(const CoordinatePolyline& polyline0,
+                                         const CoordinatePolyline& polyline1,
+                                         std::vector<SegmentIntersection>& intersections);
+
+    /// \brief Determine if two polylines cross, stopping at the first
+    ///     crossing found.
+    /// \param polyline0 The first polyline.
+    /// \param polyline1 The second polyline.
+    /// \returns true if the polylines cross.
+    static bool hasIntersection(const CoordinatePolyline& polyline0,
+                                const CoordinatePolyline& polyline1);
+
+private:
+    SegmentIntersector() = delete;
+    ~SegmentIntersector() = delete;
+
+};
+
+
+} } // namespace ofx::Geo
@@ -0,0 +1,208 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "ofx/Geo/Coordinate.h"
+#include "ofx/Geo/CoordinateBounds.h"
+#include "ofx/Geo/Executor.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+/// \brief A uniform latitude / longitude grid of moving objects.
+///
+/// Objects are identified by the caller's ids and bucketed by quantized
+/// Coordinate. Insert, move and remove are expected O(1) for bounded cell
+/// occupancy, so objects that move every update never trigger a rebuild.
+///
+/// Buckets and the id table are split into independently locked shards,
+/// so any number of threads may insert, move, remove and query at once.
+/// Each id's updates are serialized; queries see every object either at
+/// its old or its new position.
+class SpatialHash
+{
+public:
+    /// \brief Create a SpatialHash.
+    /// \param cellSize The size of a grid cell in degrees.
+    /// \param numShards The number of independently locked shards.
+    SpatialHash(double cellSize = DEFAULT_CELL_SIZE,
+                std::size_t numShards = DEFAULT_NUM_SHARDS);
+
+    /// \brief Destroy the SpatialHash.
+    virtual ~SpatialHash();
+
+    /// \brief Add an object.
+    /// \param id The object's id.
+    /// \param coordinate The object's location.
+    /// \returns false if the id is already present.
+    bool insert(std::size_t id, const Coordinate& coordinate);
+
+    /// \brief Move an object.
+    /// \param id The object's id.
+    /// \param coordinate The object's new location.
+    /// \returns false if the id is not present.
+    bool move(std::size_t id, const Coordinate& coordinate);
+
+    /// \brief Move or insert many objects on an Executor.
+    /// \param ids The array of size ids, which must be distinct.
+    /// \param coordinates The array of size new locations.
+    /// \param size The number of objects.
+    /// \param executor The Executor used to run the updates.
+    void update(const std::size_t* ids,
+                const Coordinate* coordinates,
+                std::size_t size,
+                const Executor& executor = Executor::serial());
+
+    /// \brief Remove an object.
+    /// \param id The object's id.
+    /// \returns false if the id is not present.
+    bool remove(std::size_t id);
+
+    /// \brief Get an object's location.
+    /// \param id The object's id.
+    /// \param coordinate The output location.
+    /// \returns false if the id is not present.
+    bool getCoordinate(std::size_t id, Coordinate& coordinate) const;
+
+    /// \brief Determine if an object is present.
+    /// \param id The object's id.
+    /// \returns true if the id is present.
+    bool contains(std::size_t id) const;
+
+    /// \brief Find the objects within a distance of a location.
+    ///
+    /// Candidates from the cells overlapping the circle are refined with
+    /// GeoUtils::distanceHaversine(). Circles crossing the antimeridian or
+    /// containing a pole are handled.
+    ///
+    /// \param center The center of the search.
+    /// \param radius The search radius in kilometers.
+    /// \param ids The vector the ids of the matching objects are appended to.
+    /// \returns the number of ids appended.
+    std::size_t query(const Coordinate& center,
+                      double radius,
+                      std::vector<std::size_t>& ids) const;
+
+    /// \brief Find the objects inside a region.
+    /// \param bounds The region to search.
+    /// \param ids The vector the ids of the matching objects are appended to.
+    /// \returns the number of ids appended.
+    std::size_t query(const CoordinateBounds& bounds,
+                      std::vector<std::size_t>& ids) const;
+
+    /// \brief Remove all objects.
+    void clear();
+
+    /// \returns the number of objects.
+    std::size_t size() const;
+
+    /// \returns the size of a grid cell in degrees.
+    double getCellSize() const;
+
+    /// \returns the number of shards.
+    std::size_t getNumShards() const;
+
+    /// \brief The default cell size, about 1.1 km of latitude.
+    static const double DEFAULT_CELL_SIZE;
+
+    /// \brief The default number of shards.
+    static const std::size_t DEFAULT_NUM_SHARDS;
+
+private:
+    /// \brief An object in a bucket.
+    struct Entry
+    {
+        std::size_t id;
+        double latitude;
+        double longitude;
+    };
+
+    /// \brief An object in the id table.
+    struct Record
+    {
+        double latitude;
+        double longitude;
+        uint64_t key;
+    };
+
+    /// \brief A locked group of buckets.
+    struct BucketShard
+    {
+        mutable std::mutex mutex;
+        std::unordered_map<uint64_t, std::vector<Entry>> buckets;
+    };
+
+    /// \brief A locked part of the id table.
+    struct RecordShard
+    {
+        mutable std::mutex mutex;
+        std::unordered_map<std::size_t, Record> records;
+    };
+
+    /// \returns the cell row of a latitude.
+    int64_t _row(double latitude) const;
+
+    /// \returns the cell column of a longitude.
+    int64_t _column(double longitude) const;
+
+    /// \returns the bucket key of a cell.
+    static uint64_t _key(int64_t row, int64_t column);
+
+    /// \returns the bucket shard of a key.
+    BucketShard& _bucketShard(uint64_t key) const;
+
+    /// \returns the id table shard of an id.
+    RecordShard& _recordShard(std::size_t id) const;
+
+    /// \brief Append the matching entries of one cell.
+    template <typename Predicate>
+    void _scan(uint64_t key,
+               const Predicate& predicate,
+               std::vector<std::size_t>& ids) const;
+
+    /// \brief Scan the cells in a latitude and longitude range.
+    ///
+    /// Longitudes outside [-180, 180] wrap across the antimeridian.
+    template <typename Predicate>
+    void _scan(double minLatitude,
+               double maxLatitude,
+               double minLongitude,
+               double maxLongitude,
+               const Predicate& predicate,
+               std::vector<std::size_t>& ids) const;
+
+    /// \brief The cell size in degrees.
+    double _cellSize = DEFAULT_CELL_SIZE;
+
+    /// \brief The number of cell rows.
+    int64_t _numRows = 0;
+
+    /// \brief The number of cell columns.
+    int64_t _numColumns = 0;
+
+    /// \brief The bucket shards.
+    mutable std::vector<BucketShard> _bucketShards;
+
+    /// \brief The id table shards.
+    mutable std::vector<RecordShard> _recordShards;
+
+    /// \brief The number of non-empty buckets across all shards.
+    std::atomic<std::size_t> _numBuckets{ 0 };
+
+};
+
+
+} } // namespace ofx::Geo
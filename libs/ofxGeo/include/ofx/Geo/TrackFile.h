@@ -0,0 +1,354 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ofx/Geo/Coordinate.h"
+#include "ofx/Geo/CoordinateBounds.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+/// \brief Constants and records describing the binary track file format.
+///
+/// A track file stores a sequence of points with latitude, longitude,
+/// elevation and time. All values are little endian; files are written by
+/// copying native structs and doubles, so they can only be read and written
+/// on little endian hosts, and open() fails elsewhere.
+///
+///     Header      64 bytes, see TrackFile::Header.
+///     Chunk 0     Columns of latitude, longitude, elevation and time.
+///     ...
+///     Chunk N-1
+///     Index       numChunks TrackFile::ChunkInfo records.
+///
+/// Uncompressed chunks store each column as an array of doubles, so they can
+/// be used in place from a memory mapping. Compressed chunks store each
+/// column with CoordinateCodec::encodeColumn() using the fixed-point scales
+/// below. Every chunk and the index start on an 8 byte boundary.
+///
+/// The chunk index stores the bounds and time range of each chunk so that
+/// readers can skip chunks without touching their pages.
+class TrackFile
+{
+public:
+    /// \brief File flags.
+    enum Flags: std::uint32_t
+    {
+        /// \brief Chunks use delta + varint compression.
+        COMPRESSED = 1
+    };
+
+    /// \brief The file header.
+    struct Header
+    {
+        /// \brief The file magic, equal to TrackFile::MAGIC.
+        char magic[8];
+
+        /// \brief The file format version.
+        std::uint32_t version;
+
+        /// \brief A combination of TrackFile::Flags.
+        std::uint32_t flags;
+
+        /// \brief The total number of points.
+        std::uint64_t numPoints;
+
+        /// \brief The number of chunks.
+        std::uint64_t numChunks;
+
+        /// \brief The byte offset of the chunk index.
+        std::uint64_t indexOffset;
+
+        /// \brief The maximum number of points per chunk.
+        std::uint32_t chunkSize;
+
+        /// \brief Reserved, set to zero.
+        std::uint32_t reserved0;
+
+        /// \brief Reserved, set to zero.
+        std::uint64_t reserved1[2];
+    };
+
+    /// \brief A chunk index record.
+    struct ChunkInfo
+    {
+        /// \brief The byte offset of the chunk.
+        std::uint64_t offset;
+
+        /// \brief The size of the chunk in bytes.
+        std::uint64_t byteSize;
+
+        /// \brief The number of points in the chunk.
+        std::uint32_t numPoints;
+
+        /// \brief Reserved, set to zero.
+        std::uint32_t reserved;
+
+        /// \brief The minimum latitude in degrees.
+        double minLatitude;
+
+        /// \brief The maximum latitude in degrees.
+        double maxLatitude;
+
+        /// \brief The western longitude in degrees.
+        ///
+        /// Greater than maxLongitude when the chunk crosses the antimeridian.
+        double minLongitude;
+
+        /// \brief The eastern longitude in degrees.
+        double maxLongitude;
+
+        /// \brief The minimum time in seconds.
+        double minTime;
+
+        /// \brief The maximum time in seconds.
+        double maxTime;
+
+        /// \returns the bounds of the chunk's coordinates.
+        CoordinateBounds getBounds() const;
+
+    };
+
+    /// \brief The file magic.
+    static const char MAGIC[8];
+
+    /// \brief The current file format version. Version 2 compresses chunks
+    ///     with group varints; version 1 files used LEB128 varints.
+    static const std::uint32_t VERSION;
+
+    /// \brief The default maximum number of points per chunk.
+    static const std::size_t DEFAULT_CHUNK_SIZE;
+
+    /// \brief Fixed-point scale of compressed latitudes and longitudes (1e7, ~1 cm).
+    static const double COORDINATE_SCALE;
+
+    /// \brief Fixed-point scale of compressed elevations (1e3, 1 mm).
+    static const double ELEVATION_SCALE;
+
+    /// \brief Fixed-point scale of compressed times (1e3, 1 ms).
+    static const double TIME_SCALE;
+
+private:
+    TrackFile() = delete;
+    ~TrackFile() = delete;
+
+};
+
+
+/// \brief A read-only view of a chunk of track points stored as columns.
+///
+/// A view does not own its data. Views returned by TrackFileReader point
+/// directly into the memory mapped file for uncompressed chunks.
+class TrackChunkView
+{
+public:
+    /// \brief Create an empty TrackChunkView.
+    TrackChunkView();
+
+    /// \brief Create a TrackChunkView of existing columns.
+    /// \param latitudes The latitudes in degrees.
+    /// \param longitudes The longitudes in degrees.
+    /// \param elevations The elevations in meters.
+    /// \param times The times in seconds.
+    /// \param size The number of points in each column.
+    TrackChunkView(const double* latitudes,
+                   const double* longitudes,
+                   const double* elevations,
+                   const double* times,
+                   std::size_t size);
+
+    /// \returns the number of points.
+    std::size_t size() const;
+
+    /// \returns true if there are no points.
+    bool empty() const;
+
+    /// \returns a pointer to the latitude column in degrees.
+    const double* getLatitudes() const;
+
+    /// \returns a pointer to the longitude column in degrees.
+    const double* getLongitudes() const;
+
+    /// \returns a pointer to the elevation column in meters.
+    const double* getElevations() const;
+
+    /// \returns a pointer to the time column in seconds.
+    const double* getTimes() const;
+
+    /// \brief Get a point's Coordinate.
+    /// \param index The point index.
+    /// \returns the Coordinate.
+    Coordinate getCoordinate(std::size_t index) const;
+
+    /// \brief Get a point's ElevatedCoordinate.
+    /// \param index The point index.
+    /// \returns the ElevatedCoordinate.
+    ElevatedCoordinate getElevatedCoordinate(std::size_t index) const;
+
+    /// \brief Get a point's time.
+    /// \param index The point index.
+    /// \returns the time in seconds.
+    double getTime(std::size_t index) const;
+
+    /// \returns the bounds of the view's coordinates.
+    CoordinateBounds getBounds() const;
+
+    /// \returns the haversine length of the path through the points in kilometers.
+    double getLength() const;
+
+private:
+    const double* _latitudes = nullptr;
+    const double* _longitudes = nullptr;
+    const double* _elevations = nullptr;
+    const double* _times = nullptr;
+    std::size_t _size = 0;
+
+};
+
+
+/// \brief Write points to a track file.
+class TrackFileWriter
+{
+public:
+    /// \brief Create an unopened TrackFileWriter.
+    TrackFileWriter();
+
+    /// \brief Destroy the TrackFileWriter, closing the file if needed.
+    virtual ~TrackFileWriter();
+
+    /// \brief Open a file for writing, replacing any existing file.
+    /// \param path The file path.
+    /// \param compressed True if chunks should be compressed.
+    /// \param chunkSize The maximum number of points per chunk.
+    /// \returns true if the file was opened.
+    bool open(const std::string& path,
+              bool compressed = false,
+              std::size_t chunkSize = TrackFile::DEFAULT_CHUNK_SIZE);
+
+    /// \brief Add a point.
+    /// \param coordinate The location.
+    /// \param time The time in seconds.
+    void add(const ElevatedCoordinate& coordinate, double time);
+
+    /// \brief Add a point.
+    /// \param latitude The latitude in degrees.
+    /// \param longitude The longitude in degrees.
+    /// \param elevation The elevation in meters.
+    /// \param time The time in seconds.
+    void add(double latitude, double longitude, double elevation, double time);
+
+    /// \brief Write the remaining points, the index and the header.
+    /// \returns true if the file was written successfully.
+    bool close();
+
+    /// \returns true if the file is open.
+    bool isOpen() const;
+
+private:
+    /// \brief Write the buffered points as a chunk.
+    void _flush();
+
+    /// \brief Write zero bytes until the stream is 8 byte aligned.
+    void _pad();
+
+    std::ofstream _stream;
+    bool _compressed = false;
+    std::size_t _chunkSize = TrackFile::DEFAULT_CHUNK_SIZE;
+    std::uint64_t _numPoints = 0;
+
+    std::vector<double> _latitudes;
+    std::vector<double> _longitudes;
+    std::vector<double> _elevations;
+    std::vector<double> _times;
+    std::vector<std::uint8_t> _encoded;
+    std::vector<TrackFile::ChunkInfo> _index;
+
+};
+
+
+/// \brief Read a track file using a read-only memory mapping.
+///
+/// Opening a file maps it, but only the header and index are read. Chunk
+/// pages are touched only when a chunk is requested, so chunks rejected by
+/// their index bounds are never loaded.
+class TrackFileReader
+{
+public:
+    /// \brief Create an unopened TrackFileReader.
+    TrackFileReader();
+
+    /// \brief Destroy the TrackFileReader, unmapping the file.
+    virtual ~TrackFileReader();
+
+    /// \brief Open and map a track file.
+    /// \param path The file path.
+    /// \returns true if the file was mapped and its header and index are valid.
+    bool open(const std::string& path);
+
+    /// \brief Unmap the file.
+    ///
+    /// Views into uncompressed chunks are invalid after the file is closed.
+    void close();
+
+    /// \returns true if the file is open.
+    bool isOpen() const;
+
+    /// \returns true if chunks are compressed.
+    bool isCompressed() const;
+
+    /// \returns the total number of points.
+    std::uint64_t getNumPoints() const;
+
+    /// \returns the number of chunks.
+    std::size_t getNumChunks() const;
+
+    /// \brief Get a chunk's index record.
+    /// \param index The chunk index.
+    /// \returns the chunk's index record.
+    const TrackFile::ChunkInfo& getChunkInfo(std::size_t index) const;
+
+    /// \brief Get a view of a chunk's points.
+    ///
+    /// Uncompressed chunks are returned without copying. Compressed chunks
+    /// are decoded into buffer, which must outlive the view.
+    ///
+    /// \param index The chunk index.
+    /// \param buffer The buffer used to decode compressed chunks.
+    /// \returns a view of the chunk, or an empty view if the chunk is invalid.
+    TrackChunkView getChunk(std::size_t index,
+                            std::vector<double>& buffer) const;
+
+    /// \brief Find the chunks whose bounds intersect the given bounds.
+    /// \param bounds The bounds to test.
+    /// \returns the indices of the intersecting chunks in file order.
+    std::vector<std::size_t> findChunks(const CoordinateBounds& bounds) const;
+
+private:
+    struct Mapping;
+
+    /// \brief The platform memory mapping.
+    std::unique_ptr<Mapping> _mapping;
+
+    /// \brief The mapped file header.
+    const TrackFile::Header* _header = nullptr;
+
+    /// \brief The mapped chunk index.
+    const TrackFile::ChunkInfo* _index = nullptr;
+
+};
+
+
+} } // namespace ofx::Geo
@@ -0,0 +1,341 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include <vector>
+#include "ofVectorMath.h"
+#include "ofx/Geo/Coordinate.h"
+#include "ofx/Geo/LocalTangentPlane.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+/// \brief A position fix with a time.
+struct TrackFix
+{
+    /// \brief The position.
+    ElevatedCoordinate coordinate;
+
+    /// \brief The time in seconds.
+    double time;
+
+};
+
+
+/// \brief Rejects fixes that imply an impossible speed.
+///
+/// Each fix is compared with the last accepted fix. Fixes that would require
+/// a ground speed above the limit are rejected and do not become the new
+/// reference.
+class SpeedGateFilter
+{
+public:
+    /// \brief Create a SpeedGateFilter.
+    /// \param maxSpeed The maximum plausible speed in meters per second.
+    SpeedGateFilter(double maxSpeed = DEFAULT_MAX_SPEED);
+
+    /// \brief Destroy the SpeedGateFilter.
+    virtual ~SpeedGateFilter();
+
+    /// \brief Test a fix and make it the reference if accepted.
+    /// \param coordinate The position.
+    /// \param time The time in seconds.
+    /// \returns true if the fix is accepted.
+    bool accept(const ElevatedCoordinate& coordinate, double time);
+
+    /// \brief Forget the reference fix.
+    void reset();
+
+    /// \brief Set the maximum plausible speed.
+    /// \param maxSpeed The maximum plausible speed in meters per second.
+    void setMaxSpeed(double maxSpeed);
+
+    /// \returns the maximum plausible speed in meters per second.
+    double getMaxSpeed() const;
+
+    /// \brief The default maximum speed, 100 meters per second.
+    static const double DEFAULT_MAX_SPEED;
+
+private:
+    double _maxSpeed = DEFAULT_MAX_SPEED;
+    bool _hasReference = false;
+    TrackFix _reference;
+
+};
+
+
+/// \brief A constant-velocity Kalman filter in a local tangent plane.
+///
+/// East, north and up are filtered as independent position / velocity pairs
+/// in a LocalTangentPlane anchored at the first fix. The plane is re-anchored
+/// when the estimate moves more than REANCHOR_DISTANCE from its origin, so
+/// the filter can follow arbitrarily long tracks. Each update is a fixed
+/// number of arithmetic operations and does not allocate.
+class KalmanTrackFilter
+{
+public:
+    /// \brief The position / velocity estimate of one axis.
+    struct Axis
+    {
+        /// \brief The position in meters.
+        double position;
+
+        /// \brief The velocity in meters per second.
+        double velocity;
+
+        /// \brief The position variance.
+        double p00;
+
+        /// \brief The position / velocity covariance.
+        double p01;
+
+        /// \brief The velocity variance.
+        double p11;
+    };
+
+    /// \brief The estimate of all axes at a time.
+    struct State
+    {
+        /// \brief The time in seconds.
+        double time;
+
+        /// \brief The east, north and up axes.
+        Axis axes[3];
+    };
+
+    /// \brief Create a KalmanTrackFilter.
+    /// \param accelerationNoise The process noise spectral density in m^2/s^3.
+    /// \param horizontalAccuracy The default horizontal fix accuracy (1 sigma) in meters.
+    /// \param verticalAccuracy The default vertical fix accuracy (1 sigma) in meters.
+    KalmanTrackFilter(double accelerationNoise = DEFAULT_ACCELERATION_NOISE,
+                      double horizontalAccuracy = DEFAULT_HORIZONTAL_ACCURACY,
+                      double verticalAccuracy = DEFAULT_VERTICAL_ACCURACY);
+
+    /// \brief Destroy the KalmanTrackFilter.
+    virtual ~KalmanTrackFilter();
+
+    /// \brief Update the estimate with a fix using the default accuracies.
+    /// \param coordinate The measured position.
+    /// \param time The time in seconds.
+    void update(const ElevatedCoordinate& coordinate, double time);
+
+    /// \brief Update the estimate with a fix.
+    /// \param coordinate The measured position.
+    /// \param time The time in seconds.
+    /// \param horizontalAccuracy The horizontal accuracy (1 sigma) in meters.
+    /// \param verticalAccuracy The vertical accuracy (1 sigma) in meters.
+    void update(const ElevatedCoordinate& coordinate,
+                double time,
+                double horizontalAccuracy,
+                double verticalAccuracy);
+
+    /// \brief Forget the estimate.
+    void reset();
+
+    /// \returns true if at least one fix has been used.
+    bool isInitialized() const;
+
+    /// \returns the current estimate as a TrackFix.
+    TrackFix getFix() const;
+
+    /// \brief Convert a state to a TrackFix using the current plane.
+    /// \param state The state to convert.
+    /// \returns the state's position and time.
+    TrackFix toFix(const State& state) const;
+
+    /// \returns the current east, north and up velocity in meters per second.
+    glm::dvec3 getVelocity() const;
+
+    /// \returns the estimate after the last update.
+    const State& getState() const;
+
+    /// \returns the prediction made before the last update.
+    const State& getPredictedState() const;
+
+    /// \returns the plane that states are expressed in.
+    const LocalTangentPlane& getPlane() const;
+
+    /// \brief Get the change of plane made by the last update.
+    ///
+    /// When the plane is re-anchored, positions in the old plane must have
+    /// this offset subtracted to be expressed in the new plane.
+    ///
+    /// \returns the east / north offset in meters, or zero.
+    const glm::dvec2& getLastOriginShift() const;
+
+    /// \brief The default process noise, 1 m^2/s^3.
+    static const double DEFAULT_ACCELERATION_NOISE;
+
+    /// \brief The default horizontal accuracy, 5 meters.
+    static const double DEFAULT_HORIZONTAL_ACCURACY;
+
+    /// \brief The default vertical accuracy, 10 meters.
+    static const double DEFAULT_VERTICAL_ACCURACY;
+
+    /// \brief The initial velocity uncertainty (1 sigma), 50 meters per second.
+    static const double INITIAL_VELOCITY_ACCURACY;
+
+    /// \brief The distance from the origin that triggers re-anchoring, 10 km.
+    static const double REANCHOR_DISTANCE;
+
+private:
+    double _accelerationNoise = DEFAULT_ACCELERATION_NOISE;
+    double _horizontalAccuracy = DEFAULT_HORIZONTAL_ACCURACY;
+    double _verticalAccuracy = DEFAULT_VERTICAL_ACCURACY;
+    bool _initialized = false;
+    LocalTangentPlane _plane;
+    State _state;
+    State _predicted;
+    glm::dvec2 _lastOriginShift;
+
+};
+
+
+/// \brief A fixed-lag Rauch-Tung-Striebel smoother over a KalmanTrackFilter.
+///
+/// The last lag + 1 filter states are kept in a ring buffer allocated at
+/// construction. Each new fix runs a backward pass over the buffer and emits
+/// the smoothed fix from lag updates ago, so output latency is bounded by the
+/// lag.
+class FixedLagSmoother
+{
+public:
+    /// \brief Create a FixedLagSmoother.
+    /// \param lag The number of fixes to delay output by.
+    /// \param filter The filter settings to use.
+    FixedLagSmoother(std::size_t lag = DEFAULT_LAG,
+                     const KalmanTrackFilter& filter = KalmanTrackFilter());
+
+    /// \brief Destroy the FixedLagSmoother.
+    virtual ~FixedLagSmoother();
+
+    /// \brief Add a fix.
+    /// \param coordinate The measured position.
+    /// \param time The time in seconds.
+    /// \param output The smoothed fix from lag fixes ago, if available.
+    /// \returns true if output was set.
+    bool update(const ElevatedCoordinate& coordinate,
+                double time,
+                TrackFix& output);
+
+    /// \brief Emit the next buffered fix at the end of a stream.
+    /// \param output The next smoothed fix, if available.
+    /// \returns true if output was set.
+    bool flush(TrackFix& output);
+
+    /// \brief Forget all buffered fixes and the filter estimate.
+    void reset();
+
+    /// \returns the lag in fixes.
+    std::size_t getLag() const;
+
+    /// \returns the underlying filter.
+    const KalmanTrackFilter& getFilter() const;
+
+    /// \brief The default lag, 5 fixes.
+    static const std::size_t DEFAULT_LAG;
+
+private:
+    struct Entry
+    {
+        KalmanTrackFilter::State filtered;
+        KalmanTrackFilter::State predicted;
+    };
+
+    /// \brief Run the backward pass and get the smoothed oldest state.
+    KalmanTrackFilter::State _smoothOldest() const;
+
+    /// \brief Get an entry by age, 0 being the oldest.
+    const Entry& _entry(std::size_t age) const;
+
+    std::size_t _lag = DEFAULT_LAG;
+    KalmanTrackFilter _filter;
+    std::vector<Entry> _entries;
+    std::size_t _head = 0;
+    std::size_t _count = 0;
+
+};
+
+
+/// \brief Settings for a TrackFilter.
+struct TrackFilterSettings
+{
+    /// \brief True if fixes should be speed gated.
+    bool useSpeedGate = true;
+
+    /// \brief The speed gate limit in meters per second.
+    double maxSpeed = SpeedGateFilter::DEFAULT_MAX_SPEED;
+
+    /// \brief True if fixes should be Kalman filtered.
+    bool useKalmanFilter = true;
+
+    /// \brief The process noise spectral density in m^2/s^3.
+    double accelerationNoise = KalmanTrackFilter::DEFAULT_ACCELERATION_NOISE;
+
+    /// \brief The horizontal fix accuracy (1 sigma) in meters.
+    double horizontalAccuracy = KalmanTrackFilter::DEFAULT_HORIZONTAL_ACCURACY;
+
+    /// \brief The vertical fix accuracy (1 sigma) in meters.
+    double verticalAccuracy = KalmanTrackFilter::DEFAULT_VERTICAL_ACCURACY;
+
+    /// \brief The smoother lag in fixes, or 0 for no smoothing.
+    ///
+    /// Smoothing requires the Kalman filter.
+    std::size_t smootherLag = 0;
+};
+
+
+/// \brief A streaming GPS cleaning stage.
+///
+/// Fixes pass through an optional SpeedGateFilter, then an optional
+/// KalmanTrackFilter, optionally followed by a FixedLagSmoother. A
+/// TrackFilter holds a few hundred bytes of state plus the smoother's buffer
+/// and does not allocate per fix, so one thread can run many vehicle streams.
+class TrackFilter
+{
+public:
+    /// \brief Create a TrackFilter.
+    /// \param settings The settings to use.
+    TrackFilter(const TrackFilterSettings& settings = TrackFilterSettings());
+
+    /// \brief Destroy the TrackFilter.
+    virtual ~TrackFilter();
+
+    /// \brief Process a fix.
+    /// \param coordinate The measured position.
+    /// \param time The time in seconds.
+    /// \param output The cleaned fix, if one is emitted.
+    /// \returns true if output was set.
+    bool process(const ElevatedCoordinate& coordinate,
+                 double time,
+                 TrackFix& output);
+
+    /// \brief Emit the next buffered fix at the end of a stream.
+    /// \param output The next cleaned fix, if available.
+    /// \returns true if output was set.
+    bool flush(TrackFix& output);
+
+    /// \brief Forget all state.
+    void reset();
+
+    /// \returns the settings.
+    const TrackFilterSettings& getSettings() const;
+
+private:
+    TrackFilterSettings _settings;
+    SpeedGateFilter _speedGate;
+    KalmanTrackFilter _kalmanFilter;
+    FixedLagSmoother _smoother;
+
+};
+
+
+} } // namespace ofx::Geo
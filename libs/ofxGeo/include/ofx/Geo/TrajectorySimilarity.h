@@ -0,0 +1,144 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include "ofx/Geo/CoordinatePolyline.h"
+#include "ofx/Geo/Executor.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+/// \brief Distances between trajectories for matching and clustering routes.
+///
+/// Vertices are projected onto a LocalTangentPlane centered on the bounds of
+/// both polylines, so distances are in meters, cost a few multiplications
+/// per vertex pair and do not depend on the order of the polylines. The
+/// projection's error grows with the square of the distance from the
+/// center; see LocalTangentPlane.
+///
+/// Each measure takes a threshold. The exact distance is returned when it is
+/// at most the threshold; otherwise the computation may stop early and
+/// return infinity. Before the O(n m) comparison, pairs are rejected with
+/// lower bounds from the end points and bounding boxes. Dynamic programs keep
+/// two rows, so memory is linear in the length of the second polyline.
+///
+/// Empty polylines have an infinite distance to everything.
+class TrajectorySimilarity
+{
+public:
+    /// \brief The available similarity measures.
+    enum Measure
+    {
+        /// \brief The discrete Fréchet distance.
+        FRECHET,
+        /// \brief The symmetric Hausdorff distance.
+        HAUSDORFF,
+        /// \brief The dynamic time warping distance, a sum of matched distances.
+        DYNAMIC_TIME_WARPING
+    };
+
+    /// \brief Get the discrete Fréchet distance between two polylines.
+    ///
+    /// This is the shortest leash that lets two walkers traverse the
+    /// polylines vertex by vertex without moving backward.
+    ///
+    /// \param polyline0 The first polyline.
+    /// \param polyline1 The second polyline.
+    /// \param threshold The largest distance of interest in meters.
+    /// \returns the distance in meters, or infinity if it exceeds threshold.
+    static double frechet(const CoordinatePolyline& polyline0,
+                          const CoordinatePolyline& polyline1,
+                          double threshold = NO_THRESHOLD);
+
+    /// \brief Get the Hausdorff distance between the vertices of two polylines.
+    ///
+    /// This is the greatest distance from a vertex of either polyline to the
+    /// nearest vertex of the other. Vertex order is ignored.
+    ///
+    /// \param polyline0 The first polyline.
+    /// \param polyline1 The second polyline.
+    /// \param threshold The largest distance of interest in meters.
+    /// \returns the distance in meters, or infinity if it exceeds threshold.
+    static double hausdorff(const CoordinatePolyline& polyline0,
+                            const CoordinatePolyline& polyline1,
+                            double threshold = NO_THRESHOLD);
+
+    /// \brief Get the dynamic time warping distance between two polylines.
+    ///
+    /// This is the smallest sum of distances over an alignment that matches
+    /// every vertex of each polyline to at least one vertex of the other in
+    /// order.
+    ///
+    /// \param polyline0 The first polyline.
+    /// \param polyline1 The second polyline.
+    /// \param threshold The largest distance of interest in meters.
+    /// \returns the distance in meters, or infinity if it exceeds threshold.
+    static double dynamicTimeWarping(const CoordinatePolyline& polyline0,
+                                     const CoordinatePolyline& polyline1,
+                                     double threshold = NO_THRESHOLD);
+
+    /// \brief Get a distance between two polylines.
+    /// \param measure The measure to use.
+    /// \param polyline0 The first polyline.
+    /// \param polyline1 The second polyline.
+    /// \param threshold The largest distance of interest in meters.
+    /// \returns the distance in meters, or infinity if it exceeds threshold.
+    static double distance(Measure measure,
+                           const CoordinatePolyline& polyline0,
+                           const CoordinatePolyline& polyline1,
+                           double threshold = NO_THRESHOLD);
+
+    /// \brief Get the distances from one polyline to many.
+    ///
+    /// Each pair is projected onto its own plane, so every distance equals
+    /// distance(measure, query, polylines[i], threshold). Each worker reuses
+    /// its buffers.
+    ///
+    /// \param measure The measure to use.
+    /// \param query The query polyline.
+    /// \param polylines The array of size polylines to compare against.
+    /// \param size The number of polylines.
+    /// \param distances The output array of size distances in meters, set to
+    ///     infinity where a distance exceeds threshold.
+    /// \param threshold The largest distance of interest in meters.
+    /// \param executor The Executor used to run the calculation.
+    static void distance(Measure measure,
+                         const CoordinatePolyline& query,
+                         const CoordinatePolyline* polylines,
+                         std::size_t size,
+                         double* distances,
+                         double threshold = NO_THRESHOLD,
+                         const Executor& executor = Executor::serial());
+
+    /// \brief Get a cheap lower bound of a distance between two polylines.
+    ///
+    /// The bound uses the end points and the gap between the bounding boxes
+    /// and costs one pass over the vertices.
+    ///
+    /// \param measure The measure to bound.
+    /// \param polyline0 The first polyline.
+    /// \param polyline1 The second polyline.
+    /// \returns the lower bound in meters.
+    static double lowerBound(Measure measure,
+                             const CoordinatePolyline& polyline0,
+                             const CoordinatePolyline& polyline1);
+
+    /// \brief A threshold that never abandons a computation.
+    static const double NO_THRESHOLD;
+
+private:
+    TrajectorySimilarity() = delete;
+    ~TrajectorySimilarity() = delete;
+
+};
+
+
+} } // namespace ofx::Geo
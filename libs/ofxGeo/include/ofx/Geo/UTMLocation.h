@@ -17,6 +17,39 @@ namespace ofx {
 namespace Geo {
 
 
+/// \brief A plain UTM position with a numeric zone.
+///
+/// Unlike UTMLocation, a UTMPoint owns no heap memory and can be copied,
+/// stored in arrays and produced from many threads at once.
+///
+/// \sa GeoUtils::toUTMPoint()
+struct UTMPoint
+{
+    /// \brief The hemispheres used to select the UTM false northing.
+    enum Hemisphere: char
+    {
+        NORTHERN = 'N',
+        SOUTHERN = 'S'
+    };
+
+    /// \brief The easting in meters.
+    double easting;
+
+    /// \brief The northing in meters.
+    double northing;
+
+    /// \brief The UTM zone number (1 - 60).
+    int zoneNumber;
+
+    /// \brief The UTM latitude band letter, 'Z' if outside of 80S to 84N.
+    char band;
+
+    /// \brief The hemisphere of the location.
+    Hemisphere hemisphere;
+
+};
+
+
 /// \brief Defines a location in Universal Transverse Mercator (UTM) space.
 /// \sa http://en.wikipedia.org/wiki/Universal_Transverse_Mercator_coordinate_system
 class UTMLocation: public glm::dvec2
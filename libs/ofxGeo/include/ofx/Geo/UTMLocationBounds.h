@@ -8,6 +8,7 @@
 #pragma once
 
 
+#include <cstdint>
 #include <iostream>
 #include "ofx/Geo/UTMLocation.h"
 
@@ -16,7 +17,17 @@ namespace ofx {
 namespace Geo {
 
 
+class CoordinateBounds;
+
+
 /// \brief A bounding box using UTM Locations.
+///
+/// All extents are stored in the zone of the first location added to the
+/// bounds (the reference zone). Locations from other zones or hemispheres
+/// are reprojected into the reference zone before they are used, so the
+/// bounds stay a single metric rectangle. Accuracy of the transverse
+/// mercator projection decreases with distance from the reference zone, so
+/// bounds should not span more than a few neighbouring zones.
 class UTMLocationBounds
 {
 public:
@@ -28,33 +39,181 @@ public:
     /// \param southeast The southeast location of the UTMLocationBounds.
     UTMLocationBounds(const UTMLocation& northwest, const UTMLocation& southeast);
 
+    /// \brief Create UTMLocationBounds from CoordinateBounds.
+    ///
+    /// The bounds are projected into the zone of their center. The edges of
+    /// the CoordinateBounds are curved in UTM space, so they are sampled to
+    /// find the enclosing UTM rectangle. Empty bounds give empty bounds.
+    ///
+    /// \param bounds The CoordinateBounds to project.
+    UTMLocationBounds(const CoordinateBounds& bounds);
+
     /// \brief Destroy the UTMLocationBounds.
     virtual ~UTMLocationBounds();
 
+    /// \brief Expand the bounds to incorporate the given location.
+    /// \param location The location to use for expansion.
+    void growToInclude(const UTMLocation& location);
+
+    /// \brief Expand the bounds to incorporate the given bounds.
+    /// \param bounds The bounds to use for expansion.
+    void growToInclude(const UTMLocationBounds& bounds);
+
+    /// \brief Determine if the location is inside of the bounds.
+    /// \param location The location to test.
+    /// \returns true if the location is inside or on the edge of the bounds.
+    bool contains(const UTMLocation& location) const;
+
+    /// \brief Determine if a position in the reference zone is inside of the bounds.
+    /// \param easting The easting in meters in the reference zone.
+    /// \param northing The northing in meters in the reference zone.
+    /// \returns true if the position is inside or on the edge of the bounds.
+    bool contains(double easting, double northing) const;
+
+    /// \brief Test many positions in the reference zone for containment.
+    ///
+    /// The test is branch-free so that it can be vectorized by the compiler.
+    ///
+    /// \param eastings The array of size eastings in meters.
+    /// \param northings The array of size northings in meters.
+    /// \param size The number of positions to test.
+    /// \param results The output array of size results, 1 if contained, 0 otherwise.
+    /// \returns the number of contained positions.
+    std::size_t contains(const double* eastings,
+                         const double* northings,
+                         std::size_t size,
+                         std::uint8_t* results) const;
+
+    /// \brief Determine if the bounds overlap.
+    /// \param bounds The bounds to test.
+    /// \returns true if the bounds share any area or edge.
+    bool intersects(const UTMLocationBounds& bounds) const;
+
+    /// \returns true if no locations have been added to the bounds.
+    bool isEmpty() const;
+
+    /// \returns the east-west extent in meters.
+    double getWidth() const;
+
+    /// \returns the north-south extent in meters.
+    double getHeight() const;
+
+    /// \returns the area in square meters.
+    double getArea() const;
+
+    /// \returns the reference zone id, e.g. "33T".
+    const std::string& getZone() const;
+
     /// \brief Get the northwest corner of the UTMLocationBounds.
     /// \returns the northwest corner of the UTMLocationBounds.
-    const UTMLocation& getNorthwest() const;
+    UTMLocation getNorthwest() const;
 
     /// \brief Set the northwest corner of the UTMLocationBounds.
+    ///
+    /// The bounds span the new corner and the southeast corner; if the new
+    /// corner is south or east of it, the extents are swapped.
+    ///
     /// \param northwest The northwest corner of the UTMLocationBounds.
     void setNorthwest(const UTMLocation& northwest);
 
     /// \brief Get the southeast corner of the UTMLocationBounds.
     /// \returns the southeast corner of the UTMLocationBounds.
-    const UTMLocation& getSoutheast() const;
+    UTMLocation getSoutheast() const;
 
     /// \brief Set the southeast corner of the UTMLocationBounds.
-    /// \param northwest The southeast corner of the UTMLocationBounds.
+    ///
+    /// The bounds span the new corner and the northwest corner; if the new
+    /// corner is north or west of it, the extents are swapped.
+    ///
+    /// \param southeast The southeast corner of the UTMLocationBounds.
     void setSoutheast(const UTMLocation& southeast);
 
+    /// \returns the southwest corner of the UTMLocationBounds.
+    UTMLocation getSouthwest() const;
+
+    /// \returns the northeast corner of the UTMLocationBounds.
+    UTMLocation getNortheast() const;
+
+    /// \brief Convert the bounds to CoordinateBounds.
+    ///
+    /// The edges of the bounds are curved in geographic space, so they are
+    /// sampled to find the enclosing CoordinateBounds.
+    ///
+    /// \returns the enclosing CoordinateBounds.
+    CoordinateBounds toCoordinateBounds() const;
+
+    /// \brief Get the bounds as a string.
+    /// \returns the southwest and northeast corners as a string.
+    std::string toString() const;
+
+    /// \brief Stream output.
+    /// \param os the std::ostream.
+    /// \param bounds The UTMLocationBounds to output.
+    /// \returns the updated std::ostream reference.
+    friend std::ostream& operator << (std::ostream& os,
+                                      const UTMLocationBounds& bounds);
+
+    /// \brief The number of samples per edge used when reprojecting bounds.
+    static const std::size_t EDGE_SAMPLES;
+
 private:
-    /// \brief the northwest corner of the UTMLocationBounds.
-    UTMLocation _northwest;
+    /// \brief Convert a location to a UTMPoint in the reference zone.
+    /// \param location The location to convert.
+    /// \returns the location in the reference zone.
+    UTMPoint _toReferenceZone(const UTMLocation& location) const;
+
+    /// \brief Set the reference zone from the location.
+    /// \param location The location to use.
+    void _setReferenceZone(const UTMLocation& location);
+
+    /// \brief Expand the extents by a position in the reference zone.
+    /// \param easting The easting in meters.
+    /// \param northing The northing in meters.
+    void _include(double easting, double northing);
+
+    /// \brief Swap inverted extents so that each minimum is at most its maximum.
+    void _normalize();
 
-    /// \brief the southeast corner of the UTMLocationBounds.
-    UTMLocation _southeast;
+    /// \brief Expand the extents by sampled edges of CoordinateBounds.
+    /// \param bounds The bounds to project into the reference zone.
+    void _include(const CoordinateBounds& bounds);
+
+    /// \brief Create a location in the reference zone.
+    UTMLocation _location(double easting, double northing) const;
+
+    /// \brief True if no locations have been added.
+    bool _unset = true;
+
+    /// \brief The reference zone id.
+    std::string _zone;
+
+    /// \brief The reference zone number.
+    int _zoneNumber = 0;
+
+    /// \brief The reference hemisphere.
+    UTMPoint::Hemisphere _hemisphere = UTMPoint::NORTHERN;
+
+    /// \brief The minimum easting in meters.
+    double _minEasting = 0;
+
+    /// \brief The maximum easting in meters.
+    double _maxEasting = 0;
+
+    /// \brief The minimum northing in meters.
+    double _minNorthing = 0;
+
+    /// \brief The maximum northing in meters.
+    double _maxNorthing = 0;
 
 };
 
 
+inline std::ostream& operator<<(std::ostream& os,
+                                const UTMLocationBounds& bounds)
+{
+    os << bounds.toString();
+    return os;
+}
+
+
 } } // namespace ofx::Geo
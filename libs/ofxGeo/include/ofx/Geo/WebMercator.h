@@ -0,0 +1,184 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include <iostream>
+#include <vector>
+#include "ofVectorMath.h"
+#include "ofx/Geo/Coordinate.h"
+#include "ofx/Geo/CoordinateBounds.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+/// \brief A map tile in the XYZ (slippy map) scheme.
+///
+/// Tile 0, 0 is at the northwest corner of the map; there are 2^zoom tiles
+/// along each axis.
+struct Tile
+{
+    /// \brief The column, increasing eastward.
+    int x;
+
+    /// \brief The row, increasing southward.
+    int y;
+
+    /// \brief The zoom level.
+    int zoom;
+};
+
+
+inline std::ostream& operator << (std::ostream& os, const Tile& tile)
+{
+    os << tile.zoom << "/" << tile.x << "/" << tile.y;
+    return os;
+}
+
+
+/// \brief The spherical Web Mercator projection (EPSG:3857) and tile math.
+///
+/// Unlike GeoUtils::toVec(), the projection is continuous across the whole
+/// map and needs one logarithm per point.
+///
+/// Pixel coordinates are global at a zoom level: x increases eastward from
+/// longitude -180 and y increases southward from MAX_LATITUDE. Latitudes
+/// beyond MAX_LATITUDE are clamped.
+///
+/// \sa https://wiki.openstreetmap.org/wiki/Slippy_map_tilenames
+class WebMercator
+{
+public:
+    /// \brief Project a Coordinate to Web Mercator meters.
+    /// \param coordinate The location.
+    /// \returns the easting and northing in meters.
+    static glm::dvec2 toMeters(const Coordinate& coordinate);
+
+    /// \brief Unproject Web Mercator meters to a Coordinate.
+    /// \param meters The easting and northing in meters.
+    /// \returns the location.
+    static Coordinate fromMeters(const glm::dvec2& meters);
+
+    /// \brief Project a Coordinate to global pixel coordinates.
+    /// \param coordinate The location.
+    /// \param zoom The zoom level, which may be fractional.
+    /// \param tileSize The size of a tile in pixels.
+    /// \returns the pixel coordinates.
+    static glm::dvec2 toPixel(const Coordinate& coordinate,
+                              double zoom,
+                              double tileSize = TILE_SIZE);
+
+    /// \brief Unproject global pixel coordinates to a Coordinate.
+    /// \param pixel The pixel coordinates.
+    /// \param zoom The zoom level, which may be fractional.
+    /// \param tileSize The size of a tile in pixels.
+    /// \returns the location.
+    static Coordinate fromPixel(const glm::dvec2& pixel,
+                                double zoom,
+                                double tileSize = TILE_SIZE);
+
+    /// \brief Get the tile containing a Coordinate.
+    /// \param coordinate The location.
+    /// \param zoom The zoom level in [0, MAX_ZOOM].
+    /// \returns the tile.
+    static Tile toTile(const Coordinate& coordinate, int zoom);
+
+    /// \brief Get the bounds of a tile.
+    /// \param tile The tile.
+    /// \returns the bounds.
+    static CoordinateBounds getBounds(const Tile& tile);
+
+    /// \brief Get the tiles covering a region.
+    ///
+    /// Regions crossing the antimeridian are handled.
+    ///
+    /// \param bounds The region.
+    /// \param zoom The zoom level in [0, MAX_ZOOM].
+    /// \param tiles The vector the tiles are appended to, row by row.
+    /// \returns the number of tiles appended.
+    static std::size_t getTiles(const CoordinateBounds& bounds,
+                                int zoom,
+                                std::vector<Tile>& tiles);
+
+    /// \brief Project Coordinates into a float vertex buffer.
+    ///
+    /// Global pixel coordinates exceed float precision at high zoom, so
+    /// positions are written relative to an origin, usually the pixel
+    /// position of the view. The function does not allocate, so it can
+    /// refill a mesh's vertices every frame.
+    ///
+    /// \param coordinates The array of size locations.
+    /// \param size The number of locations.
+    /// \param zoom The zoom level, which may be fractional.
+    /// \param origin The global pixel position subtracted from each point.
+    /// \param vertices The output buffer of size * stride floats. Each
+    ///     vertex's x and y are written to its first two floats.
+    /// \param stride The number of floats per vertex, e.g. 3 for glm::vec3.
+    /// \param tileSize The size of a tile in pixels.
+    static void toPixels(const Coordinate* coordinates,
+                         std::size_t size,
+                         double zoom,
+                         const glm::dvec2& origin,
+                         float* vertices,
+                         std::size_t stride = 2,
+                         double tileSize = TILE_SIZE);
+
+    /// \brief Project latitude and longitude columns into a float vertex buffer.
+    ///
+    /// \sa toPixels(const Coordinate*, std::size_t, double, const glm::dvec2&, float*, std::size_t, double)
+    ///
+    /// \param latitudes The array of size latitudes in degrees.
+    /// \param longitudes The array of size longitudes in degrees.
+    /// \param size The number of locations.
+    /// \param zoom The zoom level, which may be fractional.
+    /// \param origin The global pixel position subtracted from each point.
+    /// \param vertices The output buffer of size * stride floats.
+    /// \param stride The number of floats per vertex.
+    /// \param tileSize The size of a tile in pixels.
+    static void toPixels(const double* latitudes,
+                         const double* longitudes,
+                         std::size_t size,
+                         double zoom,
+                         const glm::dvec2& origin,
+                         float* vertices,
+                         std::size_t stride = 2,
+                         double tileSize = TILE_SIZE);
+
+    /// \brief The radius of the projection sphere in meters.
+    static const double EARTH_RADIUS_M;
+
+    /// \brief The latitude in degrees at which the map becomes square.
+    static const double MAX_LATITUDE;
+
+    /// \brief The default tile size in pixels.
+    static const double TILE_SIZE;
+
+    /// \brief The deepest zoom level with integer tile indices.
+    static const int MAX_ZOOM;
+
+private:
+    WebMercator() = delete;
+    ~WebMercator() = delete;
+
+    /// \brief Get the normalized map position of a location.
+    /// \param latitude The latitude in degrees.
+    /// \param longitude The longitude in degrees.
+    /// \returns the position in [0, 1] x [0, 1], y increasing southward.
+    static glm::dvec2 _toNormalized(double latitude, double longitude);
+
+    /// \brief Get the location at a normalized map position.
+    /// \param normalized The position in [0, 1] x [0, 1].
+    /// \returns the location.
+    static Coordinate _fromNormalized(const glm::dvec2& normalized);
+
+};
+
+
+} } // namespace ofx::Geo
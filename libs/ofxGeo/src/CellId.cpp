@@ -0,0 +1,644 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofx/Geo/CellId.h"
+#include <algorithm>
+#include <queue>
+#include "ofx/Geo/GeoUtils.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+const int CellId::NUM_FACES = 6;
+const int CellId::MAX_LEVEL = 30;
+const int CellId::MAX_SIZE = 1 << 30;
+const std::size_t CellId::DEFAULT_MAX_CELLS = 8;
+
+
+namespace {
+
+
+// Hilbert curve tables. The orientation is a combination of SWAP_MASK
+// (i and j exchanged) and INVERT_MASK (both bits inverted).
+const int SWAP_MASK = 1;
+const int INVERT_MASK = 2;
+
+// Indexed by orientation, then by (i << 1 | j).
+const int IJ_TO_POSITION[4][4] = {
+    { 0, 1, 3, 2 },
+    { 0, 3, 1, 2 },
+    { 2, 3, 1, 0 },
+    { 2, 1, 3, 0 }
+};
+
+// Indexed by orientation, then by position; returns (i << 1 | j).
+const int POSITION_TO_IJ[4][4] = {
+    { 0, 1, 3, 2 },
+    { 0, 2, 3, 1 },
+    { 3, 2, 0, 1 },
+    { 3, 1, 0, 2 }
+};
+
+const int POSITION_TO_ORIENTATION[4] = {
+    SWAP_MASK,
+    0,
+    0,
+    INVERT_MASK | SWAP_MASK
+};
+
+const int FACE_BITS = 3;
+const int POSITION_BITS = 2 * 30 + 1;
+
+
+// The quadratic projection keeps cell areas within a factor of about two
+// across a face.
+double stToUV(double s)
+{
+    if (s >= 0.5)
+        return (1.0 / 3.0) * (4.0 * s * s - 1.0);
+    else
+        return (1.0 / 3.0) * (1.0 - 4.0 * (1.0 - s) * (1.0 - s));
+}
+
+
+double uvToST(double u)
+{
+    if (u >= 0)
+        return 0.5 * std::sqrt(1.0 + 3.0 * u);
+    else
+        return 1.0 - 0.5 * std::sqrt(1.0 - 3.0 * u);
+}
+
+
+int stToIJ(double s)
+{
+    return std::max(0, std::min(CellId::MAX_SIZE - 1,
+                                int(std::floor(CellId::MAX_SIZE * s))));
+}
+
+
+int xyzToFaceUV(const glm::dvec3& p, double& u, double& v)
+{
+    glm::dvec3 a(std::abs(p.x), std::abs(p.y), std::abs(p.z));
+
+    int face = a.x > a.y ? (a.x > a.z ? 0 : 2) : (a.y > a.z ? 1 : 2);
+
+    if (p[face] < 0)
+        face += 3;
+
+    switch (face)
+    {
+        case 0: u =  p.y / p.x; v =  p.z / p.x; break;
+        case 1: u = -p.x / p.y; v =  p.z / p.y; break;
+        case 2: u = -p.x / p.z; v = -p.y / p.z; break;
+        case 3: u =  p.z / p.x; v =  p.y / p.x; break;
+        case 4: u =  p.z / p.y; v = -p.x / p.y; break;
+        default: u = -p.y / p.z; v = -p.x / p.z; break;
+    }
+
+    return face;
+}
+
+
+glm::dvec3 faceUVToXYZ(int face, double u, double v)
+{
+    switch (face)
+    {
+        case 0: return glm::dvec3( 1,  u,  v);
+        case 1: return glm::dvec3(-u,  1,  v);
+        case 2: return glm::dvec3(-u, -v,  1);
+        case 3: return glm::dvec3(-1, -v, -u);
+        case 4: return glm::dvec3( v, -1, -u);
+        default: return glm::dvec3( v,  u, -1);
+    }
+}
+
+
+/// Grow a latitude range to include the extrema of the great-circle arc
+/// from a to b.
+void includeArcLatitudes(const glm::dvec3& a,
+                         const glm::dvec3& b,
+                         double& minZ,
+                         double& maxZ)
+{
+    glm::dvec3 n = glm::cross(a, b);
+    double length = glm::length(n);
+
+    if (length < 1e-15)
+        return;
+
+    n /= length;
+
+    // The highest point of the full great circle.
+    glm::dvec3 top = glm::dvec3(0, 0, 1) - n * n.z;
+    double topLength = glm::length(top);
+
+    if (topLength < 1e-15)
+        return;
+
+    top /= topLength;
+
+    // The arc contains a point if it lies between a and b.
+    if (glm::dot(glm::cross(a, top), n) > 0 && glm::dot(glm::cross(top, b), n) > 0)
+        maxZ = std::max(maxZ, top.z);
+
+    if (glm::dot(glm::cross(a, -top), n) > 0 && glm::dot(glm::cross(-top, b), n) > 0)
+        minZ = std::min(minZ, -top.z);
+}
+
+
+} // namespace
+
+
+CellId::CellId()
+{
+}
+
+
+CellId::CellId(uint64_t id): _id(id)
+{
+}
+
+
+CellId::CellId(const Coordinate& coordinate, int level):
+    CellId(GeoUtils::toNVector(coordinate), level)
+{
+}
+
+
+CellId::CellId(const NVector& vector, int level)
+{
+    double u = 0;
+    double v = 0;
+    int face = xyzToFaceUV(vector, u, v);
+
+    CellId leaf = fromFaceIJ(face, stToIJ(uvToST(u)), stToIJ(uvToST(v)));
+
+    _id = leaf.getParent(std::max(0, std::min(MAX_LEVEL, level)))._id;
+}
+
+
+CellId::~CellId()
+{
+}
+
+
+uint64_t CellId::getId() const
+{
+    return _id;
+}
+
+
+bool CellId::isValid() const
+{
+    return getFace() < NUM_FACES && (_lsb() & 0x1555555555555555ULL) != 0;
+}
+
+
+int CellId::getFace() const
+{
+    return int(_id >> POSITION_BITS);
+}
+
+
+int CellId::getLevel() const
+{
+    int level = MAX_LEVEL;
+    uint64_t id = _id;
+
+    while ((id & 1) == 0 && level > 0)
+    {
+        id >>= 2;
+        --level;
+    }
+
+    return level;
+}
+
+
+bool CellId::isLeaf() const
+{
+    return (_id & 1) != 0;
+}
+
+
+bool CellId::isFace() const
+{
+    return (_id & ((uint64_t(1) << POSITION_BITS) - 1)) == (uint64_t(1) << (POSITION_BITS - 1));
+}
+
+
+int CellId::getChildPosition() const
+{
+    return int((_id >> (2 * (MAX_LEVEL - getLevel()) + 1)) & 3);
+}
+
+
+CellId CellId::getParent() const
+{
+    if (isFace())
+        return *this;
+
+    uint64_t lsb = _lsb() << 2;
+    return CellId((_id & (~lsb + 1)) | lsb);
+}
+
+
+CellId CellId::getParent(int level) const
+{
+    if (level >= getLevel())
+        return *this;
+
+    uint64_t lsb = uint64_t(1) << (2 * (MAX_LEVEL - std::max(0, level)));
+    return CellId((_id & (~lsb + 1)) | lsb);
+}
+
+
+CellId CellId::getChild(int position) const
+{
+    if (isLeaf())
+        return CellId();
+
+    // Moving down a level splits the marker bit into two position bits.
+    uint64_t lsb = _lsb();
+    uint64_t childLsb = lsb >> 2;
+
+    return CellId(_id - lsb + uint64_t(2 * position + 1) * childLsb);
+}
+
+
+bool CellId::getChildren(CellId children[4]) const
+{
+    if (isLeaf())
+        return false;
+
+    for (int i = 0; i < 4; ++i)
+        children[i] = getChild(i);
+
+    return true;
+}
+
+
+void CellId::getEdgeNeighbors(CellId neighbors[4]) const
+{
+    int i = 0;
+    int j = 0;
+    int face = _toFaceIJ(i, j);
+    int level = getLevel();
+    int size = 1 << (MAX_LEVEL - level);
+
+    const int offsets[4][2] = { { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 } };
+
+    for (int k = 0; k < 4; ++k)
+    {
+        int ni = i + offsets[k][0] * size;
+        int nj = j + offsets[k][1] * size;
+
+        if (ni >= 0 && ni < MAX_SIZE && nj >= 0 && nj < MAX_SIZE)
+        {
+            neighbors[k] = fromFaceIJ(face, ni, nj).getParent(level);
+        }
+        else
+        {
+            // Step half a leaf across the face edge and reproject the point
+            // onto the adjacent face.
+            double si = ni < 0 ? -0.5 : (ni >= MAX_SIZE ? MAX_SIZE + 0.5 : ni + 0.5 * size);
+            double sj = nj < 0 ? -0.5 : (nj >= MAX_SIZE ? MAX_SIZE + 0.5 : nj + 0.5 * size);
+
+            neighbors[k] = CellId(_faceIJToVector(face, si, sj), level);
+        }
+    }
+}
+
+
+CellId CellId::getRangeMin() const
+{
+    return CellId(_id - (_lsb() - 1));
+}
+
+
+CellId CellId::getRangeMax() const
+{
+    return CellId(_id + (_lsb() - 1));
+}
+
+
+bool CellId::contains(const CellId& cell) const
+{
+    return cell._id >= getRangeMin()._id && cell._id <= getRangeMax()._id;
+}
+
+
+bool CellId::intersects(const CellId& cell) const
+{
+    return cell.getRangeMin()._id <= getRangeMax()._id
+        && cell.getRangeMax()._id >= getRangeMin()._id;
+}
+
+
+Coordinate CellId::getCenter() const
+{
+    int i = 0;
+    int j = 0;
+    int face = _toFaceIJ(i, j);
+    double half = 0.5 * (1 << (MAX_LEVEL - getLevel()));
+
+    return GeoUtils::toCoordinate(_faceIJToVector(face, i + half, j + half));
+}
+
+
+void CellId::getVertices(Coordinate vertices[4]) const
+{
+    int i = 0;
+    int j = 0;
+    int face = _toFaceIJ(i, j);
+    double size = double(1 << (MAX_LEVEL - getLevel()));
+
+    vertices[0] = GeoUtils::toCoordinate(_faceIJToVector(face, i, j));
+    vertices[1] = GeoUtils::toCoordinate(_faceIJToVector(face, i + size, j));
+    vertices[2] = GeoUtils::toCoordinate(_faceIJToVector(face, i + size, j + size));
+    vertices[3] = GeoUtils::toCoordinate(_faceIJToVector(face, i, j + size));
+}
+
+
+CoordinateBounds CellId::getBounds() const
+{
+    int i = 0;
+    int j = 0;
+    int face = _toFaceIJ(i, j);
+    double size = double(1 << (MAX_LEVEL - getLevel()));
+
+    NVector corners[4] = {
+        _faceIJToVector(face, i, j),
+        _faceIJToVector(face, i + size, j),
+        _faceIJToVector(face, i + size, j + size),
+        _faceIJToVector(face, i, j + size)
+    };
+
+    double minZ = 1;
+    double maxZ = -1;
+
+    for (int k = 0; k < 4; ++k)
+    {
+        minZ = std::min(minZ, corners[k].z);
+        maxZ = std::max(maxZ, corners[k].z);
+        includeArcLatitudes(corners[k], corners[(k + 1) % 4], minZ, maxZ);
+    }
+
+    double minLatitude = glm::degrees(std::asin(glm::clamp(minZ, -1.0, 1.0)));
+    double maxLatitude = glm::degrees(std::asin(glm::clamp(maxZ, -1.0, 1.0)));
+
+    bool containsNorthPole = contains(CellId(NVector::NORTH_POLE));
+    bool containsSouthPole = contains(CellId(NVector(0, 0, -1)));
+
+    if (containsNorthPole)
+        maxLatitude = 90;
+
+    if (containsSouthPole)
+        minLatitude = -90;
+
+    double minLongitude = -180;
+    double maxLongitude = 180;
+
+    if (!containsNorthPole && !containsSouthPole)
+    {
+        // Longitude is monotonic along arcs that miss the poles, so the
+        // corners bound it. Measure them relative to the first corner.
+        double reference = corners[0].getLongitude();
+        double low = 0;
+        double high = 0;
+
+        for (int k = 1; k < 4; ++k)
+        {
+            double delta = std::fmod(corners[k].getLongitude() - reference + 540.0, 360.0) - 180.0;
+            low = std::min(low, delta);
+            high = std::max(high, delta);
+        }
+
+        minLongitude = reference + low;
+        maxLongitude = reference + high;
+
+        if (minLongitude < -180)
+            minLongitude += 360;
+
+        if (maxLongitude > 180)
+            maxLongitude -= 360;
+    }
+
+    return CoordinateBounds(minLatitude, minLongitude, maxLatitude, maxLongitude);
+}
+
+
+std::string CellId::toToken() const
+{
+    if (_id == 0)
+        return "X";
+
+    static const char* digits = "0123456789abcdef";
+
+    std::string token;
+
+    for (int shift = 60; shift >= 0; shift -= 4)
+        token += digits[(_id >> shift) & 0xF];
+
+    token.erase(token.find_last_not_of('0') + 1);
+
+    return token;
+}
+
+
+CellId CellId::fromToken(const std::string& token)
+{
+    if (token.empty() || token.size() > 16)
+        return CellId();
+
+    uint64_t id = 0;
+
+    for (std::size_t k = 0; k < token.size(); ++k)
+    {
+        char c = token[k];
+        uint64_t digit = 0;
+
+        if (c >= '0' && c <= '9')
+            digit = uint64_t(c - '0');
+        else if (c >= 'a' && c <= 'f')
+            digit = uint64_t(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F')
+            digit = uint64_t(c - 'A' + 10);
+        else
+            return CellId();
+
+        id |= digit << (60 - 4 * k);
+    }
+
+    return CellId(id);
+}
+
+
+CellId CellId::fromFace(int face)
+{
+    return CellId((uint64_t(face) << POSITION_BITS) + (uint64_t(1) << (POSITION_BITS - 1)));
+}
+
+
+CellId CellId::fromFaceIJ(int face, int i, int j)
+{
+    uint64_t position = 0;
+    int orientation = face & SWAP_MASK;
+
+    for (int k = MAX_LEVEL - 1; k >= 0; --k)
+    {
+        int ij = (((i >> k) & 1) << 1) | ((j >> k) & 1);
+        int p = IJ_TO_POSITION[orientation][ij];
+        position = (position << 2) | uint64_t(p);
+        orientation ^= POSITION_TO_ORIENTATION[p];
+    }
+
+    return CellId((uint64_t(face) << POSITION_BITS) | (position << 1) | 1);
+}
+
+
+std::vector<CellId> CellId::cover(const CoordinateBounds& bounds,
+                                  std::size_t maxCells,
+                                  int maxLevel)
+{
+    std::vector<CellId> result;
+
+    if (bounds.isEmpty())
+        return result;
+
+    maxLevel = std::max(0, std::min(MAX_LEVEL, maxLevel));
+    maxCells = std::max(std::size_t(1), maxCells);
+
+    // Candidates are refined largest first; ties go to the lower id so the
+    // covering is deterministic.
+    struct Larger
+    {
+        bool operator () (const CellId& a, const CellId& b) const
+        {
+            int levelA = a.getLevel();
+            int levelB = b.getLevel();
+            return levelA != levelB ? levelA > levelB : b < a;
+        }
+    };
+
+    std::priority_queue<CellId, std::vector<CellId>, Larger> candidates;
+
+    for (int face = 0; face < NUM_FACES; ++face)
+    {
+        CellId cell = fromFace(face);
+
+        if (cell.getBounds().intersects(bounds))
+            candidates.push(cell);
+    }
+
+    while (!candidates.empty())
+    {
+        CellId cell = candidates.top();
+        candidates.pop();
+
+        CoordinateBounds cellBounds = cell.getBounds();
+
+        if (bounds.contains(cellBounds) || cell.getLevel() >= maxLevel)
+        {
+            result.push_back(cell);
+            continue;
+        }
+
+        CellId children[4];
+        cell.getChildren(children);
+
+        std::size_t count = 0;
+        CellId intersecting[4];
+
+        for (int k = 0; k < 4; ++k)
+        {
+            if (children[k].getBounds().intersects(bounds))
+                intersecting[count++] = children[k];
+        }
+
+        // Subdividing replaces one cell with count cells.
+        if (result.size() + candidates.size() + count > maxCells)
+        {
+            result.push_back(cell);
+            continue;
+        }
+
+        for (std::size_t k = 0; k < count; ++k)
+            candidates.push(intersecting[k]);
+    }
+
+    std::sort(result.begin(), result.end());
+
+    return result;
+}
+
+
+bool CellId::operator == (const CellId& cell) const
+{
+    return _id == cell._id;
+}
+
+
+bool CellId::operator != (const CellId& cell) const
+{
+    return _id != cell._id;
+}
+
+
+bool CellId::operator < (const CellId& cell) const
+{
+    return _id < cell._id;
+}
+
+
+uint64_t CellId::_lsb() const
+{
+    return _id & (~_id + 1);
+}
+
+
+int CellId::_toFaceIJ(int& i, int& j) const
+{
+    int face = getFace();
+    int orientation = face & SWAP_MASK;
+
+    i = 0;
+    j = 0;
+
+    // Decode the first leaf, which fixes the cell's lower-left corner.
+    uint64_t id = getRangeMin()._id;
+
+    for (int k = MAX_LEVEL - 1; k >= 0; --k)
+    {
+        int p = int((id >> (2 * k + 1)) & 3);
+        int ij = POSITION_TO_IJ[orientation][p];
+        i |= (ij >> 1) << k;
+        j |= (ij & 1) << k;
+        orientation ^= POSITION_TO_ORIENTATION[p];
+    }
+
+    // Align to the cell.
+    int size = 1 << (MAX_LEVEL - getLevel());
+    i &= ~(size - 1);
+    j &= ~(size - 1);
+
+    return face;
+}
+
+
+NVector CellId::_faceIJToVector(int face, double i, double j)
+{
+    return NVector(faceUVToXYZ(face,
+                               stToUV(i / MAX_SIZE),
+                               stToUV(j / MAX_SIZE)));
+}
+
+
+} } // namespace ofx::Geo
@@ -0,0 +1,206 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofx/Geo/CellIndex.h"
+#include <algorithm>
+
+
+namespace ofx {
+namespace Geo {
+
+
+const std::size_t CellIndex::DEFAULT_MAX_CELLS = 16;
+
+
+CellIndex::CellIndex()
+{
+}
+
+
+CellIndex::~CellIndex()
+{
+}
+
+
+void CellIndex::add(const Coordinate& coordinate, std::size_t id)
+{
+    Entry entry;
+    entry.cellId = CellId(coordinate).getId();
+    entry.latitude = coordinate.getLatitude();
+    entry.longitude = coordinate.getLongitude();
+    entry.id = id;
+
+    _entries.push_back(entry);
+    _built = false;
+}
+
+
+void CellIndex::add(const Coordinate* coordinates,
+                    const std::size_t* ids,
+                    std::size_t size,
+                    const Executor& executor)
+{
+    std::size_t offset = _entries.size();
+
+    _entries.resize(offset + size);
+
+    Entry* entries = _entries.data() + offset;
+
+    executor.run(size, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            entries[i].cellId = CellId(coordinates[i]).getId();
+            entries[i].latitude = coordinates[i].getLatitude();
+            entries[i].longitude = coordinates[i].getLongitude();
+            entries[i].id = ids[i];
+        }
+    });
+
+    if (size > 0)
+        _built = false;
+}
+
+
+void CellIndex::build()
+{
+    if (_built)
+        return;
+
+    // Ties are broken by id so query results do not depend on insertion order.
+    std::sort(_entries.begin(), _entries.end(), [](const Entry& a, const Entry& b)
+    {
+        return a.cellId != b.cellId ? a.cellId < b.cellId : a.id < b.id;
+    });
+
+    _built = true;
+}
+
+
+bool CellIndex::isBuilt() const
+{
+    return _built;
+}
+
+
+std::size_t CellIndex::query(const CoordinateBounds& bounds,
+                             std::vector<std::size_t>& ids,
+                             std::size_t maxCells) const
+{
+    std::size_t count = ids.size();
+
+    if (!_built)
+    {
+        for (const Entry& entry: _entries)
+        {
+            if (bounds.contains(Coordinate(entry.latitude, entry.longitude)))
+                ids.push_back(entry.id);
+        }
+
+        return ids.size() - count;
+    }
+
+    std::vector<CellId> covering = CellId::cover(bounds, maxCells);
+
+    // The covering is sorted and disjoint, so the ranges are scanned in
+    // array order without duplicates.
+    for (const CellId& cell: covering)
+    {
+        std::vector<Entry>::const_iterator first;
+        std::vector<Entry>::const_iterator last;
+        _range(cell, first, last);
+
+        for (; first != last; ++first)
+        {
+            if (bounds.contains(Coordinate(first->latitude, first->longitude)))
+                ids.push_back(first->id);
+        }
+    }
+
+    return ids.size() - count;
+}
+
+
+std::size_t CellIndex::query(const CellId& cell, std::vector<std::size_t>& ids) const
+{
+    std::size_t count = ids.size();
+
+    if (!_built)
+    {
+        for (const Entry& entry: _entries)
+        {
+            if (cell.contains(CellId(entry.cellId)))
+                ids.push_back(entry.id);
+        }
+
+        return ids.size() - count;
+    }
+
+    std::vector<Entry>::const_iterator first;
+    std::vector<Entry>::const_iterator last;
+    _range(cell, first, last);
+
+    for (; first != last; ++first)
+        ids.push_back(first->id);
+
+    return ids.size() - count;
+}
+
+
+void CellIndex::clear()
+{
+    _entries.clear();
+    _built = true;
+}
+
+
+void CellIndex::reserve(std::size_t size)
+{
+    _entries.reserve(size);
+}
+
+
+std::size_t CellIndex::size() const
+{
+    return _entries.size();
+}
+
+
+bool CellIndex::empty() const
+{
+    return _entries.empty();
+}
+
+
+const std::vector<CellIndex::Entry>& CellIndex::getEntries() const
+{
+    return _entries;
+}
+
+
+void CellIndex::_range(const CellId& cell,
+                       std::vector<Entry>::const_iterator& first,
+                       std::vector<Entry>::const_iterator& last) const
+{
+    uint64_t minId = cell.getRangeMin().getId();
+    uint64_t maxId = cell.getRangeMax().getId();
+
+    first = std::lower_bound(_entries.begin(), _entries.end(), minId,
+                             [](const Entry& entry, uint64_t id)
+                             {
+                                 return entry.cellId < id;
+                             });
+
+    last = std::upper_bound(first, _entries.end(), maxId,
+                            [](uint64_t id, const Entry& entry)
+                            {
+                                return id < entry.cellId;
+                            });
+}
+
+
+} } // namespace ofx::Geo
@@ -0,0 +1,378 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofx/Geo/Clustering.h"
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include "ofx/Geo/GeoUtils.h"
+#include "ofx/Geo/NVector.h"
+#include "ofx/Geo/SpatialHash.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+namespace {
+
+
+/// \brief A disjoint-set forest that can be joined from many threads.
+///
+/// Roots are always linked to the smaller root, so each set's root is its
+/// smallest member no matter the order of the joins.
+class ConcurrentUnionFind
+{
+public:
+    ConcurrentUnionFind(std::size_t size): _parents(size)
+    {
+        for (std::size_t i = 0; i < size; ++i)
+            _parents[i].store(i, std::memory_order_relaxed);
+    }
+
+    std::size_t find(std::size_t index)
+    {
+        for (;;)
+        {
+            std::size_t parent = _parents[index].load();
+
+            if (parent == index)
+                return index;
+
+            // Path halving; parents only ever decrease, so this is safe to race.
+            std::size_t grandparent = _parents[parent].load();
+
+            if (grandparent != parent)
+                _parents[index].compare_exchange_weak(parent, grandparent);
+
+            index = parent;
+        }
+    }
+
+    void unite(std::size_t a, std::size_t b)
+    {
+        for (;;)
+        {
+            a = find(a);
+            b = find(b);
+
+            if (a == b)
+                return;
+
+            if (a < b)
+                std::swap(a, b);
+
+            // Fails if another thread linked a first; retry from the new roots.
+            std::size_t expected = a;
+
+            if (_parents[a].compare_exchange_strong(expected, b))
+                return;
+        }
+    }
+
+private:
+    std::vector<std::atomic<std::size_t>> _parents;
+
+};
+
+
+} // namespace
+
+
+const std::size_t Clustering::NOISE = std::numeric_limits<std::size_t>::max();
+
+
+std::size_t Clustering::dbscan(const Coordinate* coordinates,
+                               std::size_t size,
+                               double epsilon,
+                               std::size_t minPoints,
+                               std::size_t* labels,
+                               const Executor& executor)
+{
+    if (size == 0)
+        return 0;
+
+    // Cells about epsilon across keep each query to a few buckets.
+    double cellSize = glm::degrees(epsilon / GeoUtils::EARTH_RADIUS_KM);
+
+    SpatialHash index(std::max(cellSize, 1e-7));
+
+    for (std::size_t i = 0; i < size; ++i)
+        index.insert(i, coordinates[i]);
+
+    // Atomic flags so blocks can publish core points concurrently.
+    std::vector<std::atomic<uint8_t>> core(size);
+
+    ConcurrentUnionFind sets(size);
+
+    // Points that are not core have fewer than minPoints neighbors, so each
+    // block keeps their neighbor lists for assigning border points.
+    struct BorderPoints
+    {
+        std::vector<std::size_t> points;
+        std::vector<std::size_t> offsets;
+        std::vector<std::size_t> neighbors;
+    };
+
+    std::vector<BorderPoints> borderBlocks(executor.getNumBlocks(size));
+
+    executor.run(size, [&](std::size_t begin, std::size_t end)
+    {
+        BorderPoints& border = borderBlocks[begin / executor.getBlockSize()];
+        std::vector<std::size_t> neighbors;
+
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            neighbors.clear();
+
+            if (index.query(coordinates[i], epsilon, neighbors) < minPoints)
+            {
+                border.points.push_back(i);
+                border.offsets.push_back(border.neighbors.size());
+                border.neighbors.insert(border.neighbors.end(), neighbors.begin(), neighbors.end());
+                continue;
+            }
+
+            // Each point publishes its flag before reading its neighbors'
+            // flags, so of two core neighbors at least one sees the other.
+            core[i].store(1);
+
+            for (std::size_t neighbor: neighbors)
+            {
+                if (core[neighbor].load())
+                    sets.unite(i, neighbor);
+            }
+        }
+    });
+
+    // Each set's root is its smallest index, so numbering roots in index
+    // order numbers clusters by their lowest point.
+    std::size_t numClusters = 0;
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        if (core[i])
+        {
+            std::size_t root = sets.find(i);
+            labels[i] = root == i ? numClusters++ : labels[root];
+        }
+    }
+
+    // Border points join the cluster of their nearest core point, the
+    // lowest index on ties.
+    executor.run(size, [&](std::size_t begin, std::size_t)
+    {
+        const BorderPoints& border = borderBlocks[begin / executor.getBlockSize()];
+
+        for (std::size_t k = 0; k < border.points.size(); ++k)
+        {
+            std::size_t i = border.points[k];
+            std::size_t first = border.offsets[k];
+            std::size_t last = k + 1 < border.points.size() ? border.offsets[k + 1]
+                                                            : border.neighbors.size();
+
+            std::size_t nearest = NOISE;
+            double nearestDistance = 0;
+
+            for (std::size_t n = first; n < last; ++n)
+            {
+                std::size_t neighbor = border.neighbors[n];
+
+                if (!core[neighbor])
+                    continue;
+
+                double distance = GeoUtils::distanceHaversine(coordinates[i], coordinates[neighbor]);
+
+                if (nearest == NOISE
+                 || distance < nearestDistance
+                 || (distance == nearestDistance && neighbor < nearest))
+                {
+                    nearest = neighbor;
+                    nearestDistance = distance;
+                }
+            }
+
+            labels[i] = nearest == NOISE ? NOISE : labels[nearest];
+        }
+    });
+
+    return numClusters;
+}
+
+
+std::size_t Clustering::dbscan(const std::vector<Coordinate>& coordinates,
+                               double epsilon,
+                               std::size_t minPoints,
+                               std::vector<std::size_t>& labels,
+                               const Executor& executor)
+{
+    labels.resize(coordinates.size());
+    return dbscan(coordinates.data(),
+                  coordinates.size(),
+                  epsilon,
+                  minPoints,
+                  labels.data(),
+                  executor);
+}
+
+
+void Clustering::aggregate(const Coordinate* coordinates,
+                           std::size_t size,
+                           int level,
+                           std::vector<CellCount>& counts,
+                           const Executor& executor)
+{
+    level = std::max(0, std::min(CellId::MAX_LEVEL, level));
+
+    std::vector<_Bin> bins;
+
+    _aggregate(coordinates, size, [level](const Coordinate& coordinate)
+    {
+        return CellId(coordinate, level).getId();
+    }, bins, executor);
+
+    counts.resize(bins.size());
+
+    for (std::size_t i = 0; i < bins.size(); ++i)
+    {
+        counts[i].cell = CellId(bins[i].key);
+        counts[i].count = bins[i].count;
+        counts[i].center = _center(bins[i]);
+    }
+}
+
+
+void Clustering::aggregate(const std::vector<Coordinate>& coordinates,
+                           int level,
+                           std::vector<CellCount>& counts,
+                           const Executor& executor)
+{
+    aggregate(coordinates.data(), coordinates.size(), level, counts, executor);
+}
+
+
+void Clustering::aggregate(const Coordinate* coordinates,
+                           std::size_t size,
+                           int zoom,
+                           std::vector<TileCount>& counts,
+                           const Executor& executor)
+{
+    zoom = std::max(0, std::min(WebMercator::MAX_ZOOM, zoom));
+
+    std::vector<_Bin> bins;
+
+    // Keys order the tiles row by row.
+    _aggregate(coordinates, size, [zoom](const Coordinate& coordinate)
+    {
+        Tile tile = WebMercator::toTile(coordinate, zoom);
+        return (uint64_t(tile.y) << 32) | uint64_t(tile.x);
+    }, bins, executor);
+
+    counts.resize(bins.size());
+
+    for (std::size_t i = 0; i < bins.size(); ++i)
+    {
+        counts[i].tile.x = int(bins[i].key & 0xFFFFFFFF);
+        counts[i].tile.y = int(bins[i].key >> 32);
+        counts[i].tile.zoom = zoom;
+        counts[i].count = bins[i].count;
+        counts[i].center = _center(bins[i]);
+    }
+}
+
+
+void Clustering::aggregate(const std::vector<Coordinate>& coordinates,
+                           int zoom,
+                           std::vector<TileCount>& counts,
+                           const Executor& executor)
+{
+    aggregate(coordinates.data(), coordinates.size(), zoom, counts, executor);
+}
+
+
+template <typename Key>
+void Clustering::_aggregate(const Coordinate* coordinates,
+                            std::size_t size,
+                            const Key& key,
+                            std::vector<_Bin>& bins,
+                            const Executor& executor)
+{
+    auto byKey = [](const _Bin& a, const _Bin& b)
+    {
+        return a.key < b.key;
+    };
+
+    // Each block reduces its own points, then blocks are merged in block
+    // order, so sums are added in the same order for any executor.
+    std::vector<std::vector<_Bin>> blockBins(executor.getNumBlocks(size));
+
+    executor.run(size, [&](std::size_t begin, std::size_t end)
+    {
+        std::vector<_Bin>& block = blockBins[begin / executor.getBlockSize()];
+        block.resize(end - begin);
+
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            _Bin& bin = block[i - begin];
+            bin.key = key(coordinates[i]);
+            bin.count = 1;
+            bin.sum = GeoUtils::toNVector(coordinates[i]);
+        }
+
+        std::stable_sort(block.begin(), block.end(), byKey);
+
+        std::size_t count = 0;
+
+        for (const _Bin& bin: block)
+        {
+            if (count > 0 && block[count - 1].key == bin.key)
+            {
+                block[count - 1].count += bin.count;
+                block[count - 1].sum += bin.sum;
+            }
+            else
+            {
+                block[count++] = bin;
+            }
+        }
+
+        block.resize(count);
+    });
+
+    bins.clear();
+
+    for (const std::vector<_Bin>& block: blockBins)
+        bins.insert(bins.end(), block.begin(), block.end());
+
+    std::stable_sort(bins.begin(), bins.end(), byKey);
+
+    std::size_t count = 0;
+
+    for (std::size_t i = 0; i < bins.size(); ++i)
+    {
+        if (count > 0 && bins[count - 1].key == bins[i].key)
+        {
+            bins[count - 1].count += bins[i].count;
+            bins[count - 1].sum += bins[i].sum;
+        }
+        else
+        {
+            bins[count++] = bins[i];
+        }
+    }
+
+    bins.resize(count);
+}
+
+
+Coordinate Clustering::_center(const _Bin& bin)
+{
+    return GeoUtils::toCoordinate(NVector(bin.sum));
+}
+
+
+} } // namespace ofx::Geo
@@ -0,0 +1,71 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofx/Geo/CompensatedSum.h"
+#include <cmath>
+
+
+namespace ofx {
+namespace Geo {
+
+
+CompensatedSum::CompensatedSum(double value): _sum(value)
+{
+}
+
+
+CompensatedSum::~CompensatedSum()
+{
+}
+
+
+void CompensatedSum::add(double value)
+{
+    double sum = _sum + value;
+
+    // Recover the low-order bits lost from the smaller operand.
+    if (std::abs(_sum) >= std::abs(value))
+        _compensation += (_sum - sum) + value;
+    else
+        _compensation += (value - sum) + _sum;
+
+    _sum = sum;
+}
+
+
+CompensatedSum& CompensatedSum::operator += (double value)
+{
+    add(value);
+    return *this;
+}
+
+
+void CompensatedSum::clear()
+{
+    _sum = 0;
+    _compensation = 0;
+}
+
+
+double CompensatedSum::getSum() const
+{
+    return _sum + _compensation;
+}
+
+
+double CompensatedSum::sum(const double* values, std::size_t size)
+{
+    CompensatedSum result;
+
+    for (std::size_t i = 0; i < size; ++i)
+        result.add(values[i]);
+
+    return result.getSum();
+}
+
+
+} } // namespace ofx::Geo
@@ -0,0 +1,507 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofx/Geo/ConvexHull.h"
+#include <algorithm>
+#include <limits>
+#include <random>
+#include "ofx/Geo/CoordinateBounds.h"
+#include "ofx/Geo/GeoUtils.h"
+#include "ofx/Geo/NVector.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+namespace {
+
+
+/// \brief A projected point and its index.
+struct Vertex
+{
+    glm::dvec2 position;
+    std::size_t index;
+};
+
+
+/// \returns twice the signed area of the triangle o, a, b; positive if it
+///     turns counterclockwise.
+double cross(const glm::dvec2& o, const glm::dvec2& a, const glm::dvec2& b)
+{
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+
+/// \brief Replace vertices with their convex hull in counterclockwise order.
+void monotoneChain(std::vector<Vertex>& vertices)
+{
+    // Ties keep the lowest index, so the result does not depend on the
+    // order of the input.
+    std::sort(vertices.begin(), vertices.end(), [](const Vertex& v0, const Vertex& v1)
+    {
+        if (v0.position.x != v1.position.x)
+            return v0.position.x < v1.position.x;
+
+        if (v0.position.y != v1.position.y)
+            return v0.position.y < v1.position.y;
+
+        return v0.index < v1.index;
+    });
+
+    vertices.erase(std::unique(vertices.begin(), vertices.end(), [](const Vertex& v0, const Vertex& v1)
+    {
+        return v0.position == v1.position;
+    }), vertices.end());
+
+    std::size_t size = vertices.size();
+
+    if (size < 3)
+        return;
+
+    std::vector<Vertex> hull(2 * size);
+    std::size_t count = 0;
+
+    // Lower hull, then upper hull.
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        while (count >= 2 && cross(hull[count - 2].position, hull[count - 1].position, vertices[i].position) <= 0)
+            --count;
+
+        hull[count++] = vertices[i];
+    }
+
+    for (std::size_t i = size - 1, lower = count + 1; i-- > 0; )
+    {
+        while (count >= lower && cross(hull[count - 2].position, hull[count - 1].position, vertices[i].position) <= 0)
+            --count;
+
+        hull[count++] = vertices[i];
+    }
+
+    // The last vertex repeats the first.
+    hull.resize(count - 1);
+    vertices.swap(hull);
+}
+
+
+/// \brief Remove vertices strictly inside the polygon of the extreme
+///     vertices in eight directions, which cannot be on the hull.
+void discardInterior(std::vector<Vertex>& vertices)
+{
+    static const glm::dvec2 directions[8] = {
+        glm::dvec2(-1, 0), glm::dvec2(-1, -1), glm::dvec2(0, -1), glm::dvec2(1, -1),
+        glm::dvec2(1, 0), glm::dvec2(1, 1), glm::dvec2(0, 1), glm::dvec2(-1, 1)
+    };
+
+    if (vertices.empty())
+        return;
+
+    glm::dvec2 extremes[8];
+    double best[8];
+
+    for (std::size_t k = 0; k < 8; ++k)
+    {
+        extremes[k] = vertices[0].position;
+        best[k] = glm::dot(directions[k], extremes[k]);
+    }
+
+    for (const Vertex& vertex: vertices)
+    {
+        for (std::size_t k = 0; k < 8; ++k)
+        {
+            double value = glm::dot(directions[k], vertex.position);
+
+            if (value > best[k])
+            {
+                best[k] = value;
+                extremes[k] = vertex.position;
+            }
+        }
+    }
+
+    // The extremes of directions in counterclockwise order are in
+    // counterclockwise order around the hull.
+    glm::dvec2 polygon[8];
+    std::size_t size = 0;
+
+    for (std::size_t k = 0; k < 8; ++k)
+    {
+        if (size == 0 || (extremes[k] != polygon[size - 1] && extremes[k] != polygon[0]))
+            polygon[size++] = extremes[k];
+    }
+
+    if (size < 3)
+        return;
+
+    vertices.erase(std::remove_if(vertices.begin(), vertices.end(), [&](const Vertex& vertex)
+    {
+        for (std::size_t k = 0; k < size; ++k)
+        {
+            if (cross(polygon[k], polygon[(k + 1) % size], vertex.position) <= 0)
+                return false;
+        }
+
+        return true;
+    }), vertices.end());
+}
+
+
+/// \brief A gnomonic projection, which maps great circles to straight lines.
+///
+/// Positions are in units of the earth's radius on the plane tangent at the
+/// center. Points must be less than 90 degrees from the center.
+class Gnomonic
+{
+public:
+    Gnomonic(const Coordinate& center = Coordinate()):
+        _center(GeoUtils::toNVector(center))
+    {
+        // East is undefined at the poles; any horizontal axis will do.
+        glm::dvec3 east = glm::cross(glm::dvec3(NVector::NORTH_POLE), _center);
+        double length = glm::length(east);
+
+        _east = length > 1e-12 ? east / length : glm::dvec3(0, 1, 0);
+        _north = glm::cross(_center, _east);
+    }
+
+    glm::dvec2 toPlane(const Coordinate& coordinate) const
+    {
+        NVector vector = GeoUtils::toNVector(coordinate);
+        return glm::dvec2(glm::dot(vector, _east), glm::dot(vector, _north)) / glm::dot(vector, _center);
+    }
+
+    Coordinate toCoordinate(const glm::dvec2& position) const
+    {
+        return GeoUtils::toCoordinate(NVector(_center + _east * position.x + _north * position.y));
+    }
+
+private:
+    glm::dvec3 _center;
+    glm::dvec3 _east;
+    glm::dvec3 _north;
+
+};
+
+
+/// \brief Get the convex hull of points in a plane.
+void planarHull(const Gnomonic& plane,
+                const Coordinate* coordinates,
+                std::size_t size,
+                std::vector<Vertex>& hull,
+                const Executor& executor)
+{
+    std::vector<std::vector<Vertex>> blockHulls(executor.getNumBlocks(size));
+
+    executor.run(size, [&](std::size_t begin, std::size_t end)
+    {
+        std::vector<Vertex>& block = blockHulls[begin / executor.getBlockSize()];
+        block.resize(end - begin);
+
+        for (std::size_t i = begin; i < end; ++i)
+            block[i - begin] = Vertex{ plane.toPlane(coordinates[i]), i };
+
+        discardInterior(block);
+        monotoneChain(block);
+    });
+
+    // The hull of the block hulls is the hull of all of the points.
+    hull.clear();
+
+    for (const std::vector<Vertex>& block: blockHulls)
+        hull.insert(hull.end(), block.begin(), block.end());
+
+    monotoneChain(hull);
+}
+
+
+/// \returns a gnomonic projection centered on the bounds of points.
+Gnomonic planeFor(const Coordinate* coordinates,
+                  std::size_t size,
+                  const Executor& executor)
+{
+    if (size == 0)
+        return Gnomonic();
+
+    return Gnomonic(GeoUtils::bounds(coordinates, size, executor).getCenter());
+}
+
+
+/// \brief A spherical cap, the points within an angle of a center.
+struct Cap
+{
+    glm::dvec3 center;
+
+    /// \brief The chord length from the center to the edge, which keeps
+    ///     its precision for small caps, unlike the cosine of the angle.
+    double chord;
+
+    bool contains(const glm::dvec3& point) const
+    {
+        // Allow for rounding in caps built from the same points.
+        return glm::distance(center, point) <= chord * (1 + 1e-12) + 1e-15;
+    }
+};
+
+
+Cap capFrom(const glm::dvec3& p0, const glm::dvec3& p1)
+{
+    glm::dvec3 center = glm::normalize(p0 + p1);
+    return Cap{ center, glm::distance(center, p0) };
+}
+
+
+Cap capFrom(const glm::dvec3& p0, const glm::dvec3& p1, const glm::dvec3& p2)
+{
+    // The cap's edge is the circle where the plane of the points cuts the
+    // sphere; its center is the plane's normal on the side of the points.
+    glm::dvec3 normal = glm::cross(p1 - p0, p2 - p0);
+    double length = glm::length(normal);
+
+    if (length == 0 || glm::dot(normal, p0) == 0)
+    {
+        // Collinear or on one great circle; the cap spans the farthest pair.
+        Cap cap = capFrom(p0, p1);
+
+        for (const Cap& candidate: { capFrom(p0, p2), capFrom(p1, p2) })
+        {
+            if (candidate.chord > cap.chord)
+                cap = candidate;
+        }
+
+        return cap;
+    }
+
+    glm::dvec3 center = normal / length;
+
+    if (glm::dot(center, p0) < 0)
+        center = -center;
+
+    return Cap{ center, glm::distance(center, p0) };
+}
+
+
+/// \brief Get the smallest cap containing points, with Welzl's randomized
+///     incremental algorithm on the sphere.
+Cap welzl(std::vector<glm::dvec3> points)
+{
+    // A fixed seed keeps results repeatable; the expected time is linear
+    // for any order the shuffle produces.
+    std::mt19937 random(5489u);
+    std::shuffle(points.begin(), points.end(), random);
+
+    Cap cap{ points[0], 0 };
+
+    for (std::size_t i = 1; i < points.size(); ++i)
+    {
+        const glm::dvec3& pi = points[i];
+
+        if (cap.contains(pi))
+            continue;
+
+        cap = Cap{ pi, 0 };
+
+        for (std::size_t j = 0; j < i; ++j)
+        {
+            const glm::dvec3& pj = points[j];
+
+            if (cap.contains(pj))
+                continue;
+
+            cap = capFrom(pi, pj);
+
+            for (std::size_t k = 0; k < j; ++k)
+            {
+                const glm::dvec3& pk = points[k];
+
+                if (!cap.contains(pk))
+                    cap = capFrom(pi, pj, pk);
+            }
+        }
+    }
+
+    return cap;
+}
+
+
+} // namespace
+
+
+void ConvexHull::hull(const Coordinate* coordinates,
+                      std::size_t size,
+                      std::vector<Coordinate>& hull,
+                      const Executor& executor)
+{
+    std::vector<Vertex> vertices;
+    planarHull(planeFor(coordinates, size, executor), coordinates, size, vertices, executor);
+
+    hull.clear();
+    hull.reserve(vertices.size());
+
+    for (const Vertex& vertex: vertices)
+        hull.push_back(coordinates[vertex.index]);
+}
+
+
+void ConvexHull::hull(const std::vector<Coordinate>& coordinates,
+                      std::vector<Coordinate>& hull,
+                      const Executor& executor)
+{
+    ConvexHull::hull(coordinates.data(), coordinates.size(), hull, executor);
+}
+
+
+BoundingCircle ConvexHull::boundingCircle(const Coordinate* coordinates,
+                                          std::size_t size,
+                                          const Executor& executor)
+{
+    std::vector<Vertex> vertices;
+    planarHull(planeFor(coordinates, size, executor), coordinates, size, vertices, executor);
+
+    if (vertices.empty())
+        return BoundingCircle{ Coordinate(), 0 };
+
+    // The hull is the spherical hull, and caps are convex on the sphere, so
+    // the cap containing the hull contains every point.
+    std::vector<glm::dvec3> points(vertices.size());
+
+    for (std::size_t i = 0; i < vertices.size(); ++i)
+        points[i] = GeoUtils::toNVector(coordinates[vertices[i].index]);
+
+    BoundingCircle circle{ GeoUtils::toCoordinate(NVector(welzl(points).center)), 0 };
+
+    // Measure the radius with the same distance callers check against.
+    for (const Vertex& vertex: vertices)
+    {
+        circle.radius = std::max(circle.radius,
+                                 GeoUtils::distanceHaversine(circle.center, coordinates[vertex.index]));
+    }
+
+    return circle;
+}
+
+
+BoundingCircle ConvexHull::boundingCircle(const std::vector<Coordinate>& coordinates,
+                                          const Executor& executor)
+{
+    return boundingCircle(coordinates.data(), coordinates.size(), executor);
+}
+
+
+BoundingRectangle ConvexHull::boundingRectangle(const Coordinate* coordinates,
+                                                std::size_t size,
+                                                const Executor& executor)
+{
+    Gnomonic plane = planeFor(coordinates, size, executor);
+
+    std::vector<Vertex> vertices;
+    planarHull(plane, coordinates, size, vertices, executor);
+
+    std::size_t count = vertices.size();
+
+    std::vector<glm::dvec2> points(count);
+
+    for (std::size_t i = 0; i < count; ++i)
+        points[i] = vertices[i].position;
+
+    glm::dvec2 corners[4];
+
+    if (count == 0)
+    {
+        std::fill(corners, corners + 4, glm::dvec2(0, 0));
+    }
+    else if (count < 3)
+    {
+        // A point or a segment.
+        corners[0] = corners[3] = points[0];
+        corners[1] = corners[2] = points[count - 1];
+    }
+    else
+    {
+        // Rotating calipers: the best rectangle has a side on a hull edge,
+        // and the extreme vertices for each edge advance around the hull.
+        auto next = [count](std::size_t i)
+        {
+            return i + 1 < count ? i + 1 : 0;
+        };
+
+        std::size_t right = 1;
+        std::size_t top = 1;
+        std::size_t left = 1;
+        double bestArea = std::numeric_limits<double>::max();
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const glm::dvec2& origin = points[i];
+            glm::dvec2 u = glm::normalize(points[next(i)] - origin);
+            glm::dvec2 v(-u.y, u.x);
+
+            while (glm::dot(points[next(right)] - points[right], u) > 0)
+                right = next(right);
+
+            if (i == 0)
+                top = right;
+
+            while (glm::dot(points[next(top)] - points[top], v) > 0)
+                top = next(top);
+
+            if (i == 0)
+                left = top;
+
+            while (glm::dot(points[next(left)] - points[left], u) < 0)
+                left = next(left);
+
+            double minU = glm::dot(points[left] - origin, u);
+            double maxU = glm::dot(points[right] - origin, u);
+            double height = glm::dot(points[top] - origin, v);
+            double area = (maxU - minU) * height;
+
+            if (area < bestArea)
+            {
+                bestArea = area;
+                corners[0] = origin + u * minU;
+                corners[1] = origin + u * maxU;
+                corners[2] = corners[1] + v * height;
+                corners[3] = corners[0] + v * height;
+            }
+        }
+    }
+
+    BoundingRectangle rectangle;
+
+    for (std::size_t i = 0; i < 4; ++i)
+        rectangle.corners[i] = plane.toCoordinate(corners[i]);
+
+    rectangle.center = plane.toCoordinate((corners[0] + corners[2]) * 0.5);
+
+    // Straight lines in the plane are great circles, so the center lines
+    // through the midpoints of opposite sides are measured on the sphere.
+    Coordinate start = plane.toCoordinate((corners[0] + corners[3]) * 0.5);
+    Coordinate end = plane.toCoordinate((corners[1] + corners[2]) * 0.5);
+
+    rectangle.length = GeoUtils::distanceHaversine(start, end);
+    rectangle.width = GeoUtils::distanceHaversine(plane.toCoordinate((corners[0] + corners[1]) * 0.5),
+                                                  plane.toCoordinate((corners[3] + corners[2]) * 0.5));
+
+    double bearing = rectangle.length > 0 ? GeoUtils::bearingHaversine(rectangle.center, end) : 0;
+    rectangle.bearing = bearing - 180.0 * std::floor(bearing / 180.0);
+
+    if (rectangle.bearing >= 180.0)
+        rectangle.bearing = 0;
+
+    return rectangle;
+}
+
+
+BoundingRectangle ConvexHull::boundingRectangle(const std::vector<Coordinate>& coordinates,
+                                                const Executor& executor)
+{
+    return boundingRectangle(coordinates.data(), coordinates.size(), executor);
+}
+
+
+} } // namespace ofx::Geo
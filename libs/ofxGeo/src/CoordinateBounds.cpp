@@ -6,6 +6,8 @@
 
 
 #include "ofx/Geo/CoordinateBounds.h"
+#include <algorithm>
+#include <cmath>
 
 
 namespace ofx {
@@ -22,10 +24,23 @@ CoordinateBounds::CoordinateBounds()
 
 
 CoordinateBounds::CoordinateBounds(const Coordinate& coordinate0,
-                                   const Coordinate& coordinate1)
+                                   const Coordinate& coordinate1):
+    _unset(false),
+    _minLatitude(std::min(coordinate0.getLatitude(), coordinate1.getLatitude())),
+    _maxLatitude(std::max(coordinate0.getLatitude(), coordinate1.getLatitude())),
+    _minLongitude(std::min(coordinate0.getLongitude(), coordinate1.getLongitude())),
+    _maxLongitude(std::max(coordinate0.getLongitude(), coordinate1.getLongitude()))
+{
+}
+
+
+CoordinateBounds::CoordinateBounds(double south, double west, double north, double east):
+    _unset(false),
+    _minLatitude(std::min(south, north)),
+    _maxLatitude(std::max(south, north)),
+    _minLongitude(west),
+    _maxLongitude(east)
 {
-    growToInclude(coordinate0);
-    growToInclude(coordinate1);
 }
 
 
@@ -34,29 +49,288 @@ CoordinateBounds::~CoordinateBounds()
 }
 
 
+namespace {
+
+
+/// \returns the eastward offset from one longitude to another in [0, 360).
+double offset(double from, double to)
+{
+    double delta = std::fmod(to - from, 360.0);
+    return delta < 0 ? delta + 360.0 : delta;
+}
+
+
+/// \returns the longitude wrapped to [-180, 180].
+double wrap(double longitude)
+{
+    while (longitude > 180)
+        longitude -= 360;
+
+    while (longitude < -180)
+        longitude += 360;
+
+    return longitude;
+}
+
+
+} // namespace
+
+
 void CoordinateBounds::growToInclude(const Coordinate& coordinate)
 {
+    double latitude = coordinate.getLatitude();
+    double longitude = coordinate.getLongitude();
+
     if (_unset)
     {
-        _minLatitude = coordinate.getLatitude();
-        _maxLatitude = coordinate.getLatitude();
-        _minLongitude = coordinate.getLongitude();
-        _maxLongitude = coordinate.getLongitude();
+        _minLatitude = latitude;
+        _maxLatitude = latitude;
+        _minLongitude = longitude;
+        _maxLongitude = longitude;
         _unset = false;
+        return;
     }
 
-    _minLatitude = std::min(coordinate.getLatitude(), _minLatitude);
-    _maxLatitude = std::max(coordinate.getLatitude(), _maxLatitude);
-    _minLongitude = std::min(coordinate.getLongitude(), _minLongitude);
-    _maxLongitude = std::max(coordinate.getLongitude(), _maxLongitude);
+    _minLatitude = std::min(latitude, _minLatitude);
+    _maxLatitude = std::max(latitude, _maxLatitude);
+
+    // A pole has every longitude.
+    if (std::abs(latitude) >= 90)
+        return;
 
+    if (_containsLongitude(_minLongitude, _maxLongitude, longitude))
+        return;
+
+    // Extend whichever edge is nearer. Both arcs sum to less than 360
+    // degrees, so the result never wraps onto itself.
+    if (offset(_maxLongitude, longitude) <= offset(longitude, _minLongitude))
+        _maxLongitude = longitude;
+    else
+        _minLongitude = longitude;
+}
+
+
+void CoordinateBounds::growToInclude(const CoordinateBounds& bounds)
+{
+    if (bounds._unset)
+        return;
+
+    if (_unset)
+    {
+        *this = bounds;
+        return;
+    }
+
+    _minLatitude = std::min(bounds._minLatitude, _minLatitude);
+    _maxLatitude = std::max(bounds._maxLatitude, _maxLatitude);
+
+    double widthA = getWidth();
+    double widthB = bounds.getWidth();
+
+    // Edges are copied from the inputs rather than recomputed, so the
+    // result contains both boxes exactly.
+    double west = _minLongitude;
+    double east = _maxLongitude;
+    double width = widthA;
+
+    if (widthA >= 360 || widthB >= 360)
+    {
+        width = 360;
+    }
+    else
+    {
+        // Positions relative to the other box's west edge.
+        double startB = offset(_minLongitude, bounds._minLongitude);
+        double startA = offset(bounds._minLongitude, _minLongitude);
+
+        if (startB <= widthA)
+        {
+            // B starts inside A.
+            if (startB + widthB > widthA)
+            {
+                east = bounds._maxLongitude;
+                width = startB + widthB;
+            }
+        }
+        else if (startA <= widthB)
+        {
+            // A starts inside B.
+            west = bounds._minLongitude;
+            east = bounds._maxLongitude;
+            width = widthB;
+
+            if (startA + widthA > widthB)
+            {
+                east = _maxLongitude;
+                width = startA + widthA;
+            }
+        }
+        else if (startB + widthB <= startA + widthA)
+        {
+            // Disjoint; join eastward from A to B.
+            east = bounds._maxLongitude;
+            width = startB + widthB;
+        }
+        else
+        {
+            // Disjoint; join eastward from B to A.
+            west = bounds._minLongitude;
+            width = startA + widthA;
+        }
+    }
+
+    if (width >= 360)
+    {
+        _minLongitude = -180;
+        _maxLongitude = 180;
+    }
+    else
+    {
+        _minLongitude = west;
+        _maxLongitude = east;
+    }
+}
+
+
+bool CoordinateBounds::contains(const Coordinate& coordinate) const
+{
+    if (_unset
+     || coordinate.getLatitude() < _minLatitude
+     || coordinate.getLatitude() > _maxLatitude)
+    {
+        return false;
+    }
+
+    return std::abs(coordinate.getLatitude()) >= 90
+        || _containsLongitude(_minLongitude, _maxLongitude, coordinate.getLongitude());
+}
+
+
+bool CoordinateBounds::contains(const CoordinateBounds& bounds) const
+{
+    if (_unset
+     || bounds._unset
+     || bounds._minLatitude < _minLatitude
+     || bounds._maxLatitude > _maxLatitude)
+    {
+        return false;
+    }
+
+    double width = getWidth();
+
+    // Allow for rounding when the boxes share an edge.
+    return width >= 360
+        || offset(_minLongitude, bounds._minLongitude) + bounds.getWidth() <= width + 1e-9;
+}
+
+
+bool CoordinateBounds::intersects(const CoordinateBounds& bounds) const
+{
+    if (_unset
+     || bounds._unset
+     || bounds._minLatitude > _maxLatitude
+     || bounds._maxLatitude < _minLatitude)
+    {
+        return false;
+    }
+
+    // Boxes that both reach the same pole meet there.
+    if ((_maxLatitude >= 90 && bounds._maxLatitude >= 90)
+     || (_minLatitude <= -90 && bounds._minLatitude <= -90))
+    {
+        return true;
+    }
+
+    return _containsLongitude(_minLongitude, _maxLongitude, bounds._minLongitude)
+        || _containsLongitude(bounds._minLongitude, bounds._maxLongitude, _minLongitude);
+}
+
+
+bool CoordinateBounds::isEmpty() const
+{
+    return _unset;
+}
+
+
+bool CoordinateBounds::crossesAntimeridian() const
+{
+    return !_unset && _minLongitude > _maxLongitude;
+}
+
+
+std::size_t CoordinateBounds::split(CoordinateBounds bounds[2]) const
+{
+    if (_unset)
+        return 0;
+
+    if (!crossesAntimeridian())
+    {
+        bounds[0] = *this;
+        return 1;
+    }
+
+    bounds[0] = CoordinateBounds(_minLatitude, _minLongitude, _maxLatitude, 180);
+    bounds[1] = CoordinateBounds(_minLatitude, -180, _maxLatitude, _maxLongitude);
+    return 2;
+}
+
+
+double CoordinateBounds::getSouth() const
+{
+    return southwest().getLatitude();
+}
+
+
+double CoordinateBounds::getWest() const
+{
+    return southwest().getLongitude();
+}
+
+
+double CoordinateBounds::getNorth() const
+{
+    return northeast().getLatitude();
+}
+
+
+double CoordinateBounds::getEast() const
+{
+    return northeast().getLongitude();
+}
+
+
+double CoordinateBounds::getWidth() const
+{
+    if (_unset)
+        return 0;
+
+    return _width(_minLongitude, _maxLongitude);
+}
+
+
+double CoordinateBounds::getHeight() const
+{
+    if (_unset)
+        return 0;
+
+    return _maxLatitude - _minLatitude;
+}
+
+
+Coordinate CoordinateBounds::getCenter() const
+{
+    if (_unset)
+        return Coordinate();
+
+    return Coordinate((_minLatitude + _maxLatitude) / 2.0,
+                      wrap(_minLongitude + getWidth() / 2.0));
 }
 
 
 Coordinate CoordinateBounds::northwest() const
 {
     if (_unset)
-        return MAXIMUM_BOUNDS.northeast();
+        return MAXIMUM_BOUNDS.northwest();
 
     return Coordinate(_maxLatitude, _minLongitude);
 }
@@ -89,10 +363,128 @@ Coordinate CoordinateBounds::northeast() const
 }
 
 
+CoordinateBounds CoordinateBounds::merge(const CoordinateBounds* bounds,
+                                         std::size_t size)
+{
+    CoordinateBounds result;
+
+    // Unwrap each box's longitudes into intervals on [-180, 180].
+    std::vector<std::pair<double, double>> intervals;
+    intervals.reserve(size * 2);
+
+    bool full = false;
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        const CoordinateBounds& b = bounds[i];
+
+        if (b._unset)
+            continue;
+
+        if (result._unset)
+        {
+            result._minLatitude = b._minLatitude;
+            result._maxLatitude = b._maxLatitude;
+            result._unset = false;
+        }
+
+        result._minLatitude = std::min(b._minLatitude, result._minLatitude);
+        result._maxLatitude = std::max(b._maxLatitude, result._maxLatitude);
+
+        double width = b.getWidth();
+
+        if (width >= 360)
+        {
+            full = true;
+        }
+        else if (b._minLongitude + width <= 180)
+        {
+            intervals.push_back(std::make_pair(b._minLongitude, b._minLongitude + width));
+        }
+        else
+        {
+            intervals.push_back(std::make_pair(b._minLongitude, 180.0));
+            intervals.push_back(std::make_pair(-180.0, b._minLongitude + width - 360));
+        }
+    }
+
+    if (result._unset)
+        return result;
+
+    result._minLongitude = -180;
+    result._maxLongitude = 180;
+
+    if (full)
+        return result;
+
+    std::sort(intervals.begin(), intervals.end());
+
+    // Join overlapping intervals.
+    std::vector<std::pair<double, double>> joined;
+
+    for (const auto& interval: intervals)
+    {
+        if (!joined.empty() && interval.first <= joined.back().second)
+            joined.back().second = std::max(joined.back().second, interval.second);
+        else
+            joined.push_back(interval);
+    }
+
+    // The box is the complement of the largest gap. The gap across the
+    // antimeridian wins ties, so boxes that need not wrap never do.
+    double largestGap = joined.front().first + 360 - joined.back().second;
+    std::size_t gapIndex = joined.size() - 1;
+
+    for (std::size_t i = 0; i + 1 < joined.size(); ++i)
+    {
+        double gap = joined[i + 1].first - joined[i].second;
+
+        if (gap > largestGap)
+        {
+            largestGap = gap;
+            gapIndex = i;
+        }
+    }
+
+    if (largestGap <= 0)
+        return result;
+
+    if (gapIndex == joined.size() - 1)
+    {
+        result._minLongitude = joined.front().first;
+        result._maxLongitude = joined.back().second;
+    }
+    else
+    {
+        result._minLongitude = joined[gapIndex + 1].first;
+        result._maxLongitude = joined[gapIndex].second;
+    }
+
+    return result;
+}
+
+
 std::string CoordinateBounds::toString(int precision) const
 {
     return southwest().toString(precision) + "," + northeast().toString(precision);
 }
 
 
+bool CoordinateBounds::_containsLongitude(double west, double east, double longitude)
+{
+    // Offsets are taken modulo 360, so -180 and 180 are the same meridian.
+    double width = _width(west, east);
+    return width >= 360 || offset(west, longitude) <= width;
+}
+
+
+double CoordinateBounds::_width(double west, double east)
+{
+    if (east - west >= 360)
+        return 360;
+
+    return offset(west, east);
+}
+
+
 } } // namespace ofx::Geo
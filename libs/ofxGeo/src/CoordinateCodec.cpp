@@ -0,0 +1,378 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofx/Geo/CoordinateCodec.h"
+#include <cmath>
+
+
+namespace ofx {
+namespace Geo {
+
+
+namespace {
+
+
+std::uint64_t zigzagEncode(std::int64_t value)
+{
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+
+std::int64_t zigzagDecode(std::uint64_t value)
+{
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+
+double scaleForPrecision(int precision)
+{
+    return std::pow(10.0, precision);
+}
+
+
+/// \brief Delta, zigzag and group varint encode quantized values.
+/// \tparam Quantize A function returning the quantized int64 value at an index.
+template <typename Quantize>
+void encodeGroups(std::size_t size, Quantize quantize, std::vector<std::uint8_t>& buffer)
+{
+    std::int64_t previous = 0;
+
+    for (std::size_t i = 0; i < size; i += 4)
+    {
+        std::size_t tagIndex = buffer.size();
+        buffer.push_back(0);
+
+        std::uint8_t tag = 0;
+
+        for (std::size_t j = 0; j < 4 && i + j < size; ++j)
+        {
+            std::int64_t value = quantize(i + j);
+            std::uint64_t delta = zigzagEncode(value - previous);
+            previous = value;
+
+            unsigned code = delta < (std::uint64_t(1) << 8) ? 0
+                          : delta < (std::uint64_t(1) << 16) ? 1
+                          : delta < (std::uint64_t(1) << 32) ? 2 : 3;
+
+            tag |= static_cast<std::uint8_t>(code << (2 * j));
+
+            for (std::size_t b = 0; b < (std::size_t(1) << code); ++b)
+                buffer.push_back(static_cast<std::uint8_t>(delta >> (8 * b)));
+        }
+
+        buffer[tagIndex] = tag;
+    }
+}
+
+
+/// \brief Decode values written by encodeGroups().
+/// \tparam Store A function storing the int64 value at an index.
+template <typename Store>
+bool decodeGroups(const std::uint8_t*& data,
+                  const std::uint8_t* end,
+                  std::size_t size,
+                  Store store)
+{
+    std::int64_t previous = 0;
+
+    for (std::size_t i = 0; i < size; i += 4)
+    {
+        if (data == end)
+            return false;
+
+        std::uint8_t tag = *data++;
+
+        for (std::size_t j = 0; j < 4 && i + j < size; ++j)
+        {
+            std::size_t length = std::size_t(1) << ((tag >> (2 * j)) & 3);
+
+            if (std::size_t(end - data) < length)
+                return false;
+
+            std::uint64_t delta = 0;
+
+            for (std::size_t b = 0; b < length; ++b)
+                delta |= std::uint64_t(data[b]) << (8 * b);
+
+            data += length;
+            previous += zigzagDecode(delta);
+            store(i + j, previous);
+        }
+    }
+
+    return true;
+}
+
+
+void writeVarint(std::uint64_t value, std::vector<std::uint8_t>& buffer)
+{
+    while (value >= 0x80)
+    {
+        buffer.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+
+    buffer.push_back(static_cast<std::uint8_t>(value));
+}
+
+
+bool readVarint(const std::uint8_t*& data, const std::uint8_t* end, std::uint64_t& value)
+{
+    value = 0;
+    int shift = 0;
+
+    do
+    {
+        if (data == end || shift > 63)
+            return false;
+
+        value |= static_cast<std::uint64_t>(*data & 0x7f) << shift;
+        shift += 7;
+    }
+    while (*data++ & 0x80);
+
+    return true;
+}
+
+
+void writeHeader(CoordinateCodec::Type type,
+                 int precision,
+                 int secondaryPrecision,
+                 std::size_t size,
+                 std::vector<std::uint8_t>& buffer)
+{
+    buffer.push_back(type);
+    buffer.push_back(static_cast<std::uint8_t>(precision));
+    buffer.push_back(static_cast<std::uint8_t>(secondaryPrecision));
+    writeVarint(size, buffer);
+}
+
+
+bool readHeader(CoordinateCodec::Type type,
+                const std::uint8_t*& data,
+                const std::uint8_t* end,
+                int& precision,
+                int& secondaryPrecision,
+                std::size_t& size)
+{
+    if (end - data < 3 || data[0] != type)
+        return false;
+
+    precision = data[1];
+    secondaryPrecision = data[2];
+    data += 3;
+
+    std::uint64_t count = 0;
+
+    // Every value needs at least one byte, which bounds a corrupt count.
+    if (!readVarint(data, end, count) || count > std::uint64_t(end - data))
+        return false;
+
+    size = static_cast<std::size_t>(count);
+
+    return precision <= CoordinateCodec::MAX_PRECISION
+        && secondaryPrecision <= CoordinateCodec::MAX_PRECISION;
+}
+
+
+int clampPrecision(int precision)
+{
+    return std::max(0, std::min(precision, CoordinateCodec::MAX_PRECISION));
+}
+
+
+} // namespace
+
+
+const int CoordinateCodec::DEFAULT_PRECISION = 7;
+const int CoordinateCodec::DEFAULT_ELEVATION_PRECISION = 2;
+const int CoordinateCodec::DEFAULT_UTM_PRECISION = 2;
+const int CoordinateCodec::MAX_PRECISION = 9;
+
+
+void CoordinateCodec::encode(const Coordinate* coordinates,
+                             std::size_t size,
+                             std::vector<std::uint8_t>& buffer,
+                             int precision)
+{
+    precision = clampPrecision(precision);
+    double scale = scaleForPrecision(precision);
+
+    writeHeader(COORDINATE, precision, 0, size, buffer);
+
+    encodeGroups(size, [&](std::size_t i) {
+        return std::llround(coordinates[i].getLatitude() * scale);
+    }, buffer);
+
+    encodeGroups(size, [&](std::size_t i) {
+        return std::llround(coordinates[i].getLongitude() * scale);
+    }, buffer);
+}
+
+
+void CoordinateCodec::encode(const ElevatedCoordinate* coordinates,
+                             std::size_t size,
+                             std::vector<std::uint8_t>& buffer,
+                             int precision,
+                             int elevationPrecision)
+{
+    precision = clampPrecision(precision);
+    elevationPrecision = clampPrecision(elevationPrecision);
+    double scale = scaleForPrecision(precision);
+    double elevationScale = scaleForPrecision(elevationPrecision);
+
+    writeHeader(ELEVATED_COORDINATE, precision, elevationPrecision, size, buffer);
+
+    encodeGroups(size, [&](std::size_t i) {
+        return std::llround(coordinates[i].getLatitude() * scale);
+    }, buffer);
+
+    encodeGroups(size, [&](std::size_t i) {
+        return std::llround(coordinates[i].getLongitude() * scale);
+    }, buffer);
+
+    encodeGroups(size, [&](std::size_t i) {
+        return std::llround(coordinates[i].getElevation() * elevationScale);
+    }, buffer);
+}
+
+
+void CoordinateCodec::encode(const UTMPoint* points,
+                             std::size_t size,
+                             std::vector<std::uint8_t>& buffer,
+                             int precision)
+{
+    precision = clampPrecision(precision);
+    double scale = scaleForPrecision(precision);
+
+    writeHeader(UTM_POINT, precision, 0, size, buffer);
+
+    encodeGroups(size, [&](std::size_t i) {
+        return std::llround(points[i].easting * scale);
+    }, buffer);
+
+    encodeGroups(size, [&](std::size_t i) {
+        return std::llround(points[i].northing * scale);
+    }, buffer);
+
+    // Zone number, band and hemisphere rarely change along a track, so they
+    // share one column that packs to a single zero byte per point.
+    encodeGroups(size, [&](std::size_t i) {
+        return std::int64_t(points[i].zoneNumber) << 16
+             | std::int64_t(std::uint8_t(points[i].band)) << 8
+             | std::int64_t(std::uint8_t(points[i].hemisphere));
+    }, buffer);
+}
+
+
+bool CoordinateCodec::decode(const std::uint8_t* data,
+                             std::size_t byteSize,
+                             std::vector<Coordinate>& coordinates)
+{
+    const std::uint8_t* end = data + byteSize;
+
+    int precision = 0;
+    int unused = 0;
+    std::size_t size = 0;
+
+    if (!readHeader(COORDINATE, data, end, precision, unused, size))
+        return false;
+
+    double scale = scaleForPrecision(precision);
+
+    coordinates.resize(size);
+
+    return decodeGroups(data, end, size, [&](std::size_t i, std::int64_t value) {
+        coordinates[i].setLatitude(value / scale);
+    }) && decodeGroups(data, end, size, [&](std::size_t i, std::int64_t value) {
+        coordinates[i].setLongitude(value / scale);
+    });
+}
+
+
+bool CoordinateCodec::decode(const std::uint8_t* data,
+                             std::size_t byteSize,
+                             std::vector<ElevatedCoordinate>& coordinates)
+{
+    const std::uint8_t* end = data + byteSize;
+
+    int precision = 0;
+    int elevationPrecision = 0;
+    std::size_t size = 0;
+
+    if (!readHeader(ELEVATED_COORDINATE, data, end, precision, elevationPrecision, size))
+        return false;
+
+    double scale = scaleForPrecision(precision);
+    double elevationScale = scaleForPrecision(elevationPrecision);
+
+    coordinates.resize(size);
+
+    return decodeGroups(data, end, size, [&](std::size_t i, std::int64_t value) {
+        coordinates[i].setLatitude(value / scale);
+    }) && decodeGroups(data, end, size, [&](std::size_t i, std::int64_t value) {
+        coordinates[i].setLongitude(value / scale);
+    }) && decodeGroups(data, end, size, [&](std::size_t i, std::int64_t value) {
+        coordinates[i].setElevation(value / elevationScale);
+    });
+}
+
+
+bool CoordinateCodec::decode(const std::uint8_t* data,
+                             std::size_t byteSize,
+                             std::vector<UTMPoint>& points)
+{
+    const std::uint8_t* end = data + byteSize;
+
+    int precision = 0;
+    int unused = 0;
+    std::size_t size = 0;
+
+    if (!readHeader(UTM_POINT, data, end, precision, unused, size))
+        return false;
+
+    double scale = scaleForPrecision(precision);
+
+    points.resize(size);
+
+    return decodeGroups(data, end, size, [&](std::size_t i, std::int64_t value) {
+        points[i].easting = value / scale;
+    }) && decodeGroups(data, end, size, [&](std::size_t i, std::int64_t value) {
+        points[i].northing = value / scale;
+    }) && decodeGroups(data, end, size, [&](std::size_t i, std::int64_t value) {
+        points[i].zoneNumber = static_cast<int>(value >> 16);
+        points[i].band = static_cast<char>((value >> 8) & 0xff);
+        points[i].hemisphere = (value & 0xff) == UTMPoint::SOUTHERN ? UTMPoint::SOUTHERN
+                                                                   : UTMPoint::NORTHERN;
+    });
+}
+
+
+void CoordinateCodec::encodeColumn(const double* values,
+                                   std::size_t size,
+                                   double scale,
+                                   std::vector<std::uint8_t>& buffer)
+{
+    encodeGroups(size, [&](std::size_t i) {
+        return std::llround(values[i] * scale);
+    }, buffer);
+}
+
+
+bool CoordinateCodec::decodeColumn(const std::uint8_t*& data,
+                                   const std::uint8_t* end,
+                                   double scale,
+                                   double* values,
+                                   std::size_t size)
+{
+    return decodeGroups(data, end, size, [&](std::size_t i, std::int64_t value) {
+        values[i] = value / scale;
+    });
+}
+
+
+} } // namespace ofx::Geo
@@ -6,6 +6,8 @@
 
 
 #include "ofx/Geo/CoordinatePolyline.h"
+#include "ofx/Geo/GeoUtils.h"
+#include "ofx/Geo/GreatCircleArc.h"
 
 
 namespace ofx {
@@ -14,13 +16,123 @@ namespace Geo {
 
 CoordinatePolyline::CoordinatePolyline()
 {
+}
+
 
+CoordinatePolyline::CoordinatePolyline(const std::vector<Coordinate>& coordinates):
+    _coordinates(coordinates)
+{
 }
 
 
 CoordinatePolyline::~CoordinatePolyline()
 {
+}
+
+
+void CoordinatePolyline::addVertex(const Coordinate& coordinate)
+{
+    _coordinates.push_back(coordinate);
+}
+
+
+void CoordinatePolyline::addVertices(const std::vector<Coordinate>& coordinates)
+{
+    _coordinates.insert(_coordinates.end(), coordinates.begin(), coordinates.end());
+}
+
+
+void CoordinatePolyline::clear()
+{
+    _coordinates.clear();
+}
+
+
+void CoordinatePolyline::reserve(std::size_t size)
+{
+    _coordinates.reserve(size);
+}
+
+
+std::size_t CoordinatePolyline::size() const
+{
+    return _coordinates.size();
+}
+
+
+bool CoordinatePolyline::empty() const
+{
+    return _coordinates.empty();
+}
+
+
+const Coordinate& CoordinatePolyline::operator [] (std::size_t index) const
+{
+    return _coordinates[index];
+}
+
 
+const std::vector<Coordinate>& CoordinatePolyline::getVertices() const
+{
+    return _coordinates;
+}
+
+
+std::vector<Coordinate>& CoordinatePolyline::getVertices()
+{
+    return _coordinates;
+}
+
+
+double CoordinatePolyline::getLength() const
+{
+    double length = 0;
+
+    for (std::size_t i = 1; i < _coordinates.size(); ++i)
+        length += GeoUtils::distanceHaversine(_coordinates[i - 1], _coordinates[i]);
+
+    return length;
+}
+
+
+CoordinateBounds CoordinatePolyline::getBounds() const
+{
+    CoordinateBounds bounds;
+
+    for (const auto& coordinate: _coordinates)
+        bounds.growToInclude(coordinate);
+
+    return bounds;
+}
+
+
+CoordinatePolyline CoordinatePolyline::getDensified(double maxSegmentLength) const
+{
+    CoordinatePolyline polyline;
+
+    for (std::size_t i = 1; i < _coordinates.size(); ++i)
+    {
+        GreatCircleArc(_coordinates[i - 1], _coordinates[i]).densify(maxSegmentLength,
+                                                                     polyline._coordinates,
+                                                                     false);
+    }
+
+    if (!_coordinates.empty())
+        polyline.addVertex(_coordinates.back());
+
+    return polyline;
+}
+
+
+CoordinatePolyline::const_iterator CoordinatePolyline::begin() const
+{
+    return _coordinates.begin();
+}
+
+
+CoordinatePolyline::const_iterator CoordinatePolyline::end() const
+{
+    return _coordinates.end();
 }
 
 
@@ -0,0 +1,168 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofx/Geo/CoordinateTrack.h"
+#include "ofx/Geo/GeoUtils.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+CoordinateTrack::CoordinateTrack(double statisticsWindow):
+    _speedStatistics(statisticsWindow),
+    _climbRateStatistics(statisticsWindow)
+{
+}
+
+
+CoordinateTrack::~CoordinateTrack()
+{
+}
+
+
+void CoordinateTrack::add(const ElevatedCoordinate& coordinate, double time)
+{
+    TrackSegment segment = { 0, 0, 0, 0, 0, 0 };
+
+    if (!_segments.empty())
+    {
+        std::size_t last = _segments.size() - 1;
+        const TrackSegment& previous = _segments[last];
+
+        segment.distance = GeoUtils::distanceHaversine(_polyline[last], coordinate);
+        segment.duration = time - _times[last];
+        segment.heading = GeoUtils::bearingHaversine(_polyline[last], coordinate);
+
+        if (segment.duration > 0)
+        {
+            segment.speed = segment.distance * 1000.0 / segment.duration;
+            segment.climbRate = (coordinate.getElevation() - _elevations[last]) / segment.duration;
+            segment.acceleration = last > 0 ? (segment.speed - previous.speed) / segment.duration : 0;
+        }
+        else
+        {
+            segment.speed = previous.speed;
+            segment.climbRate = previous.climbRate;
+            segment.acceleration = previous.acceleration;
+        }
+
+        _distance += segment.distance;
+
+        _speedStatistics.add(time, segment.speed);
+        _climbRateStatistics.add(time, segment.climbRate);
+    }
+
+    _polyline.addVertex(coordinate);
+    _elevations.push_back(coordinate.getElevation());
+    _times.push_back(time);
+    _segments.push_back(segment);
+}
+
+
+void CoordinateTrack::clear()
+{
+    _polyline.clear();
+    _elevations.clear();
+    _times.clear();
+    _segments.clear();
+    _distance = 0;
+    _speedStatistics.clear();
+    _climbRateStatistics.clear();
+}
+
+
+void CoordinateTrack::reserve(std::size_t size)
+{
+    _polyline.reserve(size);
+    _elevations.reserve(size);
+    _times.reserve(size);
+    _segments.reserve(size);
+}
+
+
+std::size_t CoordinateTrack::size() const
+{
+    return _times.size();
+}
+
+
+bool CoordinateTrack::empty() const
+{
+    return _times.empty();
+}
+
+
+const CoordinatePolyline& CoordinateTrack::getPolyline() const
+{
+    return _polyline;
+}
+
+
+ElevatedCoordinate CoordinateTrack::getCoordinate(std::size_t index) const
+{
+    return ElevatedCoordinate(_polyline[index].getLatitude(),
+                              _polyline[index].getLongitude(),
+                              _elevations[index]);
+}
+
+
+double CoordinateTrack::getTime(std::size_t index) const
+{
+    return _times[index];
+}
+
+
+const TrackSegment& CoordinateTrack::getSegment(std::size_t index) const
+{
+    return _segments[index];
+}
+
+
+const std::vector<double>& CoordinateTrack::getElevations() const
+{
+    return _elevations;
+}
+
+
+const std::vector<double>& CoordinateTrack::getTimes() const
+{
+    return _times;
+}
+
+
+const std::vector<TrackSegment>& CoordinateTrack::getSegments() const
+{
+    return _segments;
+}
+
+
+double CoordinateTrack::getDistance() const
+{
+    return _distance;
+}
+
+
+double CoordinateTrack::getDuration() const
+{
+    return _times.empty() ? 0 : _times.back() - _times.front();
+}
+
+
+const RollingStatistics& CoordinateTrack::getSpeedStatistics() const
+{
+    return _speedStatistics;
+}
+
+
+const RollingStatistics& CoordinateTrack::getClimbRateStatistics() const
+{
+    return _climbRateStatistics;
+}
+
+
+} } // namespace ofx::Geo
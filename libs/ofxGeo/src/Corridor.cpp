@@ -0,0 +1,546 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofx/Geo/Corridor.h"
+#include <algorithm>
+#include <cmath>
+#include "ofx/Geo/GeoUtils.h"
+#include "ofx/Geo/SegmentIntersector.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+namespace {
+
+
+/// \brief A route segment that reaches a grid cell.
+struct Entry
+{
+    uint64_t key;
+    uint32_t segment;
+    bool inside;
+};
+
+
+/// \returns the grid key of a column and row.
+uint64_t cellKey(int64_t column, int64_t row)
+{
+    return (uint64_t(uint32_t(row)) << 32) | uint64_t(uint32_t(column));
+}
+
+
+/// \returns the cross product of two vectors.
+double cross(const glm::dvec2& v0, const glm::dvec2& v1)
+{
+    return v0.x * v1.y - v0.y * v1.x;
+}
+
+
+/// \returns the squared distance from a point to a segment.
+double distanceSquared(const glm::dvec2& p, const glm::dvec2& a, const glm::dvec2& b)
+{
+    glm::dvec2 ab = b - a;
+    glm::dvec2 ap = p - a;
+    double lengthSquared = ab.x * ab.x + ab.y * ab.y;
+    double t = lengthSquared > 0 ? (ap.x * ab.x + ap.y * ab.y) / lengthSquared : 0;
+    glm::dvec2 delta = ap - ab * std::max(0.0, std::min(1.0, t));
+    return delta.x * delta.x + delta.y * delta.y;
+}
+
+
+/// \returns the squared distance from a segment to a box.
+double distanceSquared(const glm::dvec2& a,
+                       const glm::dvec2& b,
+                       const glm::dvec2& min,
+                       const glm::dvec2& max)
+{
+    // Clip the segment to the box; any part left means they touch.
+    double t0 = 0;
+    double t1 = 1;
+    glm::dvec2 delta = b - a;
+
+    auto clip = [&](double p, double q)
+    {
+        if (p == 0)
+            return q >= 0;
+
+        double r = q / p;
+
+        if (p < 0)
+            t0 = std::max(t0, r);
+        else
+            t1 = std::min(t1, r);
+
+        return t0 <= t1;
+    };
+
+    if (clip(-delta.x, a.x - min.x)
+     && clip(delta.x, max.x - a.x)
+     && clip(-delta.y, a.y - min.y)
+     && clip(delta.y, max.y - a.y))
+    {
+        return 0;
+    }
+
+    // Otherwise the closest points include an end point or a box corner.
+    glm::dvec2 clampedA = glm::clamp(a, min, max);
+    glm::dvec2 clampedB = glm::clamp(b, min, max);
+
+    double result = std::min(glm::dot(a - clampedA, a - clampedA),
+                             glm::dot(b - clampedB, b - clampedB));
+
+    result = std::min(result, distanceSquared(min, a, b));
+    result = std::min(result, distanceSquared(max, a, b));
+    result = std::min(result, distanceSquared(glm::dvec2(min.x, max.y), a, b));
+    result = std::min(result, distanceSquared(glm::dvec2(max.x, min.y), a, b));
+
+    return result;
+}
+
+
+/// \returns the unit normal on the right of a direction.
+glm::dvec2 rightNormal(const glm::dvec2& direction)
+{
+    return glm::normalize(glm::dvec2(direction.y, -direction.x));
+}
+
+
+/// \brief Append an arc, including both of its end points.
+/// \param center The center of the arc.
+/// \param radius The radius of the arc.
+/// \param from The unit vector from the center to the start of the arc.
+/// \param sweep The counterclockwise angle of the arc in radians.
+/// \param step The largest angle between vertices in radians.
+/// \param ring The vector the vertices are appended to.
+void appendArc(const glm::dvec2& center,
+               double radius,
+               const glm::dvec2& from,
+               double sweep,
+               double step,
+               std::vector<glm::dvec2>& ring)
+{
+    double angle = std::atan2(from.y, from.x);
+    int steps = std::max(1, int(std::ceil(sweep / step - 1e-9)));
+
+    for (int i = 0; i <= steps; ++i)
+    {
+        double a = angle + sweep * i / steps;
+        ring.push_back(center + radius * glm::dvec2(std::cos(a), std::sin(a)));
+    }
+}
+
+
+/// \brief Append the right side of a route and the cap at its end.
+///
+/// The first offset vertex is left out; it ends the cap of the side traced
+/// before this one.
+///
+/// \param points The route, with no repeated vertices.
+/// \param radius The distance from the route.
+/// \param step The largest arc angle between vertices in radians.
+/// \param ring The vector the vertices are appended to.
+void traceSide(const std::vector<glm::dvec2>& points,
+               double radius,
+               double step,
+               std::vector<glm::dvec2>& ring)
+{
+    std::size_t last = points.size() - 1;
+
+    for (std::size_t i = 1; i < last; ++i)
+    {
+        glm::dvec2 d0 = points[i] - points[i - 1];
+        glm::dvec2 d1 = points[i + 1] - points[i];
+        glm::dvec2 n0 = rightNormal(d0);
+        glm::dvec2 n1 = rightNormal(d1);
+
+        double turn = cross(d0, d1);
+        double dot = glm::dot(d0, d1);
+
+        if (turn > 0 || (turn == 0 && dot < 0))
+        {
+            // Turning left, the right side is outside the turn; join round.
+            double sweep = turn == 0 ? glm::pi<double>() : std::atan2(turn, dot);
+            appendArc(points[i], radius, n0, sweep, step, ring);
+        }
+        else if (turn == 0)
+        {
+            ring.push_back(points[i] + radius * n0);
+        }
+        else
+        {
+            // Inside the turn, the offset segments meet at a corner.
+            glm::dvec2 a0 = points[i - 1] + radius * n0;
+            glm::dvec2 b0 = points[i] + radius * n0;
+            glm::dvec2 a1 = points[i] + radius * n1;
+            glm::dvec2 b1 = points[i + 1] + radius * n1;
+
+            glm::dvec2 r = b0 - a0;
+            glm::dvec2 s = b1 - a1;
+            double denominator = cross(r, s);
+            double t = cross(a1 - a0, s) / denominator;
+            double u = cross(a1 - a0, r) / denominator;
+
+            if (denominator != 0 && t >= 0 && t <= 1 && u >= 0 && u <= 1)
+            {
+                ring.push_back(a0 + t * r);
+            }
+            else
+            {
+                // Short segments; the raw ends fall inside the corridor and
+                // are removed with the other inner vertices.
+                ring.push_back(b0);
+                ring.push_back(a1);
+            }
+        }
+    }
+
+    glm::dvec2 n = rightNormal(points[last] - points[last - 1]);
+    appendArc(points[last], radius, n, glm::pi<double>(), step, ring);
+}
+
+
+} // namespace
+
+
+const int Corridor::DEFAULT_QUADRANT_SEGMENTS = 8;
+
+
+Corridor::Corridor()
+{
+}
+
+
+Corridor::Corridor(const CoordinatePolyline& route,
+                   double distance,
+                   int quadrantSegments)
+{
+    setRoute(route, distance, quadrantSegments);
+}
+
+
+Corridor::~Corridor()
+{
+}
+
+
+void Corridor::setRoute(const CoordinatePolyline& route,
+                        double distance,
+                        int quadrantSegments)
+{
+    _route = route;
+    _distance = distance;
+    _outline.clear();
+    _outlineValid = true;
+    _points.clear();
+    _cells.clear();
+    _cellSegments.clear();
+
+    if (route.empty() || !(distance > 0))
+        return;
+
+    _center = GeoUtils::toUTMPoint(route.getBounds().getCenter());
+    _points.reserve(route.size());
+
+    for (const Coordinate& coordinate: route)
+    {
+        glm::dvec2 position = _project(coordinate);
+
+        if (_points.empty() || position != _points.back())
+            _points.push_back(position);
+    }
+
+    if (_points.size() == 1)
+        _points.push_back(_points.back());
+
+    _buildGrid();
+    _buildOutline(std::max(1, quadrantSegments));
+}
+
+
+const CoordinatePolyline& Corridor::getRoute() const
+{
+    return _route;
+}
+
+
+double Corridor::getDistance() const
+{
+    return _distance;
+}
+
+
+const CoordinatePolyline& Corridor::getOutline() const
+{
+    return _outline;
+}
+
+
+bool Corridor::isOutlineValid() const
+{
+    return _outlineValid;
+}
+
+
+bool Corridor::contains(const Coordinate& coordinate) const
+{
+    if (_points.empty())
+        return false;
+
+    return _within(_project(coordinate), _distance);
+}
+
+
+void Corridor::contains(const Coordinate* coordinates,
+                        std::size_t size,
+                        bool* results,
+                        const Executor& executor) const
+{
+    executor.run(size, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+            results[i] = contains(coordinates[i]);
+    });
+}
+
+
+glm::dvec2 Corridor::_project(const Coordinate& coordinate) const
+{
+    UTMPoint point = GeoUtils::toUTMPoint(coordinate,
+                                          _center.zoneNumber,
+                                          _center.hemisphere);
+
+    return glm::dvec2(point.easting, point.northing);
+}
+
+
+uint64_t Corridor::_key(const glm::dvec2& position) const
+{
+    glm::dvec2 cell = glm::floor((position - _gridOrigin) / _cellSize);
+    return cellKey(int64_t(cell.x), int64_t(cell.y));
+}
+
+
+void Corridor::_buildGrid()
+{
+    double radius = _distance;
+    double radiusSquared = radius * radius;
+    std::size_t numSegments = _points.size() - 1;
+
+    double length = 0;
+    glm::dvec2 min = _points[0];
+    glm::dvec2 max = _points[0];
+
+    for (std::size_t i = 0; i < _points.size(); ++i)
+    {
+        if (i > 0)
+            length += glm::distance(_points[i - 1], _points[i]);
+
+        min = glm::min(min, _points[i]);
+        max = glm::max(max, _points[i]);
+    }
+
+    _gridOrigin = min - glm::dvec2(radius, radius);
+    _gridMax = max + glm::dvec2(radius, radius);
+
+    // Cells half the distance across leave most of the corridor in inside
+    // cells. The other bounds keep the number of cells near the route to a
+    // small multiple of the number of segments, and keys within 32 bits.
+    double extent = std::max(_gridMax.x - _gridOrigin.x, _gridMax.y - _gridOrigin.y);
+    double budget = 8.0 * double(numSegments);
+
+    _cellSize = std::max({ radius / 2.0,
+                           std::sqrt(2.0 * length * radius / budget),
+                           length / budget,
+                           extent / 1e9 });
+
+    std::vector<Entry> entries;
+
+    for (std::size_t i = 0; i < numSegments; ++i)
+    {
+        const glm::dvec2& a = _points[i];
+        const glm::dvec2& b = _points[i + 1];
+
+        int64_t row0 = int64_t(std::floor((std::min(a.y, b.y) - radius - _gridOrigin.y) / _cellSize));
+        int64_t row1 = int64_t(std::floor((std::max(a.y, b.y) + radius - _gridOrigin.y) / _cellSize));
+
+        for (int64_t row = row0; row <= row1; ++row)
+        {
+            double y0 = _gridOrigin.y + double(row) * _cellSize;
+            double y1 = y0 + _cellSize;
+
+            // The part of the segment that can reach the row.
+            double t0 = 0;
+            double t1 = 1;
+
+            if (a.y != b.y)
+            {
+                double ta = (y0 - radius - a.y) / (b.y - a.y);
+                double tb = (y1 + radius - a.y) / (b.y - a.y);
+                t0 = std::max(t0, std::min(ta, tb));
+                t1 = std::min(t1, std::max(ta, tb));
+
+                if (t0 > t1)
+                    continue;
+            }
+
+            double x0 = a.x + t0 * (b.x - a.x);
+            double x1 = a.x + t1 * (b.x - a.x);
+
+            int64_t column0 = int64_t(std::floor((std::min(x0, x1) - radius - _gridOrigin.x) / _cellSize));
+            int64_t column1 = int64_t(std::floor((std::max(x0, x1) + radius - _gridOrigin.x) / _cellSize));
+
+            for (int64_t column = column0; column <= column1; ++column)
+            {
+                glm::dvec2 cellMin(_gridOrigin.x + double(column) * _cellSize, y0);
+                glm::dvec2 cellMax(cellMin.x + _cellSize, y1);
+
+                if (distanceSquared(a, b, cellMin, cellMax) > radiusSquared)
+                    continue;
+
+                // Distance to a segment is convex, so it peaks at a corner.
+                bool inside = distanceSquared(cellMin, a, b) <= radiusSquared
+                           && distanceSquared(cellMax, a, b) <= radiusSquared
+                           && distanceSquared(glm::dvec2(cellMin.x, cellMax.y), a, b) <= radiusSquared
+                           && distanceSquared(glm::dvec2(cellMax.x, cellMin.y), a, b) <= radiusSquared;
+
+                entries.push_back(Entry{ cellKey(column, row), uint32_t(i), inside });
+            }
+        }
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& e0, const Entry& e1)
+    {
+        return e0.key < e1.key || (e0.key == e1.key && e0.segment < e1.segment);
+    });
+
+    _cellSegments.reserve(entries.size());
+
+    for (std::size_t i = 0; i < entries.size(); )
+    {
+        Cell cell;
+        cell.begin = uint32_t(_cellSegments.size());
+        cell.inside = false;
+
+        uint64_t key = entries[i].key;
+
+        for (; i < entries.size() && entries[i].key == key; ++i)
+        {
+            _cellSegments.push_back(entries[i].segment);
+            cell.inside = cell.inside || entries[i].inside;
+        }
+
+        cell.end = uint32_t(_cellSegments.size());
+        _cells.emplace(key, cell);
+    }
+}
+
+
+void Corridor::_buildOutline(int quadrantSegments)
+{
+    double radius = _distance;
+    double step = glm::half_pi<double>() / quadrantSegments;
+
+    std::vector<glm::dvec2> ring;
+
+    if (_points[0] == _points[1])
+    {
+        appendArc(_points[0], radius, glm::dvec2(1, 0), glm::two_pi<double>(), step, ring);
+        ring.pop_back();
+    }
+    else
+    {
+        traceSide(_points, radius, step, ring);
+        traceSide(std::vector<glm::dvec2>(_points.rbegin(), _points.rend()), radius, step, ring);
+    }
+
+    // Keep the vertices on the boundary, and drop repeats left behind.
+    double boundary = radius * (1.0 - 1e-9);
+    std::vector<UTMPoint> points;
+    points.reserve(ring.size());
+
+    for (const glm::dvec2& position: ring)
+    {
+        if (_within(position, boundary))
+            continue;
+
+        if (!points.empty()
+         && points.back().easting == position.x
+         && points.back().northing == position.y)
+        {
+            continue;
+        }
+
+        UTMPoint point = _center;
+        point.easting = position.x;
+        point.northing = position.y;
+        points.push_back(point);
+    }
+
+    if (points.size() > 1
+     && points.back().easting == points.front().easting
+     && points.back().northing == points.front().northing)
+    {
+        points.pop_back();
+    }
+
+    std::vector<Coordinate>& vertices = _outline.getVertices();
+    vertices.resize(points.size());
+    GeoUtils::toCoordinate(points.data(), points.size(), vertices.data());
+
+    // Where the corridor closes around a hole, dropping the inner vertices
+    // joins the outer and inner boundaries with edges that cut through the
+    // corridor, or leaves a ring that crosses itself. Arc chords dip inside
+    // by their sagitta, so an edge whose midpoint is any deeper cuts through.
+    double depth = radius * std::cos(step / 2.0) * (1.0 - 1e-9);
+
+    for (std::size_t i = 0; i < points.size() && _outlineValid; ++i)
+    {
+        const UTMPoint& p0 = points[i];
+        const UTMPoint& p1 = points[(i + 1) % points.size()];
+        glm::dvec2 midpoint((p0.easting + p1.easting) / 2.0,
+                            (p0.northing + p1.northing) / 2.0);
+
+        _outlineValid = !_within(midpoint, depth);
+    }
+
+    _outlineValid = _outlineValid && !SegmentIntersector::hasSelfIntersection(_outline, true);
+}
+
+
+bool Corridor::_within(const glm::dvec2& position, double distance) const
+{
+    if (position.x < _gridOrigin.x || position.y < _gridOrigin.y
+     || position.x > _gridMax.x || position.y > _gridMax.y)
+    {
+        return false;
+    }
+
+    auto cell = _cells.find(_key(position));
+
+    if (cell == _cells.end())
+        return false;
+
+    if (cell->second.inside && distance >= _distance)
+        return true;
+
+    double maxDistanceSquared = distance * distance;
+
+    for (uint32_t i = cell->second.begin; i < cell->second.end; ++i)
+    {
+        uint32_t segment = _cellSegments[i];
+
+        if (Geo::distanceSquared(position, _points[segment], _points[segment + 1]) <= maxDistanceSquared)
+            return true;
+    }
+
+    return false;
+}
+
+
+} } // namespace ofx::Geo
@@ -0,0 +1,248 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofx/Geo/ElevationProfile.h"
+#include <algorithm>
+#include <cmath>
+#include "ofx/Geo/GeoUtils.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+const double ElevationProfile::DEFAULT_THRESHOLD = 5;
+
+
+ElevationProfile::ElevationProfile(double threshold, double interval):
+    _threshold(std::max(0.0, threshold)),
+    _interval(std::max(0.0, interval))
+{
+}
+
+
+ElevationProfile::~ElevationProfile()
+{
+}
+
+
+void ElevationProfile::add(const ElevatedCoordinate& coordinate)
+{
+    double elevation = coordinate.getElevation();
+
+    if (_count == 0)
+    {
+        _anchor = elevation;
+        _extreme = elevation;
+        _minimumElevation = elevation;
+        _maximumElevation = elevation;
+
+        if (_interval > 0)
+            _samples.push_back(ProfileSample{ 0, elevation });
+    }
+    else
+    {
+        double run = GeoUtils::distanceHaversine(_previous, coordinate) * 1000.0;
+        double rise = elevation - _previous.getElevation();
+        double start = _distance;
+
+        _segmentLength = std::sqrt(run * run + rise * rise);
+        _segmentGrade = run > 0 ? rise / run : 0;
+        _distance += run;
+        _length += _segmentLength;
+
+        if (_interval > 0 && run > 0)
+        {
+            // Sample distances are multiples of the interval, so they do not
+            // drift over long tracks.
+            double next = double(_samples.size()) * _interval;
+
+            while (next <= _distance)
+            {
+                double t = (next - start) / run;
+                _samples.push_back(ProfileSample{ next, _previous.getElevation() + t * rise });
+                next = double(_samples.size()) * _interval;
+            }
+        }
+
+        _filter(elevation);
+        _minimumElevation = std::min(_minimumElevation, elevation);
+        _maximumElevation = std::max(_maximumElevation, elevation);
+    }
+
+    _previous = coordinate;
+    ++_count;
+}
+
+
+void ElevationProfile::add(const ElevatedCoordinate* coordinates, std::size_t size)
+{
+    for (std::size_t i = 0; i < size; ++i)
+        add(coordinates[i]);
+}
+
+
+void ElevationProfile::add(const std::vector<ElevatedCoordinate>& coordinates)
+{
+    add(coordinates.data(), coordinates.size());
+}
+
+
+void ElevationProfile::clear()
+{
+    _count = 0;
+    _distance = 0;
+    _length = 0;
+    _ascent = 0;
+    _descent = 0;
+    _anchor = 0;
+    _extreme = 0;
+    _trend = LEVEL;
+    _minimumElevation = 0;
+    _maximumElevation = 0;
+    _segmentLength = 0;
+    _segmentGrade = 0;
+    _samples.clear();
+}
+
+
+void ElevationProfile::setThreshold(double threshold)
+{
+    _threshold = std::max(0.0, threshold);
+}
+
+
+double ElevationProfile::getThreshold() const
+{
+    return _threshold;
+}
+
+
+void ElevationProfile::setInterval(double interval)
+{
+    _interval = std::max(0.0, interval);
+}
+
+
+double ElevationProfile::getInterval() const
+{
+    return _interval;
+}
+
+
+std::size_t ElevationProfile::getCount() const
+{
+    return _count;
+}
+
+
+double ElevationProfile::getDistance() const
+{
+    return _distance;
+}
+
+
+double ElevationProfile::getLength() const
+{
+    return _length;
+}
+
+
+double ElevationProfile::getAscent() const
+{
+    return _trend == CLIMBING ? _ascent + (_extreme - _anchor) : _ascent;
+}
+
+
+double ElevationProfile::getDescent() const
+{
+    return _trend == DROPPING ? _descent + (_anchor - _extreme) : _descent;
+}
+
+
+double ElevationProfile::getMinimumElevation() const
+{
+    return _minimumElevation;
+}
+
+
+double ElevationProfile::getMaximumElevation() const
+{
+    return _maximumElevation;
+}
+
+
+double ElevationProfile::getSegmentLength() const
+{
+    return _segmentLength;
+}
+
+
+double ElevationProfile::getSegmentGrade() const
+{
+    return _segmentGrade;
+}
+
+
+const std::vector<ProfileSample>& ElevationProfile::getSamples() const
+{
+    return _samples;
+}
+
+
+void ElevationProfile::_filter(double elevation)
+{
+    switch (_trend)
+    {
+        case LEVEL:
+            // The track only starts level, so the lowest and highest
+            // elevations so far are the turning points of the first move.
+            if (elevation - _minimumElevation >= _threshold)
+            {
+                _trend = CLIMBING;
+                _anchor = _minimumElevation;
+                _extreme = elevation;
+            }
+            else if (_maximumElevation - elevation >= _threshold)
+            {
+                _trend = DROPPING;
+                _anchor = _maximumElevation;
+                _extreme = elevation;
+            }
+            break;
+        case CLIMBING:
+            if (elevation > _extreme)
+            {
+                _extreme = elevation;
+            }
+            else if (_extreme - elevation >= _threshold)
+            {
+                // The peak is confirmed; the climb to it counts in full.
+                _ascent += _extreme - _anchor;
+                _anchor = _extreme;
+                _trend = DROPPING;
+                _extreme = elevation;
+            }
+            break;
+        case DROPPING:
+            if (elevation < _extreme)
+            {
+                _extreme = elevation;
+            }
+            else if (elevation - _extreme >= _threshold)
+            {
+                _descent += _anchor - _extreme;
+                _anchor = _extreme;
+                _trend = CLIMBING;
+                _extreme = elevation;
+            }
+            break;
+    }
+}
+
+
+} } // namespace ofx::Geo
@@ -0,0 +1,142 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofx/Geo/Executor.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace ofx {
+namespace Geo {
+
+
+const std::size_t Executor::DEFAULT_BLOCK_SIZE = 4096;
+
+
+Executor::Executor(std::size_t blockSize):
+    _blockSize(std::max(blockSize, std::size_t(1)))
+{
+}
+
+
+Executor::~Executor()
+{
+}
+
+
+std::size_t Executor::getBlockSize() const
+{
+    return _blockSize;
+}
+
+
+std::size_t Executor::getNumBlocks(std::size_t size) const
+{
+    return (size + _blockSize - 1) / _blockSize;
+}
+
+
+const Executor& Executor::serial()
+{
+    static const SerialExecutor executor;
+    return executor;
+}
+
+
+SerialExecutor::SerialExecutor(std::size_t blockSize): Executor(blockSize)
+{
+}
+
+
+SerialExecutor::~SerialExecutor()
+{
+}
+
+
+void SerialExecutor::run(std::size_t size, const Task& task) const
+{
+    for (std::size_t begin = 0; begin < size; begin += _blockSize)
+        task(begin, std::min(begin + _blockSize, size));
+}
+
+
+ThreadedExecutor::ThreadedExecutor(std::size_t numThreads,
+                                   std::size_t blockSize):
+    Executor(blockSize),
+    _numThreads(numThreads > 0 ? numThreads : std::max(std::thread::hardware_concurrency(), 1u))
+{
+}
+
+
+ThreadedExecutor::~ThreadedExecutor()
+{
+}
+
+
+void ThreadedExecutor::run(std::size_t size, const Task& task) const
+{
+    std::size_t numBlocks = getNumBlocks(size);
+    std::size_t numThreads = std::min(_numThreads, numBlocks);
+
+    if (numThreads <= 1)
+    {
+        SerialExecutor(_blockSize).run(size, task);
+        return;
+    }
+
+    std::atomic<std::size_t> nextBlock(0);
+    std::exception_ptr exception;
+    std::mutex exceptionMutex;
+
+    auto worker = [&]()
+    {
+        try
+        {
+            std::size_t block = 0;
+            while ((block = nextBlock.fetch_add(1)) < numBlocks)
+            {
+                std::size_t begin = block * _blockSize;
+                task(begin, std::min(begin + _blockSize, size));
+            }
+        }
+        catch (...)
+        {
+            // Stop handing out blocks and keep the first exception.
+            nextBlock = numBlocks;
+            std::lock_guard<std::mutex> lock(exceptionMutex);
+            if (!exception)
+                exception = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads - 1);
+
+    for (std::size_t i = 1; i < numThreads; ++i)
+        threads.emplace_back(worker);
+
+    worker();
+
+    for (auto& thread: threads)
+        thread.join();
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+
+std::size_t ThreadedExecutor::getNumThreads() const
+{
+    return _numThreads;
+}
+
+
+} } // namespace ofx::Geo
@@ -7,10 +7,14 @@
 
 #include "ofx/Geo/GeoUtils.h"
 #include "ofx/Geo/Coordinate.h"
+#include "ofx/Geo/CoordinateBounds.h"
+#include "ofx/Geo/GreatCircleArc.h"
+#include "ofx/Geo/NVector.h"
 #include "ofx/Geo/UTMLocation.h"
 #include "UTM/UTM.h"
 #include "ofConstants.h"
 #include "ofMath.h"
+#include <cstdlib>
 
 
 namespace ofx {
@@ -117,6 +121,82 @@ double GeoUtils::distanceHaversine(const Coordinate& coordinate0,
 }
 
 
+double GeoUtils::distanceVincenty(const Coordinate& coordinate0,
+                                  const Coordinate& coordinate1)
+{
+    // reference: https://en.wikipedia.org/wiki/Vincenty%27s_formulae
+    const double a = WGS84_A;
+    const double b = WGS84_B;
+    const double f = (a - b) / a;
+
+    double L = coordinate1.getLongitudeRad() - coordinate0.getLongitudeRad();
+
+    // Reduced latitudes.
+    double U1 = std::atan((1 - f) * std::tan(coordinate0.getLatitudeRad()));
+    double U2 = std::atan((1 - f) * std::tan(coordinate1.getLatitudeRad()));
+
+    double sinU1 = std::sin(U1);
+    double cosU1 = std::cos(U1);
+    double sinU2 = std::sin(U2);
+    double cosU2 = std::cos(U2);
+
+    double lambda = L;
+    double sinSigma = 0;
+    double cosSigma = 0;
+    double sigma = 0;
+    double cosSqAlpha = 0;
+    double cos2SigmaM = 0;
+
+    for (int i = 0; i < 200; ++i)
+    {
+        double sinLambda = std::sin(lambda);
+        double cosLambda = std::cos(lambda);
+
+        double x = cosU2 * sinLambda;
+        double y = cosU1 * sinU2 - sinU1 * cosU2 * cosLambda;
+
+        sinSigma = std::sqrt(x * x + y * y);
+
+        if (sinSigma == 0)
+            return 0;
+
+        cosSigma = sinU1 * sinU2 + cosU1 * cosU2 * cosLambda;
+        sigma = std::atan2(sinSigma, cosSigma);
+
+        double sinAlpha = cosU1 * cosU2 * sinLambda / sinSigma;
+        cosSqAlpha = 1 - sinAlpha * sinAlpha;
+
+        // Both points on the equator.
+        cos2SigmaM = cosSqAlpha != 0 ? cosSigma - 2 * sinU1 * sinU2 / cosSqAlpha : 0;
+
+        double C = f / 16 * cosSqAlpha * (4 + f * (4 - 3 * cosSqAlpha));
+        double previous = lambda;
+
+        lambda = L + (1 - C) * f * sinAlpha
+               * (sigma + C * sinSigma
+               * (cos2SigmaM + C * cosSigma * (-1 + 2 * cos2SigmaM * cos2SigmaM)));
+
+        if (std::abs(lambda - previous) < 1e-12)
+        {
+            double uSq = cosSqAlpha * (a * a - b * b) / (b * b);
+            double A = 1 + uSq / 16384 * (4096 + uSq * (-768 + uSq * (320 - 175 * uSq)));
+            double B = uSq / 1024 * (256 + uSq * (-128 + uSq * (74 - 47 * uSq)));
+
+            double deltaSigma = B * sinSigma
+                * (cos2SigmaM + B / 4
+                * (cosSigma * (-1 + 2 * cos2SigmaM * cos2SigmaM)
+                 - B / 6 * cos2SigmaM * (-3 + 4 * sinSigma * sinSigma)
+                 * (-3 + 4 * cos2SigmaM * cos2SigmaM)));
+
+            return b * A * (sigma - deltaSigma) / 1000.0;
+        }
+    }
+
+    // Nearly antipodal points do not converge.
+    return distanceHaversine(coordinate0, coordinate1) * (2 * a + b) / 3000.0 / EARTH_RADIUS_KM;
+}
+
+
 double GeoUtils::bearingHaversine(const Coordinate& coordinate0,
                                   const Coordinate& coordinate1)
 {
@@ -146,7 +226,7 @@ Coordinate GeoUtils::midpoint(const Coordinate& coordinate0,
     double lat0 = coordinate0.getLatitudeRad();
     double lat1 = coordinate1.getLatitudeRad();
 
-    double lon0 = coordinate1.getLongitudeRad();
+    double lon0 = coordinate0.getLongitudeRad();
 
     double Bx = std::cos(lat1) * std::cos(deltaLon);
     double By = std::cos(lat1) * std::sin(deltaLon);
@@ -157,40 +237,160 @@ Coordinate GeoUtils::midpoint(const Coordinate& coordinate0,
     double t1 = std::sqrt(cL0 * cL0 + By * By);
 
     double lat3 = glm::degrees(std::atan2(t0, t1));
-    double lon3 = glm::degrees(std::atan2(By, cL0)) + lon0;
+    double lon3 = glm::degrees(std::atan2(By, cL0) + lon0);
+
+    // Normalize to [-180, 180).
+    lon3 = std::fmod(lon3 + 540.0, 360.0) - 180.0;
 
     return Coordinate(lat3, lon3);
 
 }
 
 
+Coordinate GeoUtils::destination(const Coordinate& coordinate,
+                                 double bearing,
+                                 double distance)
+{
+    // reference: http://www.movable-type.co.uk/scripts/latlong.html
+
+    double delta = distance / EARTH_RADIUS_KM;
+    double theta = glm::radians(bearing);
+
+    double lat0 = coordinate.getLatitudeRad();
+    double lon0 = coordinate.getLongitudeRad();
+
+    double sinLat0 = std::sin(lat0);
+    double cosLat0 = std::cos(lat0);
+    double sinDelta = std::sin(delta);
+    double cosDelta = std::cos(delta);
+
+    double sinLat1 = sinLat0 * cosDelta + cosLat0 * sinDelta * std::cos(theta);
+    double lat1 = std::asin(glm::clamp(sinLat1, -1.0, 1.0));
+
+    double y = std::sin(theta) * sinDelta * cosLat0;
+    double x = cosDelta - sinLat0 * sinLat1;
+    double lon1 = glm::degrees(lon0 + std::atan2(y, x));
+
+    return Coordinate(glm::degrees(lat1), std::fmod(lon1 + 540.0, 360.0) - 180.0);
+}
+
+
+void GeoUtils::destination(const Coordinate* coordinates,
+                           const double* bearings,
+                           const double* distances,
+                           std::size_t size,
+                           Coordinate* destinations,
+                           const Executor& executor)
+{
+    executor.run(size, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+            destinations[i] = destination(coordinates[i], bearings[i], distances[i]);
+    });
+}
+
+
+double GeoUtils::crossTrackDistance(const Coordinate& start,
+                                    const Coordinate& end,
+                                    const Coordinate& coordinate)
+{
+    return GreatCircleArc(start, end).crossTrackDistance(coordinate);
+}
+
+
+double GeoUtils::alongTrackDistance(const Coordinate& start,
+                                    const Coordinate& end,
+                                    const Coordinate& coordinate)
+{
+    return GreatCircleArc(start, end).alongTrackDistance(coordinate);
+}
+
+
 UTMLocation GeoUtils::toUTM(const Coordinate& coordinate)
 {
-    double northing;
-    double easting;
+    return toUTMLocation(toUTMPoint(coordinate));
+}
+
+
+Coordinate GeoUtils::toCoordinate(const UTMLocation& location)
+{
+    return toCoordinate(toUTMPoint(location));
+}
+
 
-    char zoneBuffer[1024];
+UTMPoint GeoUtils::toUTMPoint(const Coordinate& coordinate)
+{
+    UTMPoint point;
 
     UTM::LLtoUTM(coordinate.getLatitude(),
                  coordinate.getLongitude(),
-                 northing,
-                 easting,
-                 zoneBuffer);
+                 point.northing,
+                 point.easting,
+                 point.zoneNumber,
+                 point.band);
 
-    std::string zone = std::strlen(zoneBuffer) > 0 ? "" : std::string(zoneBuffer);
+    point.hemisphere = coordinate.getLatitude() < 0 ? UTMPoint::SOUTHERN
+                                                    : UTMPoint::NORTHERN;
 
-    return UTMLocation(easting, northing, zone);
+    return point;
 }
 
 
-Coordinate GeoUtils::toCoordinate(const UTMLocation& location)
+UTMPoint GeoUtils::toUTMPoint(const Coordinate& coordinate,
+                              int zoneNumber,
+                              char hemisphere)
+{
+    UTMPoint point;
+
+    UTM::LLtoUTM(coordinate.getLatitude(),
+                 coordinate.getLongitude(),
+                 zoneNumber,
+                 point.northing,
+                 point.easting);
+
+    point.zoneNumber = zoneNumber;
+    point.band = UTM::UTMLetterDesignator(coordinate.getLatitude());
+    point.hemisphere = hemisphere == UTMPoint::SOUTHERN ? UTMPoint::SOUTHERN
+                                                        : UTMPoint::NORTHERN;
+
+    // Use the requested hemisphere's false northing so that northings stay
+    // continuous across the equator.
+    bool isSouth = coordinate.getLatitude() < 0;
+
+    if (isSouth && point.hemisphere == UTMPoint::NORTHERN)
+        point.northing -= UTM_FN_S;
+    else if (!isSouth && point.hemisphere == UTMPoint::SOUTHERN)
+        point.northing += UTM_FN_S;
+
+    return point;
+}
+
+
+UTMPoint GeoUtils::toUTMPoint(const UTMLocation& location)
+{
+    const char* zone = location.getZone().c_str();
+    char* band = nullptr;
+
+    UTMPoint point;
+    point.easting = location.getEasting();
+    point.northing = location.getNorthing();
+    point.zoneNumber = static_cast<int>(std::strtol(zone, &band, 10));
+    point.band = *band != '\0' ? *band : 'Z';
+    point.hemisphere = (point.band - 'N') < 0 ? UTMPoint::SOUTHERN
+                                               : UTMPoint::NORTHERN;
+    return point;
+}
+
+
+Coordinate GeoUtils::toCoordinate(const UTMPoint& point)
 {
     double latitude = 0;
     double longitude = 0;
 
-    UTM::UTMtoLL(location.getNorthing(),
-                 location.getEasting(),
-                 location.getZone().c_str(),
+    UTM::UTMtoLL(point.northing,
+                 point.easting,
+                 point.zoneNumber,
+                 point.hemisphere == UTMPoint::NORTHERN,
                  latitude,
                  longitude);
 
@@ -198,6 +398,307 @@ Coordinate GeoUtils::toCoordinate(const UTMLocation& location)
 }
 
 
+UTMLocation GeoUtils::toUTMLocation(const UTMPoint& point)
+{
+    return UTMLocation(point.easting,
+                       point.northing,
+                       std::to_string(point.zoneNumber) + point.band);
+}
+
+
+void GeoUtils::toUTMPoint(const Coordinate* coordinates,
+                          std::size_t size,
+                          UTMPoint* points,
+                          const Executor& executor)
+{
+    executor.run(size, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+            points[i] = toUTMPoint(coordinates[i]);
+    });
+}
+
+
+void GeoUtils::toCoordinate(const UTMPoint* points,
+                            std::size_t size,
+                            Coordinate* coordinates,
+                            const Executor& executor)
+{
+    executor.run(size, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+            coordinates[i] = toCoordinate(points[i]);
+    });
+}
+
+
+void GeoUtils::distanceHaversine(const Coordinate* coordinates0,
+                                 const Coordinate* coordinates1,
+                                 std::size_t size,
+                                 double* distances,
+                                 const Executor& executor)
+{
+    executor.run(size, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+            distances[i] = distanceHaversine(coordinates0[i], coordinates1[i]);
+    });
+}
+
+
+void GeoUtils::bearingHaversine(const Coordinate* coordinates0,
+                                const Coordinate* coordinates1,
+                                std::size_t size,
+                                double* bearings,
+                                const Executor& executor)
+{
+    executor.run(size, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+            bearings[i] = bearingHaversine(coordinates0[i], coordinates1[i]);
+    });
+}
+
+
+void GeoUtils::distanceHaversine(const Coordinate& coordinate0,
+                                 const Coordinate* coordinates,
+                                 std::size_t size,
+                                 double* distances,
+                                 const Executor& executor)
+{
+    double lat0 = coordinate0.getLatitudeRad();
+    double lon0 = coordinate0.getLongitudeRad();
+    double cosLat0 = std::cos(lat0);
+
+    executor.run(size, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            double lat1 = coordinates[i].getLatitudeRad();
+
+            double s0 = std::sin((lat1 - lat0) / 2.0);
+            double s1 = std::sin((coordinates[i].getLongitudeRad() - lon0) / 2.0);
+
+            double a = s0 * s0 + s1 * s1 * cosLat0 * std::cos(lat1);
+
+            distances[i] = EARTH_RADIUS_KM * 2 * std::atan2(std::sqrt(a), std::sqrt(1 - a));
+        }
+    });
+}
+
+
+std::size_t GeoUtils::radiusBounds(const Coordinate& center,
+                                   double radius,
+                                   CoordinateBounds bounds[2])
+{
+    double angle = std::max(0.0, radius) / EARTH_RADIUS_KM;
+    double latitude = center.getLatitude();
+    double longitude = center.getLongitude();
+
+    double minLatitude = latitude - glm::degrees(angle);
+    double maxLatitude = latitude + glm::degrees(angle);
+
+    double sinAngle = std::sin(std::min(angle, glm::half_pi<double>()));
+    double cosLatitude = std::cos(center.getLatitudeRad());
+
+    if (minLatitude <= -90 || maxLatitude >= 90 || sinAngle >= cosLatitude)
+    {
+        bounds[0] = CoordinateBounds(std::max(-90.0, minLatitude), -180,
+                                     std::min(90.0, maxLatitude), 180);
+        return 1;
+    }
+
+    // The widest longitude extent of a spherical cap, reached north of the
+    // center's latitude.
+    // reference: http://janmatuschek.de/LatitudeLongitudeBoundingCoordinates
+    double longitudeSpan = glm::degrees(std::asin(sinAngle / cosLatitude));
+
+    double west = longitude - longitudeSpan;
+    double east = longitude + longitudeSpan;
+
+    CoordinateBounds cap(minLatitude,
+                         west < -180 ? west + 360 : west,
+                         maxLatitude,
+                         east > 180 ? east - 360 : east);
+
+    return cap.split(bounds);
+}
+
+
+CoordinateBounds GeoUtils::bounds(const Coordinate* coordinates,
+                                  std::size_t size,
+                                  const Executor& executor)
+{
+    // Each block writes its own partial bounds, which are merged
+    // independently of order so the result does not depend on scheduling.
+    std::vector<CoordinateBounds> blockBounds(executor.getNumBlocks(size));
+
+    executor.run(size, [&](std::size_t begin, std::size_t end)
+    {
+        CoordinateBounds& b = blockBounds[begin / executor.getBlockSize()];
+        for (std::size_t i = begin; i < end; ++i)
+            b.growToInclude(coordinates[i]);
+    });
+
+    return CoordinateBounds::merge(blockBounds.data(), blockBounds.size());
+}
+
+
+NVector GeoUtils::toNVector(const Coordinate& coordinate)
+{
+    double latitude = coordinate.getLatitudeRad();
+    double longitude = coordinate.getLongitudeRad();
+    double cosLatitude = std::cos(latitude);
+
+    return NVector(cosLatitude * std::cos(longitude),
+                   cosLatitude * std::sin(longitude),
+                   std::sin(latitude));
+}
+
+
+void GeoUtils::toNVector(const Coordinate* coordinates,
+                         std::size_t size,
+                         NVector* vectors,
+                         const Executor& executor)
+{
+    executor.run(size, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+            vectors[i] = toNVector(coordinates[i]);
+    });
+}
+
+
+Coordinate GeoUtils::toCoordinate(const NVector& vector)
+{
+    return Coordinate(vector.getLatitude(), vector.getLongitude());
+}
+
+
+ECEFLocation GeoUtils::toECEF(const ElevatedCoordinate& coordinate)
+{
+    double latitude = coordinate.getLatitudeRad();
+    double longitude = coordinate.getLongitudeRad();
+    double elevation = coordinate.getElevation();
+
+    double sinLatitude = std::sin(latitude);
+    double cosLatitude = std::cos(latitude);
+
+    // Prime vertical radius of curvature.
+    double n = WGS84_A / std::sqrt(1.0 - UTM_E2 * sinLatitude * sinLatitude);
+
+    return ECEFLocation((n + elevation) * cosLatitude * std::cos(longitude),
+                        (n + elevation) * cosLatitude * std::sin(longitude),
+                        (n * (1.0 - UTM_E2) + elevation) * sinLatitude);
+}
+
+
+ECEFLocation GeoUtils::toECEF(const Coordinate& coordinate)
+{
+    return toECEF(ElevatedCoordinate(coordinate.getLatitude(),
+                                     coordinate.getLongitude(),
+                                     0));
+}
+
+
+void GeoUtils::toECEF(const ElevatedCoordinate* coordinates,
+                      std::size_t size,
+                      ECEFLocation* locations,
+                      const Executor& executor)
+{
+    executor.run(size, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+            locations[i] = toECEF(coordinates[i]);
+    });
+}
+
+
+ElevatedCoordinate GeoUtils::toElevatedCoordinate(const ECEFLocation& location)
+{
+    double p = std::sqrt(location.x * location.x + location.y * location.y);
+    double longitude = std::atan2(location.y, location.x);
+
+    // Iterate from the spherical estimate; converges to sub-millimeter in a
+    // few steps for terrestrial elevations.
+    double latitude = std::atan2(location.z, p * (1.0 - UTM_E2));
+    double sinLatitude = 0;
+    double n = WGS84_A;
+    double elevation = 0;
+
+    for (int i = 0; i < 5; ++i)
+    {
+        sinLatitude = std::sin(latitude);
+        n = WGS84_A / std::sqrt(1.0 - UTM_E2 * sinLatitude * sinLatitude);
+        elevation = p * std::cos(latitude) + location.z * sinLatitude - WGS84_A * WGS84_A / n;
+        latitude = std::atan2(location.z, p * (1.0 - UTM_E2 * n / (n + elevation)));
+    }
+
+    sinLatitude = std::sin(latitude);
+    n = WGS84_A / std::sqrt(1.0 - UTM_E2 * sinLatitude * sinLatitude);
+    elevation = p * std::cos(latitude) + location.z * sinLatitude - WGS84_A * WGS84_A / n;
+
+    return ElevatedCoordinate(glm::degrees(latitude),
+                              glm::degrees(longitude),
+                              elevation);
+}
+
+
+double GeoUtils::distance(const NVector& vector0, const NVector& vector1)
+{
+    return std::atan2(glm::length(glm::cross(vector0, vector1)),
+                      glm::dot(vector0, vector1)) * EARTH_RADIUS_KM;
+}
+
+
+void GeoUtils::distance(const NVector& vector0,
+                        const NVector* vectors,
+                        std::size_t size,
+                        double* distances)
+{
+    for (std::size_t i = 0; i < size; ++i)
+        distances[i] = distance(vector0, vectors[i]);
+}
+
+
+double GeoUtils::bearing(const NVector& vector0, const NVector& vector1)
+{
+    // reference: http://www.movable-type.co.uk/scripts/latlong-vectors.html
+
+    // The angle between the great circle to the destination and the great
+    // circle to the north pole.
+    glm::dvec3 c1 = glm::cross(vector0, vector1);
+    glm::dvec3 c2 = glm::cross(vector0, glm::dvec3(NVector::NORTH_POLE));
+    glm::dvec3 c1xc2 = glm::cross(c1, c2);
+
+    double sign = glm::dot(c1xc2, vector0) < 0 ? -1.0 : 1.0;
+    double angle = glm::degrees(std::atan2(sign * glm::length(c1xc2), glm::dot(c1, c2)));
+
+    return angle < 0 ? angle + 360.0 : angle;
+}
+
+
+void GeoUtils::bearing(const NVector& vector0,
+                       const NVector* vectors,
+                       std::size_t size,
+                       double* bearings)
+{
+    // The great circle to the north pole is shared by all bearings.
+    glm::dvec3 c2 = glm::cross(vector0, glm::dvec3(NVector::NORTH_POLE));
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        glm::dvec3 c1 = glm::cross(vector0, vectors[i]);
+        glm::dvec3 c1xc2 = glm::cross(c1, c2);
+
+        double sign = glm::dot(c1xc2, vector0) < 0 ? -1.0 : 1.0;
+        double angle = glm::degrees(std::atan2(sign * glm::length(c1xc2), glm::dot(c1, c2)));
+
+        bearings[i] = angle < 0 ? angle + 360.0 : angle;
+    }
+}
+
+
 Coordinate GeoUtils::randomCoordinate()
 {
     return Coordinate(ofRandom(MIN_LATITUDE_DEGREES, MAX_LATITUDE_DEGREES),
@@ -219,7 +720,8 @@ glm::dvec2 GeoUtils::toVec(const UTMLocation& location)
 
 glm::dvec2 GeoUtils::toVec(const Coordinate& coordinate)
 {
-    return toVec(toUTM(coordinate));
+    UTMPoint point = toUTMPoint(coordinate);
+    return glm::dvec2(point.easting, point.northing);
 }
 
 
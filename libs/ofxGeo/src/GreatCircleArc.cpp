@@ -0,0 +1,201 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofx/Geo/GreatCircleArc.h"
+#include "ofx/Geo/GeoUtils.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+GreatCircleArc::GreatCircleArc(): GreatCircleArc(Coordinate(), Coordinate())
+{
+}
+
+
+GreatCircleArc::GreatCircleArc(const Coordinate& start, const Coordinate& end):
+    _start(start),
+    _end(end),
+    _a(GeoUtils::toNVector(start))
+{
+    _setup(GeoUtils::toNVector(end));
+}
+
+
+GreatCircleArc::GreatCircleArc(const NVector& start, const NVector& end):
+    _start(GeoUtils::toCoordinate(start)),
+    _end(GeoUtils::toCoordinate(end)),
+    _a(start)
+{
+    _setup(end);
+}
+
+
+GreatCircleArc::~GreatCircleArc()
+{
+}
+
+
+const Coordinate& GreatCircleArc::getStart() const
+{
+    return _start;
+}
+
+
+const Coordinate& GreatCircleArc::getEnd() const
+{
+    return _end;
+}
+
+
+double GreatCircleArc::getAngle() const
+{
+    return _angle;
+}
+
+
+double GreatCircleArc::getLength() const
+{
+    return _angle * GeoUtils::EARTH_RADIUS_KM;
+}
+
+
+Coordinate GreatCircleArc::interpolate(double fraction) const
+{
+    double theta = fraction * _angle;
+    return GeoUtils::toCoordinate(NVector(_a * std::cos(theta) + _u * std::sin(theta)));
+}
+
+
+void GreatCircleArc::interpolate(std::size_t count, Coordinate* coordinates) const
+{
+    if (count == 0)
+        return;
+
+    coordinates[0] = _start;
+
+    if (count == 1)
+        return;
+
+    // Rotate by a fixed step with the angle addition formulas, so each point
+    // costs no trigonometry beyond the final conversion.
+    double step = _angle / (count - 1);
+    double cosStep = std::cos(step);
+    double sinStep = std::sin(step);
+    double c = 1;
+    double s = 0;
+
+    for (std::size_t i = 1; i + 1 < count; ++i)
+    {
+        double nextC = c * cosStep - s * sinStep;
+        s = s * cosStep + c * sinStep;
+        c = nextC;
+        coordinates[i] = GeoUtils::toCoordinate(NVector(_a * c + _u * s));
+    }
+
+    coordinates[count - 1] = _end;
+}
+
+
+std::size_t GreatCircleArc::getNumPoints(double maxSegmentLength) const
+{
+    double length = getLength();
+
+    if (maxSegmentLength <= 0 || length <= maxSegmentLength)
+        return 2;
+
+    return static_cast<std::size_t>(std::ceil(length / maxSegmentLength)) + 1;
+}
+
+
+void GreatCircleArc::densify(double maxSegmentLength,
+                             std::vector<Coordinate>& coordinates,
+                             bool includeEnd) const
+{
+    std::size_t count = getNumPoints(maxSegmentLength);
+    std::size_t offset = coordinates.size();
+
+    coordinates.resize(offset + count);
+    interpolate(count, coordinates.data() + offset);
+
+    if (!includeEnd)
+        coordinates.pop_back();
+}
+
+
+double GreatCircleArc::crossTrackDistance(const Coordinate& coordinate) const
+{
+    return crossTrackDistance(GeoUtils::toNVector(coordinate));
+}
+
+
+double GreatCircleArc::crossTrackDistance(const NVector& vector) const
+{
+    double d = glm::dot(_n, vector);
+    return -std::asin(glm::clamp(d, -1.0, 1.0)) * GeoUtils::EARTH_RADIUS_KM;
+}
+
+
+void GreatCircleArc::crossTrackDistance(const Coordinate* coordinates,
+                                        std::size_t size,
+                                        double* distances) const
+{
+    for (std::size_t i = 0; i < size; ++i)
+        distances[i] = crossTrackDistance(coordinates[i]);
+}
+
+
+double GreatCircleArc::alongTrackDistance(const Coordinate& coordinate) const
+{
+    return alongTrackDistance(GeoUtils::toNVector(coordinate));
+}
+
+
+double GreatCircleArc::alongTrackDistance(const NVector& vector) const
+{
+    return std::atan2(glm::dot(vector, _u), glm::dot(vector, _a)) * GeoUtils::EARTH_RADIUS_KM;
+}
+
+
+void GreatCircleArc::alongTrackDistance(const Coordinate* coordinates,
+                                        std::size_t size,
+                                        double* distances) const
+{
+    for (std::size_t i = 0; i < size; ++i)
+        distances[i] = alongTrackDistance(coordinates[i]);
+}
+
+
+void GreatCircleArc::_setup(const NVector& end)
+{
+    const glm::dvec3& b = end;
+
+    // atan2 of the cross and dot products is accurate at all angles.
+    _angle = std::atan2(glm::length(glm::cross(_a, b)), glm::dot(_a, b));
+
+    glm::dvec3 u = b - _a * glm::dot(_a, b);
+    double length = glm::length(u);
+
+    if (length > 1e-15)
+    {
+        _u = u / length;
+    }
+    else
+    {
+        // Coincident or antipodal; pick the direction toward the north pole,
+        // or toward 0, 0 from a pole.
+        glm::dvec3 reference = std::abs(_a.z) < 1.0 - 1e-12 ? glm::dvec3(0, 0, 1)
+                                                            : glm::dvec3(1, 0, 0);
+        _u = glm::normalize(reference - _a * glm::dot(_a, reference));
+    }
+
+    _n = glm::cross(_a, _u);
+}
+
+
+} } // namespace ofx::Geo
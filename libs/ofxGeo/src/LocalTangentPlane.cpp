@@ -0,0 +1,104 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofx/Geo/LocalTangentPlane.h"
+#include "UTM/UTM.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+LocalTangentPlane::LocalTangentPlane(): LocalTangentPlane(Coordinate())
+{
+}
+
+
+LocalTangentPlane::LocalTangentPlane(const Coordinate& origin)
+{
+    setOrigin(origin);
+}
+
+
+LocalTangentPlane::~LocalTangentPlane()
+{
+}
+
+
+void LocalTangentPlane::setOrigin(const Coordinate& origin)
+{
+    _origin = origin;
+
+    double sinLatitude = std::sin(origin.getLatitudeRad());
+    double w = 1.0 - UTM_E2 * sinLatitude * sinLatitude;
+
+    // Meridional and prime vertical radii of curvature.
+    double m = WGS84_A * (1.0 - UTM_E2) / (w * std::sqrt(w));
+    double n = WGS84_A / std::sqrt(w);
+
+    _metersPerDegreeLatitude = glm::radians(m);
+    // Keep the scale invertible at the poles.
+    _metersPerDegreeLongitude = glm::radians(n * std::max(std::cos(origin.getLatitudeRad()), 1e-9));
+}
+
+
+const Coordinate& LocalTangentPlane::getOrigin() const
+{
+    return _origin;
+}
+
+
+glm::dvec2 LocalTangentPlane::toLocal(const Coordinate& coordinate) const
+{
+    double deltaLongitude = coordinate.getLongitude() - _origin.getLongitude();
+
+    if (deltaLongitude > 180.0)
+        deltaLongitude -= 360.0;
+    else if (deltaLongitude < -180.0)
+        deltaLongitude += 360.0;
+
+    return glm::dvec2(deltaLongitude * _metersPerDegreeLongitude,
+                      (coordinate.getLatitude() - _origin.getLatitude()) * _metersPerDegreeLatitude);
+}
+
+
+void LocalTangentPlane::toLocal(const Coordinate* coordinates,
+                                std::size_t size,
+                                glm::dvec2* positions) const
+{
+    for (std::size_t i = 0; i < size; ++i)
+        positions[i] = toLocal(coordinates[i]);
+}
+
+
+Coordinate LocalTangentPlane::toCoordinate(const glm::dvec2& position) const
+{
+    double longitude = _origin.getLongitude() + position.x / _metersPerDegreeLongitude;
+
+    if (longitude >= 180.0)
+        longitude -= 360.0;
+    else if (longitude < -180.0)
+        longitude += 360.0;
+
+    return Coordinate(_origin.getLatitude() + position.y / _metersPerDegreeLatitude,
+                      longitude);
+}
+
+
+double LocalTangentPlane::getMetersPerDegreeLatitude() const
+{
+    return _metersPerDegreeLatitude;
+}
+
+
+double LocalTangentPlane::getMetersPerDegreeLongitude() const
+{
+    return _metersPerDegreeLongitude;
+}
+
+
+} } // namespace ofx::Geo
@@ -0,0 +1,509 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofx/Geo/MarkerIndex.h"
+#include <algorithm>
+#include <cmath>
+#include "ofx/Geo/WebMercator.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+namespace {
+
+
+/// \brief The parent id of nodes that have not been absorbed by a cluster.
+const std::size_t NO_PARENT = std::numeric_limits<std::size_t>::max();
+
+
+/// \brief The zoom of nodes that have not been clustered yet.
+const int UNCLUSTERED = std::numeric_limits<int>::max();
+
+
+/// \brief The number of bits of a cluster id that hold the origin zoom.
+const int ZOOM_BITS = 5;
+
+
+/// \brief A subtree of a KD-tree still to be searched.
+struct Range
+{
+    std::size_t left;
+    std::size_t right;
+    int axis;
+};
+
+
+/// \brief The capacity of a search stack; a search holds at most one pending
+///     range per tree level.
+const std::size_t MAX_STACK_SIZE = 128;
+
+
+} // namespace
+
+
+const double MarkerIndex::DEFAULT_RADIUS = 40;
+const int MarkerIndex::DEFAULT_MAX_ZOOM = 16;
+const double MarkerIndex::DEFAULT_TILE_SIZE = 512;
+const std::size_t MarkerIndex::KD_NODE_SIZE = 64;
+
+
+MarkerIndex::MarkerIndex(double radius,
+                         int minZoom,
+                         int maxZoom,
+                         std::size_t minPoints,
+                         double tileSize):
+    _radiusPx(radius),
+    _minPoints(minPoints),
+    _tileSize(tileSize)
+{
+    // Cluster ids store the origin zoom, up to maxZoom + 1, in ZOOM_BITS bits.
+    _maxZoom = std::max(0, std::min(std::min(WebMercator::MAX_ZOOM, (1 << ZOOM_BITS) - 2), maxZoom));
+    _minZoom = std::max(0, std::min(_maxZoom, minZoom));
+}
+
+
+MarkerIndex::~MarkerIndex()
+{
+}
+
+
+void MarkerIndex::build(const std::vector<Coordinate>& coordinates)
+{
+    build(coordinates.data(), coordinates.size());
+}
+
+
+void MarkerIndex::build(const Coordinate* coordinates, std::size_t size)
+{
+    _coordinates.assign(coordinates, coordinates + size);
+    _levels.clear();
+    _levels.resize(_maxZoom + 2);
+
+    std::vector<Node>& points = _levels[_maxZoom + 1];
+    points.resize(size);
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        Node& node = points[i];
+        node.position = WebMercator::toPixel(coordinates[i], 0, 1);
+        node.id = i;
+        node.parentId = NO_PARENT;
+        node.count = 1;
+        node.zoom = UNCLUSTERED;
+        node.cluster = false;
+    }
+
+    if (size > 0)
+        _sort(points, 0, size - 1, 0);
+
+    for (int zoom = _maxZoom; zoom >= _minZoom; --zoom)
+        _cluster(zoom);
+}
+
+
+std::size_t MarkerIndex::getClusters(const CoordinateBounds& bounds,
+                                     int zoom,
+                                     std::vector<MarkerCluster>& clusters) const
+{
+    if (bounds.isEmpty() || _levels.empty())
+        return 0;
+
+    zoom = std::max(_minZoom, std::min(_maxZoom + 1, zoom));
+
+    const std::vector<Node>& nodes = _levels[zoom];
+
+    CoordinateBounds parts[2];
+    std::size_t numParts = bounds.split(parts);
+
+    std::size_t count = clusters.size();
+    std::vector<std::size_t> indices;
+
+    for (std::size_t i = 0; i < numParts; ++i)
+    {
+        // Web Mercator y increases southward.
+        glm::dvec2 min = WebMercator::toPixel(parts[i].northwest(), 0, 1);
+        glm::dvec2 max = WebMercator::toPixel(parts[i].southeast(), 0, 1);
+
+        indices.clear();
+        _range(nodes, min, max, indices);
+
+        for (std::size_t index: indices)
+            clusters.push_back(_toMarker(nodes[index]));
+    }
+
+    return clusters.size() - count;
+}
+
+
+bool MarkerIndex::getChildren(std::size_t clusterId,
+                              std::vector<MarkerCluster>& children) const
+{
+    int zoom = 0;
+    std::size_t index = 0;
+
+    if (!_origin(clusterId, zoom, index))
+        return false;
+
+    // The children are the nodes of the origin level that the cluster absorbed.
+    const std::vector<Node>& nodes = _levels[zoom];
+
+    std::vector<std::size_t> indices;
+    _within(nodes, nodes[index].position, _radius(zoom - 1), indices);
+
+    for (std::size_t i: indices)
+    {
+        if (nodes[i].parentId == clusterId)
+            children.push_back(_toMarker(nodes[i]));
+    }
+
+    return true;
+}
+
+
+bool MarkerIndex::getLeaves(std::size_t clusterId,
+                            std::vector<std::size_t>& leaves,
+                            std::size_t limit,
+                            std::size_t offset) const
+{
+    int zoom = 0;
+    std::size_t index = 0;
+
+    if (!_origin(clusterId, zoom, index))
+        return false;
+
+    _leaves(clusterId, leaves, limit, offset);
+    return true;
+}
+
+
+int MarkerIndex::getExpansionZoom(std::size_t clusterId) const
+{
+    int zoom = 0;
+    std::size_t index = 0;
+
+    if (!_origin(clusterId, zoom, index))
+        return -1;
+
+    int expansionZoom = zoom - 1;
+
+    std::vector<MarkerCluster> children;
+
+    while (expansionZoom <= _maxZoom)
+    {
+        children.clear();
+        getChildren(clusterId, children);
+        ++expansionZoom;
+
+        if (children.size() != 1 || !children[0].cluster)
+            break;
+
+        clusterId = children[0].id;
+    }
+
+    return expansionZoom;
+}
+
+
+std::size_t MarkerIndex::size() const
+{
+    return _coordinates.size();
+}
+
+
+void MarkerIndex::_sort(std::vector<Node>& nodes,
+                        std::size_t left,
+                        std::size_t right,
+                        int axis)
+{
+    if (right - left <= KD_NODE_SIZE)
+        return;
+
+    std::size_t middle = (left + right) / 2;
+
+    std::nth_element(nodes.begin() + left,
+                     nodes.begin() + middle,
+                     nodes.begin() + right + 1,
+                     [axis](const Node& a, const Node& b)
+                     {
+                         return a.position[axis] < b.position[axis];
+                     });
+
+    _sort(nodes, left, middle - 1, 1 - axis);
+    _sort(nodes, middle + 1, right, 1 - axis);
+}
+
+
+void MarkerIndex::_range(const std::vector<Node>& nodes,
+                         const glm::dvec2& min,
+                         const glm::dvec2& max,
+                         std::vector<std::size_t>& indices)
+{
+    if (nodes.empty())
+        return;
+
+    Range stack[MAX_STACK_SIZE];
+    std::size_t stackSize = 0;
+
+    stack[stackSize++] = Range{ 0, nodes.size() - 1, 0 };
+
+    while (stackSize > 0)
+    {
+        Range range = stack[--stackSize];
+
+        if (range.right - range.left <= KD_NODE_SIZE)
+        {
+            for (std::size_t i = range.left; i <= range.right; ++i)
+            {
+                const glm::dvec2& p = nodes[i].position;
+
+                if (p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y)
+                    indices.push_back(i);
+            }
+
+            continue;
+        }
+
+        std::size_t middle = (range.left + range.right) / 2;
+        const glm::dvec2& p = nodes[middle].position;
+
+        if (p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y)
+            indices.push_back(middle);
+
+        int axis = range.axis;
+
+        if (min[axis] <= p[axis])
+            stack[stackSize++] = Range{ range.left, middle - 1, 1 - axis };
+
+        if (max[axis] >= p[axis])
+            stack[stackSize++] = Range{ middle + 1, range.right, 1 - axis };
+    }
+}
+
+
+void MarkerIndex::_within(const std::vector<Node>& nodes,
+                          const glm::dvec2& center,
+                          double radius,
+                          std::vector<std::size_t>& indices)
+{
+    if (nodes.empty())
+        return;
+
+    double radiusSquared = radius * radius;
+
+    auto inside = [&](const glm::dvec2& p)
+    {
+        glm::dvec2 delta = p - center;
+        return delta.x * delta.x + delta.y * delta.y <= radiusSquared;
+    };
+
+    // The stack lives on the call stack; searches run once per node while
+    // clustering.
+    Range stack[MAX_STACK_SIZE];
+    std::size_t stackSize = 0;
+
+    stack[stackSize++] = Range{ 0, nodes.size() - 1, 0 };
+
+    while (stackSize > 0)
+    {
+        Range range = stack[--stackSize];
+
+        if (range.right - range.left <= KD_NODE_SIZE)
+        {
+            for (std::size_t i = range.left; i <= range.right; ++i)
+            {
+                if (inside(nodes[i].position))
+                    indices.push_back(i);
+            }
+
+            continue;
+        }
+
+        std::size_t middle = (range.left + range.right) / 2;
+        const glm::dvec2& p = nodes[middle].position;
+
+        if (inside(p))
+            indices.push_back(middle);
+
+        int axis = range.axis;
+
+        if (center[axis] - radius <= p[axis])
+            stack[stackSize++] = Range{ range.left, middle - 1, 1 - axis };
+
+        if (center[axis] + radius >= p[axis])
+            stack[stackSize++] = Range{ middle + 1, range.right, 1 - axis };
+    }
+}
+
+
+void MarkerIndex::_cluster(int zoom)
+{
+    std::vector<Node>& previous = _levels[zoom + 1];
+    std::vector<Node> next;
+    next.reserve(previous.size());
+
+    double radius = _radius(zoom);
+    std::size_t numPoints = _coordinates.size();
+
+    std::vector<std::size_t> neighbors;
+
+    for (std::size_t i = 0; i < previous.size(); ++i)
+    {
+        Node& node = previous[i];
+
+        // Already absorbed at this zoom.
+        if (node.zoom <= zoom)
+            continue;
+
+        node.zoom = zoom;
+
+        neighbors.clear();
+        _within(previous, node.position, radius, neighbors);
+
+        std::size_t count = node.count;
+
+        for (std::size_t n: neighbors)
+        {
+            if (previous[n].zoom > zoom)
+                count += previous[n].count;
+        }
+
+        if (count > node.count && count >= _minPoints)
+        {
+            // The id records where the cluster came from, offset past the
+            // point indices so the two never collide.
+            std::size_t id = (i << ZOOM_BITS) + std::size_t(zoom + 1) + numPoints;
+
+            glm::dvec2 weighted = node.position * double(node.count);
+
+            for (std::size_t n: neighbors)
+            {
+                Node& neighbor = previous[n];
+
+                if (neighbor.zoom <= zoom)
+                    continue;
+
+                neighbor.zoom = zoom;
+                neighbor.parentId = id;
+                weighted += neighbor.position * double(neighbor.count);
+            }
+
+            node.parentId = id;
+
+            Node cluster;
+            cluster.position = weighted / double(count);
+            cluster.id = id;
+            cluster.parentId = NO_PARENT;
+            cluster.count = count;
+            cluster.zoom = UNCLUSTERED;
+            cluster.cluster = true;
+            next.push_back(cluster);
+        }
+        else
+        {
+            // Too few points to cluster; carry the nodes up unchanged.
+            next.push_back(node);
+            next.back().zoom = UNCLUSTERED;
+
+            if (count > 1)
+            {
+                for (std::size_t n: neighbors)
+                {
+                    Node& neighbor = previous[n];
+
+                    if (neighbor.zoom <= zoom)
+                        continue;
+
+                    neighbor.zoom = zoom;
+                    next.push_back(neighbor);
+                    next.back().zoom = UNCLUSTERED;
+                }
+            }
+        }
+    }
+
+    if (!next.empty())
+        _sort(next, 0, next.size() - 1, 0);
+
+    _levels[zoom] = std::move(next);
+}
+
+
+MarkerCluster MarkerIndex::_toMarker(const Node& node) const
+{
+    MarkerCluster marker;
+    marker.cluster = node.cluster;
+    marker.id = node.id;
+    marker.count = node.count;
+    marker.coordinate = node.cluster ? WebMercator::fromPixel(node.position, 0, 1)
+                                     : _coordinates[node.id];
+    return marker;
+}
+
+
+double MarkerIndex::_radius(int zoom) const
+{
+    return _radiusPx / (_tileSize * std::exp2(zoom));
+}
+
+
+bool MarkerIndex::_origin(std::size_t clusterId, int& zoom, std::size_t& index) const
+{
+    std::size_t numPoints = _coordinates.size();
+
+    if (clusterId < numPoints)
+        return false;
+
+    std::size_t offset = clusterId - numPoints;
+
+    zoom = int(offset & ((1 << ZOOM_BITS) - 1));
+    index = offset >> ZOOM_BITS;
+
+    return zoom > _minZoom
+        && zoom <= _maxZoom + 1
+        && std::size_t(zoom) < _levels.size()
+        && index < _levels[zoom].size()
+        && _levels[zoom][index].parentId == clusterId;
+}
+
+
+void MarkerIndex::_leaves(std::size_t clusterId,
+                          std::vector<std::size_t>& leaves,
+                          std::size_t& remaining,
+                          std::size_t& offset) const
+{
+    std::vector<MarkerCluster> children;
+    getChildren(clusterId, children);
+
+    for (const MarkerCluster& child: children)
+    {
+        if (remaining == 0)
+            return;
+
+        if (child.cluster)
+        {
+            // Skip whole clusters that lie before the offset.
+            if (offset >= child.count)
+                offset -= child.count;
+            else
+                _leaves(child.id, leaves, remaining, offset);
+        }
+        else if (offset > 0)
+        {
+            --offset;
+        }
+        else
+        {
+            leaves.push_back(child.id);
+            --remaining;
+        }
+    }
+}
+
+
+} } // namespace ofx::Geo
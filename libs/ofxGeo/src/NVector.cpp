@@ -0,0 +1,65 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofx/Geo/NVector.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+const NVector NVector::NORTH_POLE(0, 0, 1);
+
+
+NVector::NVector(): glm::dvec3(1, 0, 0)
+{
+}
+
+
+NVector::NVector(const glm::dvec3& vector): glm::dvec3(glm::normalize(vector))
+{
+}
+
+
+NVector::NVector(double x, double y, double z): NVector(glm::dvec3(x, y, z))
+{
+}
+
+
+NVector::~NVector()
+{
+}
+
+
+double NVector::getLatitude() const
+{
+    return glm::degrees(std::atan2(z, std::sqrt(x * x + y * y)));
+}
+
+
+double NVector::getLongitude() const
+{
+    return glm::degrees(std::atan2(y, x));
+}
+
+
+ECEFLocation::ECEFLocation(): glm::dvec3(0, 0, 0)
+{
+}
+
+
+ECEFLocation::ECEFLocation(double x, double y, double z): glm::dvec3(x, y, z)
+{
+}
+
+
+ECEFLocation::~ECEFLocation()
+{
+}
+
+
+} } // namespace ofx::Geo
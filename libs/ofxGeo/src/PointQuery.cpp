@@ -0,0 +1,300 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofx/Geo/PointQuery.h"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include "ofx/Geo/GeoUtils.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+PointIndex::~PointIndex()
+{
+}
+
+
+LinearPointIndex::~LinearPointIndex()
+{
+}
+
+
+void LinearPointIndex::build(const Coordinate* coordinates, std::size_t size)
+{
+    _latitudes.resize(size);
+    _longitudes.resize(size);
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        _latitudes[i] = coordinates[i].getLatitude();
+        _longitudes[i] = coordinates[i].getLongitude();
+    }
+}
+
+
+void LinearPointIndex::query(const CoordinateBounds& bounds,
+                             std::vector<std::size_t>& indices) const
+{
+    CoordinateBounds boxes[2];
+    std::size_t numBoxes = bounds.split(boxes);
+
+    for (std::size_t i = 0; i < _latitudes.size(); ++i)
+    {
+        for (std::size_t j = 0; j < numBoxes; ++j)
+        {
+            if (_latitudes[i] >= boxes[j].getSouth() && _latitudes[i] <= boxes[j].getNorth() &&
+                _longitudes[i] >= boxes[j].getWest() && _longitudes[i] <= boxes[j].getEast())
+            {
+                indices.push_back(i);
+                break;
+            }
+        }
+    }
+}
+
+
+CellPointIndex::CellPointIndex(std::size_t maxCells): _maxCells(maxCells)
+{
+}
+
+
+CellPointIndex::~CellPointIndex()
+{
+}
+
+
+void CellPointIndex::build(const Coordinate* coordinates, std::size_t size)
+{
+    _index.clear();
+    _index.reserve(size);
+
+    for (std::size_t i = 0; i < size; ++i)
+        _index.add(coordinates[i], i);
+
+    _index.build();
+}
+
+
+void CellPointIndex::query(const CoordinateBounds& bounds,
+                           std::vector<std::size_t>& indices) const
+{
+    _index.query(bounds, indices, _maxCells);
+}
+
+
+const CellIndex& CellPointIndex::getIndex() const
+{
+    return _index;
+}
+
+
+PointQuery::PointQuery(): PointQuery(std::make_shared<CellPointIndex>())
+{
+}
+
+
+PointQuery::PointQuery(std::shared_ptr<PointIndex> index): _index(index)
+{
+    if (!_index)
+        _index = std::make_shared<CellPointIndex>();
+}
+
+
+PointQuery::~PointQuery()
+{
+}
+
+
+void PointQuery::setPoints(const std::vector<Coordinate>& coordinates)
+{
+    std::size_t size = coordinates.size();
+
+    _latitudes.resize(size);
+    _longitudes.resize(size);
+    _cosLatitudes.resize(size);
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        _latitudes[i] = coordinates[i].getLatitudeRad();
+        _longitudes[i] = coordinates[i].getLongitudeRad();
+        _cosLatitudes[i] = std::cos(_latitudes[i]);
+    }
+
+    _index->build(coordinates.data(), size);
+}
+
+
+std::size_t PointQuery::radius(const Coordinate& center,
+                               double radius,
+                               std::vector<PointQueryResult>& results) const
+{
+    if (radius < 0 || _latitudes.empty())
+        return 0;
+
+    std::vector<std::size_t> candidates;
+    _candidates(center, radius, candidates);
+
+    double latitude = center.getLatitudeRad();
+    double longitude = center.getLongitudeRad();
+    double cosLatitude = std::cos(latitude);
+
+    // Compare against the haversine of the radius instead of converting
+    // every candidate to a distance.
+    double angle = radius / GeoUtils::EARTH_RADIUS_KM;
+    double limit = angle >= glm::pi<double>() ? 1.0 : std::pow(std::sin(angle / 2.0), 2);
+
+    std::size_t count = results.size();
+
+    for (std::size_t index: candidates)
+    {
+        double h = _haversine(latitude, longitude, cosLatitude, index);
+
+        if (h <= limit)
+        {
+            PointQueryResult result;
+            result.index = index;
+            result.distance = 2.0 * GeoUtils::EARTH_RADIUS_KM * std::atan2(std::sqrt(h), std::sqrt(1.0 - h));
+            results.push_back(result);
+        }
+    }
+
+    return results.size() - count;
+}
+
+
+std::size_t PointQuery::nearest(const Coordinate& center,
+                                std::size_t k,
+                                std::vector<PointQueryResult>& results,
+                                double maxRadius) const
+{
+    std::size_t size = _latitudes.size();
+
+    if (k == 0 || size == 0 || maxRadius < 0)
+        return 0;
+
+    double latitude = center.getLatitudeRad();
+    double longitude = center.getLongitudeRad();
+    double cosLatitude = std::cos(latitude);
+
+    double halfCircumference = glm::pi<double>() * GeoUtils::EARTH_RADIUS_KM;
+
+    maxRadius = std::min(maxRadius, halfCircumference);
+
+    // Start from the radius expected to hold k uniformly distributed points.
+    double radius = 2.0 * GeoUtils::EARTH_RADIUS_KM * std::sqrt(double(k) / double(size));
+    radius = std::min(maxRadius, std::max(radius, 1.0));
+
+    // A max-heap of (haversine, index) holding the best k candidates.
+    typedef std::pair<double, std::size_t> Candidate;
+    std::priority_queue<Candidate> heap;
+    std::vector<std::size_t> candidates;
+
+    while (true)
+    {
+        heap = std::priority_queue<Candidate>();
+        candidates.clear();
+        _candidates(center, radius, candidates);
+
+        double angle = radius / GeoUtils::EARTH_RADIUS_KM;
+        double limit = angle >= glm::pi<double>() ? 1.0 : std::pow(std::sin(angle / 2.0), 2);
+
+        for (std::size_t index: candidates)
+        {
+            double h = _haversine(latitude, longitude, cosLatitude, index);
+
+            if (h > limit)
+                continue;
+
+            Candidate candidate(h, index);
+
+            if (heap.size() < k)
+            {
+                heap.push(candidate);
+            }
+            else if (candidate < heap.top())
+            {
+                heap.pop();
+                heap.push(candidate);
+            }
+
+            // Once full, only points closer than the current k-th can matter.
+            if (heap.size() == k)
+                limit = heap.top().first;
+        }
+
+        // Every point within the radius was considered, so a full heap
+        // holds the true k nearest.
+        if (heap.size() == k || radius >= maxRadius)
+            break;
+
+        radius = std::min(maxRadius, radius * 2.0);
+    }
+
+    std::size_t count = heap.size();
+    std::size_t offset = results.size();
+
+    results.resize(offset + count);
+
+    for (std::size_t i = count; i > 0; --i)
+    {
+        double h = heap.top().first;
+
+        PointQueryResult& result = results[offset + i - 1];
+        result.index = heap.top().second;
+        result.distance = 2.0 * GeoUtils::EARTH_RADIUS_KM * std::atan2(std::sqrt(h), std::sqrt(1.0 - h));
+
+        heap.pop();
+    }
+
+    return count;
+}
+
+
+std::size_t PointQuery::size() const
+{
+    return _latitudes.size();
+}
+
+
+std::shared_ptr<PointIndex> PointQuery::getIndex() const
+{
+    return _index;
+}
+
+
+void PointQuery::_candidates(const Coordinate& center,
+                             double radius,
+                             std::vector<std::size_t>& candidates) const
+{
+    CoordinateBounds bounds[2];
+    std::size_t numBounds = GeoUtils::radiusBounds(center, radius, bounds);
+
+    for (std::size_t i = 0; i < numBounds; ++i)
+        _index->query(bounds[i], candidates);
+
+    // Scan in index order so results are deterministic across backends.
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+}
+
+
+double PointQuery::_haversine(double latitude,
+                              double longitude,
+                              double cosLatitude,
+                              std::size_t index) const
+{
+    double s0 = std::sin((_latitudes[index] - latitude) / 2.0);
+    double s1 = std::sin((_longitudes[index] - longitude) / 2.0);
+
+    return std::min(1.0, s0 * s0 + s1 * s1 * cosLatitude * _cosLatitudes[index]);
+}
+
+
+} } // namespace ofx::Geo
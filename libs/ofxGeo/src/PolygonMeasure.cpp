@@ -0,0 +1,238 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofx/Geo/PolygonMeasure.h"
+#include <algorithm>
+#include <cmath>
+#include "ofx/Geo/CompensatedSum.h"
+#include "ofx/Geo/GeoUtils.h"
+#include "UTM/UTM.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+namespace {
+
+
+/// \returns the squared first eccentricity of WGS84.
+double eccentricitySquared()
+{
+    double ratio = WGS84_B / WGS84_A;
+    return 1 - ratio * ratio;
+}
+
+
+/// \returns the authalic q function of a latitude's sine on WGS84.
+double authalicQ(double sinLatitude)
+{
+    double e2 = eccentricitySquared();
+    double e = std::sqrt(e2);
+    double es = e * sinLatitude;
+
+    return (1 - e2) * (sinLatitude / (1 - es * es) + std::atanh(es) / e);
+}
+
+
+/// \brief A ring vertex on the unit sphere.
+struct Vertex
+{
+    Vertex(const Coordinate& coordinate, PolygonMeasure::Model model)
+    {
+        longitude = coordinate.getLongitudeRad();
+        latitude = coordinate.getLatitudeRad();
+
+        if (model == PolygonMeasure::ELLIPSOID)
+            latitude = PolygonMeasure::toAuthalicLatitude(latitude);
+
+        double cosLatitude = std::cos(latitude);
+
+        position = glm::dvec3(cosLatitude * std::cos(longitude),
+                              cosLatitude * std::sin(longitude),
+                              std::sin(latitude));
+
+        halfTan = std::tan(latitude / 2);
+    }
+
+    double longitude;
+    double latitude;
+    double halfTan;
+    glm::dvec3 position;
+};
+
+
+} // namespace
+
+
+const double PolygonMeasure::AUTHALIC_RADIUS_KM = WGS84_A / 1000.0 * std::sqrt(authalicQ(1) / 2);
+
+
+double PolygonMeasure::area(const CoordinatePolyline& ring, Model model)
+{
+    return measure(ring, model).area;
+}
+
+
+double PolygonMeasure::perimeter(const CoordinatePolyline& ring, Model model)
+{
+    CompensatedSum sum;
+
+    for (std::size_t i = 0; i < ring.size(); ++i)
+    {
+        const Coordinate& a = ring[i];
+        const Coordinate& b = ring[(i + 1) % ring.size()];
+
+        sum += model == ELLIPSOID ? GeoUtils::distanceVincenty(a, b)
+                                  : GeoUtils::distanceHaversine(a, b);
+    }
+
+    return sum.getSum();
+}
+
+
+Coordinate PolygonMeasure::centroid(const CoordinatePolyline& ring, Model model)
+{
+    return measure(ring, model).centroid;
+}
+
+
+PolygonMeasurement PolygonMeasure::measure(const CoordinatePolyline& ring,
+                                           Model model)
+{
+    return measure(ring.getVertices().data(), ring.size(), model);
+}
+
+
+PolygonMeasurement PolygonMeasure::measure(const Coordinate* coordinates,
+                                           std::size_t size,
+                                           Model model)
+{
+    PolygonMeasurement measurement;
+    measurement.area = 0;
+    measurement.perimeter = 0;
+
+    if (size == 0)
+        return measurement;
+
+    const double twoPi = glm::two_pi<double>();
+
+    CompensatedSum excess;
+    CompensatedSum winding;
+    CompensatedSum perimeter;
+    CompensatedSum moment[3];
+
+    Vertex first(coordinates[0], model);
+    Vertex a = first;
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        std::size_t j = i + 1 < size ? i + 1 : 0;
+        Vertex b = j == 0 ? first : Vertex(coordinates[j], model);
+
+        double deltaLongitude = std::remainder(b.longitude - a.longitude, twoPi);
+
+        // The signed spherical excess of the region between the edge and
+        // the equator.
+        // reference: Karney, "Algorithms for geodesics", J. Geodesy 87 (2013)
+        excess += 2 * std::atan2(std::tan(deltaLongitude / 2) * (a.halfTan + b.halfTan),
+                                 1 + a.halfTan * b.halfTan);
+        winding += deltaLongitude;
+
+        perimeter += model == ELLIPSOID
+            ? GeoUtils::distanceVincenty(coordinates[i], coordinates[j])
+            : GeoUtils::distanceHaversine(coordinates[i], coordinates[j]);
+
+        // The integral of the surface position over the enclosed region is
+        // half the sum of each edge's unit normal times its length.
+        glm::dvec3 normal = glm::cross(a.position, b.position);
+        double sinAngle = glm::length(normal);
+
+        if (sinAngle > 0)
+        {
+            double scale = std::atan2(sinAngle, glm::dot(a.position, b.position)) / sinAngle;
+
+            moment[0] += normal.x * scale;
+            moment[1] += normal.y * scale;
+            moment[2] += normal.z * scale;
+        }
+
+        a = b;
+    }
+
+    // Each turn around a pole adds a full hemisphere to the excess relative
+    // to the equator.
+    double solidAngle = std::round(winding.getSum() / twoPi) * twoPi - excess.getSum();
+
+    // Reduce to the smaller side of the ring.
+    solidAngle = std::remainder(solidAngle, 2 * twoPi);
+
+    if (solidAngle <= -twoPi)
+        solidAngle += 2 * twoPi;
+
+    double radius = model == ELLIPSOID ? AUTHALIC_RADIUS_KM : GeoUtils::EARTH_RADIUS_KM;
+
+    measurement.area = solidAngle * radius * radius;
+    measurement.perimeter = perimeter.getSum();
+
+    // A clockwise ring encloses the region on its right, whose moment is
+    // the negative of the region on its left.
+    double sign = solidAngle < 0 ? -1 : 1;
+
+    glm::dvec3 center(moment[0].getSum() * sign,
+                      moment[1].getSum() * sign,
+                      moment[2].getSum() * sign);
+
+    double latitude = std::atan2(center.z, std::sqrt(center.x * center.x + center.y * center.y));
+    double longitude = std::atan2(center.y, center.x);
+
+    if (model == ELLIPSOID)
+        latitude = fromAuthalicLatitude(latitude);
+
+    measurement.centroid = Coordinate(glm::degrees(latitude),
+                                      glm::degrees(longitude));
+
+    return measurement;
+}
+
+
+void PolygonMeasure::measure(const CoordinatePolyline* rings,
+                             std::size_t size,
+                             PolygonMeasurement* measurements,
+                             Model model,
+                             const Executor& executor)
+{
+    executor.run(size, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+            measurements[i] = measure(rings[i], model);
+    });
+}
+
+
+double PolygonMeasure::toAuthalicLatitude(double latitude)
+{
+    double ratio = authalicQ(std::sin(latitude)) / authalicQ(1);
+    return std::asin(std::max(-1.0, std::min(1.0, ratio)));
+}
+
+
+double PolygonMeasure::fromAuthalicLatitude(double latitude)
+{
+    // reference: Snyder, Map Projections: A Working Manual, eq. 3-18
+    double e2 = eccentricitySquared();
+    double e4 = e2 * e2;
+    double e6 = e4 * e2;
+
+    return latitude
+         + (e2 / 3 + 31 * e4 / 180 + 517 * e6 / 5040) * std::sin(2 * latitude)
+         + (23 * e4 / 360 + 251 * e6 / 3780) * std::sin(4 * latitude)
+         + (761 * e6 / 45360) * std::sin(6 * latitude);
+}
+
+
+} } // namespace ofx::Geo
@@ -0,0 +1,527 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofx/Geo/PolylineClipper.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "ofx/Geo/GeoUtils.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+namespace {
+
+
+/// \returns the longitude wrapped to [-180, 180].
+double wrap(double longitude)
+{
+    while (longitude > 180)
+        longitude -= 360;
+
+    while (longitude < -180)
+        longitude += 360;
+
+    return longitude;
+}
+
+
+/// \brief Joins the clipped pieces of consecutive segments into polylines.
+class Emitter
+{
+public:
+    Emitter(PolylineSink& sink): _sink(sink)
+    {
+    }
+
+    /// \brief Emit a polyline with a single vertex.
+    void point(const Coordinate& coordinate)
+    {
+        _sink.begin();
+        _sink.vertex(coordinate);
+        _sink.end();
+        ++_count;
+    }
+
+    /// \brief Emit a clipped piece of the current segment.
+    /// \param from The start of the piece.
+    /// \param to The end of the piece.
+    /// \param atStart True if the piece starts at the start of the segment.
+    /// \param atEnd True if the piece ends at the end of the segment.
+    void piece(const Coordinate& from,
+               const Coordinate& to,
+               bool atStart,
+               bool atEnd)
+    {
+        // An open polyline ended at the start of this segment.
+        if (_open && !atStart)
+            _close();
+
+        if (!_open)
+        {
+            _sink.begin();
+            _sink.vertex(from);
+            _open = true;
+            ++_count;
+        }
+
+        _sink.vertex(to);
+        _continued = atEnd;
+
+        if (!atEnd)
+            _close();
+    }
+
+    /// \brief Finish a segment, closing the polyline if it did not reach the end.
+    void next()
+    {
+        if (_open && !_continued)
+            _close();
+
+        _continued = false;
+    }
+
+    /// \brief Close any open polyline.
+    /// \returns the number of polylines emitted.
+    std::size_t finish()
+    {
+        if (_open)
+            _close();
+
+        return _count;
+    }
+
+private:
+    void _close()
+    {
+        _sink.end();
+        _open = false;
+    }
+
+    PolylineSink& _sink;
+    bool _open = false;
+    bool _continued = false;
+    std::size_t _count = 0;
+
+};
+
+
+} // namespace
+
+
+PolylineSink::~PolylineSink()
+{
+}
+
+
+TilePolylineSink::~TilePolylineSink()
+{
+}
+
+
+PolylineCollector::~PolylineCollector()
+{
+}
+
+
+void PolylineCollector::begin()
+{
+    _polylines.push_back(CoordinatePolyline());
+}
+
+
+void PolylineCollector::vertex(const Coordinate& coordinate)
+{
+    _polylines.back().addVertex(coordinate);
+}
+
+
+void PolylineCollector::end()
+{
+}
+
+
+void PolylineCollector::clear()
+{
+    _polylines.clear();
+}
+
+
+const std::vector<CoordinatePolyline>& PolylineCollector::getPolylines() const
+{
+    return _polylines;
+}
+
+
+std::size_t PolylineClipper::clip(const CoordinatePolyline& polyline,
+                                  const CoordinateBounds& bounds,
+                                  PolylineSink& sink)
+{
+    return clip(polyline.getVertices().data(), polyline.size(), bounds, sink);
+}
+
+
+std::size_t PolylineClipper::clip(const Coordinate* coordinates,
+                                  std::size_t size,
+                                  const CoordinateBounds& bounds,
+                                  PolylineSink& sink)
+{
+    if (size == 0 || bounds.isEmpty())
+        return 0;
+
+    Emitter emitter(sink);
+
+    if (size == 1)
+    {
+        if (bounds.contains(coordinates[0]))
+            emitter.point(coordinates[0]);
+
+        return emitter.finish();
+    }
+
+    double south = bounds.getSouth();
+    double north = bounds.getNorth();
+    double west = bounds.getWest();
+    double width = bounds.getWidth();
+    bool full = width >= 360;
+
+    for (std::size_t i = 1; i < size; ++i)
+    {
+        const Coordinate& a = coordinates[i - 1];
+        const Coordinate& b = coordinates[i];
+
+        // Unwrap the end point so the segment takes the shorter way around.
+        glm::dvec2 p0(a.getLongitude(), a.getLatitude());
+        glm::dvec2 p1(p0.x + wrap(b.getLongitude() - a.getLongitude()),
+                      b.getLatitude());
+
+        // Clip against each copy of the box, 360 degrees apart, that the
+        // segment spans. Copies are visited in the direction of travel.
+        int first = 0;
+        int last = 0;
+
+        if (full)
+        {
+            west = std::min(p0.x, p1.x);
+        }
+        else
+        {
+            first = int(std::ceil((std::min(p0.x, p1.x) - west - width) / 360));
+            last = int(std::floor((std::max(p0.x, p1.x) - west) / 360));
+        }
+
+        int step = p1.x < p0.x ? -1 : 1;
+
+        if (step < 0)
+            std::swap(first, last);
+
+        for (int k = first; k != last + step; k += step)
+        {
+            glm::dvec2 min(west + 360.0 * k, south);
+            glm::dvec2 max(min.x + width, north);
+            double t0 = 0;
+            double t1 = 0;
+
+            if (!clip(p0, p1, min, max, t0, t1) || (t0 >= t1 && p0 != p1))
+                continue;
+
+            bool atStart = t0 <= 0;
+            bool atEnd = t1 >= 1;
+
+            // Interpolated vertices are clamped to the box to absorb rounding.
+            glm::dvec2 from = glm::clamp(p0 + (p1 - p0) * t0, min, max);
+            glm::dvec2 to = glm::clamp(p0 + (p1 - p0) * t1, min, max);
+
+            emitter.piece(atStart ? a : Coordinate(from.y, wrap(from.x)),
+                          atEnd ? b : Coordinate(to.y, wrap(to.x)),
+                          atStart,
+                          atEnd);
+        }
+
+        emitter.next();
+    }
+
+    return emitter.finish();
+}
+
+
+std::size_t PolylineClipper::clip(const CoordinatePolyline& polyline,
+                                  const UTMLocationBounds& bounds,
+                                  PolylineSink& sink)
+{
+    return clip(polyline.getVertices().data(), polyline.size(), bounds, sink);
+}
+
+
+std::size_t PolylineClipper::clip(const Coordinate* coordinates,
+                                  std::size_t size,
+                                  const UTMLocationBounds& bounds,
+                                  PolylineSink& sink)
+{
+    if (size == 0 || bounds.isEmpty())
+        return 0;
+
+    // The corners are in the reference zone of the bounds.
+    UTMPoint southwest = GeoUtils::toUTMPoint(bounds.getSouthwest());
+    UTMPoint northeast = GeoUtils::toUTMPoint(bounds.getNortheast());
+
+    glm::dvec2 min(southwest.easting, southwest.northing);
+    glm::dvec2 max(northeast.easting, northeast.northing);
+
+    UTMPoint point = southwest;
+
+    auto project = [&](const Coordinate& coordinate)
+    {
+        UTMPoint projected = GeoUtils::toUTMPoint(coordinate,
+                                                  southwest.zoneNumber,
+                                                  southwest.hemisphere);
+        return glm::dvec2(projected.easting, projected.northing);
+    };
+
+    auto unproject = [&](const glm::dvec2& position)
+    {
+        point.easting = position.x;
+        point.northing = position.y;
+        return GeoUtils::toCoordinate(point);
+    };
+
+    Emitter emitter(sink);
+
+    glm::dvec2 p1 = project(coordinates[0]);
+
+    if (size == 1)
+    {
+        if (bounds.contains(p1.x, p1.y))
+            emitter.point(coordinates[0]);
+
+        return emitter.finish();
+    }
+
+    for (std::size_t i = 1; i < size; ++i)
+    {
+        glm::dvec2 p0 = p1;
+        p1 = project(coordinates[i]);
+
+        double t0 = 0;
+        double t1 = 0;
+
+        if (clip(p0, p1, min, max, t0, t1) && (t0 < t1 || p0 == p1))
+        {
+            bool atStart = t0 <= 0;
+            bool atEnd = t1 >= 1;
+
+            glm::dvec2 from = glm::clamp(p0 + (p1 - p0) * t0, min, max);
+            glm::dvec2 to = glm::clamp(p0 + (p1 - p0) * t1, min, max);
+
+            emitter.piece(atStart ? coordinates[i - 1] : unproject(from),
+                          atEnd ? coordinates[i] : unproject(to),
+                          atStart,
+                          atEnd);
+        }
+
+        emitter.next();
+    }
+
+    return emitter.finish();
+}
+
+
+std::size_t PolylineClipper::clip(const CoordinatePolyline& polyline,
+                                  int zoom,
+                                  TilePolylineSink& sink)
+{
+    return clip(polyline.getVertices().data(), polyline.size(), zoom, sink);
+}
+
+
+std::size_t PolylineClipper::clip(const Coordinate* coordinates,
+                                  std::size_t size,
+                                  int zoom,
+                                  TilePolylineSink& sink)
+{
+    if (size == 0)
+        return 0;
+
+    zoom = std::max(0, std::min(WebMercator::MAX_ZOOM, zoom));
+
+    const int numTiles = 1 << zoom;
+    const double inf = std::numeric_limits<double>::infinity();
+
+    // Positions are in tile units. Columns are unwrapped along the track and
+    // wrapped back into [0, numTiles) when a tile is emitted.
+    auto tileAt = [&](long long column, int row)
+    {
+        long long x = column % numTiles;
+
+        Tile tile;
+        tile.x = int(x < 0 ? x + numTiles : x);
+        tile.y = row;
+        tile.zoom = zoom;
+        return tile;
+    };
+
+    // Get a crossing point as seen from a column, so a point on the
+    // antimeridian gets the longitude of that column's side.
+    auto crossing = [&](const glm::dvec2& position, long long column)
+    {
+        long long x = column % numTiles;
+        double shift = double(column - (x < 0 ? x + numTiles : x));
+        return WebMercator::fromPixel(glm::dvec2(position.x - shift, position.y),
+                                      zoom,
+                                      1);
+    };
+
+    glm::dvec2 p1 = WebMercator::toPixel(coordinates[0], zoom, 1);
+
+    long long column = std::min<long long>(numTiles - 1, (long long)(std::floor(p1.x)));
+    int row = std::max(0, std::min(numTiles - 1, int(std::floor(p1.y))));
+
+    std::size_t count = 0;
+
+    // A piece is only passed to the sink once it leaves its first vertex,
+    // so a track that just touches a tile edge does not emit a lone vertex.
+    Coordinate start = coordinates[0];
+    glm::dvec2 startPosition = p1;
+    bool open = false;
+
+    auto emit = [&](const Coordinate& coordinate, const glm::dvec2& position)
+    {
+        if (!open)
+        {
+            if (position == startPosition)
+                return;
+
+            sink.begin(tileAt(column, row));
+            sink.vertex(start);
+            open = true;
+            ++count;
+        }
+
+        sink.vertex(coordinate);
+    };
+
+    for (std::size_t i = 1; i < size; ++i)
+    {
+        glm::dvec2 p0 = p1;
+        p1 = WebMercator::toPixel(coordinates[i], zoom, 1);
+
+        // Unwrap the end point so the segment takes the shorter way around,
+        // by whole laps since p0 is itself unwrapped after several.
+        p1.x -= numTiles * std::round((p1.x - p0.x) / numTiles);
+
+        glm::dvec2 delta = p1 - p0;
+
+        int stepX = delta.x > 0 ? 1 : (delta.x < 0 ? -1 : 0);
+        int stepY = delta.y > 0 ? 1 : (delta.y < 0 ? -1 : 0);
+
+        // Walk the grid cells crossed by the segment.
+        for (;;)
+        {
+            double tX = inf;
+            double tY = inf;
+
+            if (stepX != 0)
+                tX = (double(column + (stepX > 0 ? 1 : 0)) - p0.x) / delta.x;
+
+            if (stepY != 0 && row + stepY >= 0 && row + stepY < numTiles)
+                tY = (double(row + (stepY > 0 ? 1 : 0)) - p0.y) / delta.y;
+
+            double t = std::min(tX, tY);
+
+            if (!(t < 1))
+                break;
+
+            glm::dvec2 position = p0 + delta * std::max(0.0, t);
+
+            if (tX <= t)
+                position.x = double(column + (stepX > 0 ? 1 : 0));
+
+            if (tY <= t)
+                position.y = double(row + (stepY > 0 ? 1 : 0));
+
+            // A vertex on the boundary is already the last vertex.
+            if (t > 0)
+                emit(crossing(position, column), position);
+
+            if (open)
+                sink.end();
+
+            if (tX <= t)
+                column += stepX;
+
+            if (tY <= t)
+                row += stepY;
+
+            start = t > 0 ? crossing(position, column) : coordinates[i - 1];
+            startPosition = t > 0 ? position : p0;
+            open = false;
+        }
+
+        emit(coordinates[i], p1);
+    }
+
+    if (open)
+    {
+        sink.end();
+    }
+    else if (count == 0)
+    {
+        // A single point, or a track that never moves, keeps its tile.
+        sink.begin(tileAt(column, row));
+        sink.vertex(start);
+        sink.end();
+        ++count;
+    }
+
+    return count;
+}
+
+
+bool PolylineClipper::clip(const glm::dvec2& p0,
+                           const glm::dvec2& p1,
+                           const glm::dvec2& min,
+                           const glm::dvec2& max,
+                           double& t0,
+                           double& t1)
+{
+    glm::dvec2 delta = p1 - p0;
+
+    double p[4] = { -delta.x, delta.x, -delta.y, delta.y };
+    double q[4] = { p0.x - min.x, max.x - p0.x, p0.y - min.y, max.y - p0.y };
+
+    t0 = 0;
+    t1 = 1;
+
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        if (p[i] == 0)
+        {
+            // Parallel to this edge and outside of it.
+            if (q[i] < 0)
+                return false;
+        }
+        else
+        {
+            double t = q[i] / p[i];
+
+            if (p[i] < 0)
+                t0 = std::max(t0, t);
+            else
+                t1 = std::min(t1, t);
+
+            if (t0 > t1)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
+} } // namespace ofx::Geo
@@ -0,0 +1,491 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofx/Geo/PolylinePyramid.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "ofx/Geo/WebMercator.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+const double PolylinePyramid::DEFAULT_TOLERANCE = 0.5;
+const std::size_t PolylinePyramid::DEFAULT_BLOCK_SIZE = 256;
+const int PolylinePyramid::MAX_ZOOM = 24;
+
+
+PolylinePyramid::PolylinePyramid(double tolerance, std::size_t blockSize):
+    _tolerance(tolerance),
+    _blockSize(std::max(std::size_t(2), blockSize))
+{
+}
+
+
+PolylinePyramid::PolylinePyramid(const CoordinatePolyline& polyline,
+                                 double tolerance,
+                                 std::size_t blockSize):
+    PolylinePyramid(tolerance, blockSize)
+{
+    addVertices(polyline.getVertices());
+}
+
+
+PolylinePyramid::~PolylinePyramid()
+{
+}
+
+
+void PolylinePyramid::addVertex(const Coordinate& coordinate)
+{
+    std::size_t first = _polyline.size();
+
+    _polyline.addVertex(coordinate);
+    _addPoint(coordinate);
+    _update(first);
+}
+
+
+void PolylinePyramid::addVertices(const std::vector<Coordinate>& coordinates)
+{
+    if (coordinates.empty())
+        return;
+
+    std::size_t first = _polyline.size();
+
+    _polyline.addVertices(coordinates);
+
+    for (const Coordinate& coordinate: coordinates)
+        _addPoint(coordinate);
+
+    _update(first);
+}
+
+
+void PolylinePyramid::clear()
+{
+    _polyline.clear();
+    _points.clear();
+    _significance.clear();
+    _minZoom.clear();
+    _blocks.clear();
+}
+
+
+std::size_t PolylinePyramid::size() const
+{
+    return _polyline.size();
+}
+
+
+const CoordinatePolyline& PolylinePyramid::getPolyline() const
+{
+    return _polyline;
+}
+
+
+double PolylinePyramid::getSignificance(std::size_t index) const
+{
+    return _significance[index];
+}
+
+
+int PolylinePyramid::getMinZoom(std::size_t index) const
+{
+    return _minZoom[index];
+}
+
+
+std::size_t PolylinePyramid::getIndices(double zoom, std::vector<std::size_t>& indices) const
+{
+    std::size_t count = indices.size();
+    std::size_t size = _polyline.size();
+
+    if (size == 0)
+        return 0;
+
+    uint8_t level = uint8_t(std::max(0.0, std::min(double(MAX_ZOOM), std::floor(zoom))));
+
+    for (std::size_t block = 0; block < _blocks.size(); ++block)
+        _appendBlock(block, level, false, indices);
+
+    indices.push_back(size - 1);
+
+    return indices.size() - count;
+}
+
+
+std::size_t PolylinePyramid::getIndices(double zoom,
+                                        const CoordinateBounds& viewport,
+                                        std::vector<std::size_t>& indices,
+                                        std::vector<std::size_t>& runs) const
+{
+    std::size_t count = indices.size();
+    std::size_t size = _polyline.size();
+
+    if (size == 1 && viewport.contains(_polyline[0]))
+    {
+        runs.push_back(indices.size());
+        indices.push_back(0);
+    }
+
+    if (size < 2)
+        return indices.size() - count;
+
+    uint8_t level = uint8_t(std::max(0.0, std::min(double(MAX_ZOOM), std::floor(zoom))));
+
+    bool inRun = false;
+
+    for (std::size_t block = 0; block < _blocks.size(); ++block)
+    {
+        if (!_blocks[block].bounds.intersects(viewport))
+        {
+            // Close the run at the end of the previous block.
+            if (inRun)
+                indices.push_back(_blockBegin(block));
+
+            inRun = false;
+            continue;
+        }
+
+        if (!inRun)
+            runs.push_back(indices.size());
+
+        _appendBlock(block, level, !inRun, indices);
+        inRun = true;
+    }
+
+    if (inRun)
+        indices.push_back(size - 1);
+
+    return indices.size() - count;
+}
+
+
+double PolylinePyramid::getTolerance() const
+{
+    return _tolerance;
+}
+
+
+std::size_t PolylinePyramid::getBlockSize() const
+{
+    return _blockSize;
+}
+
+
+void PolylinePyramid::_addPoint(const Coordinate& coordinate)
+{
+    glm::dvec2 point = WebMercator::toPixel(coordinate, 0, 1.0);
+
+    // Keep consecutive points within half a world so segments crossing
+    // the antimeridian stay short.
+    if (!_points.empty())
+        point.x -= std::round(point.x - _points.back().x);
+
+    _points.push_back(point);
+    _significance.push_back(0);
+    _minZoom.push_back(uint8_t(MAX_ZOOM));
+}
+
+
+void PolylinePyramid::_update(std::size_t first)
+{
+    std::size_t size = _polyline.size();
+
+    if (size < 2)
+    {
+        if (size == 1)
+        {
+            _significance[0] = std::numeric_limits<double>::infinity();
+            _minZoom[0] = 0;
+        }
+
+        return;
+    }
+
+    // Only the block holding the segment into the first new vertex and
+    // the blocks after it change.
+    std::size_t numBlocks = (size - 2) / _blockSize + 1;
+    std::size_t firstBlock = first == 0 ? 0 : (first - 1) / _blockSize;
+    bool started = numBlocks != _blocks.size();
+
+    _blocks.resize(numBlocks);
+
+    for (std::size_t block = firstBlock; block < numBlocks; ++block)
+        _buildBlock(block);
+
+    _significance[size - 1] = std::numeric_limits<double>::infinity();
+    _minZoom[size - 1] = 0;
+
+    // The skeleton only spans whole blocks, so it is rebuilt once per block
+    // rather than on every append.
+    if (started)
+        _buildSkeleton();
+}
+
+
+void PolylinePyramid::_buildBlock(std::size_t index)
+{
+    Block& block = _blocks[index];
+
+    std::size_t begin = _blockBegin(index);
+    std::size_t end = _blockEnd(index);
+
+    _scratch.clear();
+
+    for (std::size_t i = begin; i <= end; ++i)
+        _scratch.push_back(i);
+
+    _simplify(_scratch, 0, _scratch.size() - 1);
+
+    block.bounds = CoordinateBounds();
+    block.minimum = _points[begin];
+    block.maximum = _points[begin];
+    block.minZoom = uint8_t(MAX_ZOOM);
+    block.counts.assign(MAX_ZOOM + 1, 0);
+
+    for (std::size_t i = begin; i <= end; ++i)
+    {
+        block.bounds.growToInclude(_polyline[i]);
+        block.minimum = glm::min(block.minimum, _points[i]);
+        block.maximum = glm::max(block.maximum, _points[i]);
+
+        if (i != begin && i != end)
+        {
+            _minZoom[i] = _toMinZoom(_significance[i]);
+            block.minZoom = std::min(block.minZoom, _minZoom[i]);
+            ++block.counts[_minZoom[i]];
+        }
+    }
+
+    for (int level = 1; level <= MAX_ZOOM; ++level)
+        block.counts[level] += block.counts[level - 1];
+
+    // Store the visible vertices of each level in index order, so queries
+    // copy them without sorting. Levels that show the same vertices share
+    // a run.
+    block.order.clear();
+    block.starts.assign(MAX_ZOOM + 1, 0);
+
+    for (int level = 0; level <= MAX_ZOOM; ++level)
+    {
+        if (level > 0 && block.counts[level] == block.counts[level - 1])
+        {
+            block.starts[level] = block.starts[level - 1];
+            continue;
+        }
+
+        block.starts[level] = uint32_t(block.order.size());
+
+        for (std::size_t i = begin + 1; i < end; ++i)
+        {
+            if (_minZoom[i] <= level)
+                block.order.push_back(uint32_t(i));
+        }
+    }
+}
+
+
+void PolylinePyramid::_buildSkeleton()
+{
+    std::size_t numBlocks = _blocks.size();
+
+    // Skeleton point k is the first vertex of block k. The last block is
+    // simplified between its own end points, which are always visible.
+    _scratch.clear();
+
+    for (std::size_t block = 0; block < numBlocks; ++block)
+        _scratch.push_back(_blockBegin(block));
+
+    std::size_t last = numBlocks - 1;
+
+    _significance[_scratch[0]] = std::numeric_limits<double>::infinity();
+    _significance[_scratch[last]] = std::numeric_limits<double>::infinity();
+
+    struct Range
+    {
+        std::size_t first;
+        std::size_t last;
+        double bound;
+    };
+
+    std::vector<Range> stack;
+    stack.push_back({ 0, last, std::numeric_limits<double>::infinity() });
+
+    while (!stack.empty())
+    {
+        Range range = stack.back();
+        stack.pop_back();
+
+        if (range.last <= range.first + 1)
+            continue;
+
+        const glm::dvec2& a = _points[_scratch[range.first]];
+        const glm::dvec2& b = _points[_scratch[range.last]];
+
+        std::size_t farthest = range.first + 1;
+        double maxSkeletonDistance = -1;
+        double maxDistance = 0;
+
+        for (std::size_t k = range.first; k < range.last; ++k)
+        {
+            if (k > range.first)
+            {
+                double distance = _distance(_points[_scratch[k]], a, b);
+
+                if (distance > maxSkeletonDistance)
+                {
+                    maxSkeletonDistance = distance;
+                    farthest = k;
+                }
+            }
+
+            // Distance to a segment is convex, so a box's farthest point
+            // from it is a corner.
+            const Block& block = _blocks[k];
+
+            for (const glm::dvec2& corner: { block.minimum,
+                                             block.maximum,
+                                             glm::dvec2(block.minimum.x, block.maximum.y),
+                                             glm::dvec2(block.maximum.x, block.minimum.y) })
+            {
+                maxDistance = std::max(maxDistance, _distance(corner, a, b));
+            }
+        }
+
+        double significance = std::min(maxDistance, range.bound);
+        _significance[_scratch[farthest]] = significance;
+
+        stack.push_back({ range.first, farthest, significance });
+        stack.push_back({ farthest, range.last, significance });
+    }
+
+    for (std::size_t k = 0; k <= last; ++k)
+    {
+        uint8_t minZoom = _toMinZoom(_significance[_scratch[k]]);
+
+        // Interior vertices are simplified against their block's end points.
+        if (k > 0)
+            minZoom = std::min(minZoom, _blocks[k - 1].minZoom);
+
+        minZoom = std::min(minZoom, _blocks[k].minZoom);
+
+        _minZoom[_scratch[k]] = minZoom;
+    }
+}
+
+
+void PolylinePyramid::_simplify(const std::vector<std::size_t>& indices,
+                                std::size_t first,
+                                std::size_t last)
+{
+    struct Range
+    {
+        std::size_t first;
+        std::size_t last;
+        double bound;
+    };
+
+    std::vector<Range> stack;
+    stack.push_back({ first, last, std::numeric_limits<double>::infinity() });
+
+    while (!stack.empty())
+    {
+        Range range = stack.back();
+        stack.pop_back();
+
+        if (range.last <= range.first + 1)
+            continue;
+
+        const glm::dvec2& a = _points[indices[range.first]];
+        const glm::dvec2& b = _points[indices[range.last]];
+
+        std::size_t farthest = range.first + 1;
+        double maxDistance = -1;
+
+        for (std::size_t i = range.first + 1; i < range.last; ++i)
+        {
+            double distance = _distance(_points[indices[i]], a, b);
+
+            if (distance > maxDistance)
+            {
+                maxDistance = distance;
+                farthest = i;
+            }
+        }
+
+        // Clamping to the parent's significance keeps the hierarchy nested:
+        // a vertex never outlives the vertex that split its range.
+        double significance = std::min(maxDistance, range.bound);
+        _significance[indices[farthest]] = significance;
+
+        stack.push_back({ range.first, farthest, significance });
+        stack.push_back({ farthest, range.last, significance });
+    }
+}
+
+
+double PolylinePyramid::_distance(const glm::dvec2& point,
+                                  const glm::dvec2& a,
+                                  const glm::dvec2& b)
+{
+    glm::dvec2 ab = b - a;
+    double length2 = glm::dot(ab, ab);
+    double t = length2 > 0 ? glm::clamp(glm::dot(point - a, ab) / length2, 0.0, 1.0) : 0.0;
+    return glm::length(point - (a + ab * t));
+}
+
+
+uint8_t PolylinePyramid::_toMinZoom(double significance) const
+{
+    if (std::isinf(significance))
+        return 0;
+
+    if (significance <= 0)
+        return uint8_t(MAX_ZOOM);
+
+    // Visible once the tolerance in map units, _tolerance / (TILE_SIZE * 2^zoom),
+    // drops below the significance.
+    double zoom = std::floor(std::log2(_tolerance / (WebMercator::TILE_SIZE * significance))) + 1;
+
+    return uint8_t(std::max(0.0, std::min(double(MAX_ZOOM), zoom)));
+}
+
+
+std::size_t PolylinePyramid::_blockBegin(std::size_t block) const
+{
+    return block * _blockSize;
+}
+
+
+std::size_t PolylinePyramid::_blockEnd(std::size_t block) const
+{
+    return std::min((block + 1) * _blockSize, _polyline.size() - 1);
+}
+
+
+void PolylinePyramid::_appendBlock(std::size_t block,
+                                   uint8_t level,
+                                   bool forceStart,
+                                   std::vector<std::size_t>& indices) const
+{
+    std::size_t begin = _blockBegin(block);
+
+    if (forceStart || _minZoom[begin] <= level)
+        indices.push_back(begin);
+
+    const Block& b = _blocks[block];
+    auto first = b.order.begin() + b.starts[level];
+
+    indices.insert(indices.end(), first, first + b.counts[level]);
+}
+
+
+} } // namespace ofx::Geo
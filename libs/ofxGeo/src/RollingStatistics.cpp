@@ -0,0 +1,157 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofx/Geo/RollingStatistics.h"
+#include <algorithm>
+
+
+namespace ofx {
+namespace Geo {
+
+
+const double RollingStatistics::DEFAULT_WINDOW = 60;
+
+
+RollingStatistics::RollingStatistics(double window): _window(window)
+{
+}
+
+
+RollingStatistics::~RollingStatistics()
+{
+}
+
+
+void RollingStatistics::add(double time, double value)
+{
+    Sample sample = { time, value };
+
+    _samples.push_back(sample);
+    _sum += value;
+
+    // Welford's update keeps the variance free of the cancellation that the
+    // difference of raw sums suffers when the mean is large.
+    double delta = value - _mean;
+    _mean += delta / _samples.size();
+    _squaredDeviations += delta * (value - _mean);
+
+    while (!_minimums.empty() && _minimums.back().value >= value)
+        _minimums.pop_back();
+
+    _minimums.push_back(sample);
+
+    while (!_maximums.empty() && _maximums.back().value <= value)
+        _maximums.pop_back();
+
+    _maximums.push_back(sample);
+
+    _evict(time);
+}
+
+
+void RollingStatistics::clear()
+{
+    _samples.clear();
+    _minimums.clear();
+    _maximums.clear();
+    _sum = 0;
+    _mean = 0;
+    _squaredDeviations = 0;
+}
+
+
+void RollingStatistics::setWindow(double window)
+{
+    _window = window;
+
+    if (!_samples.empty())
+        _evict(_samples.back().time);
+}
+
+
+double RollingStatistics::getWindow() const
+{
+    return _window;
+}
+
+
+std::size_t RollingStatistics::getCount() const
+{
+    return _samples.size();
+}
+
+
+double RollingStatistics::getSum() const
+{
+    return _sum;
+}
+
+
+double RollingStatistics::getMean() const
+{
+    return _samples.empty() ? 0 : _mean;
+}
+
+
+double RollingStatistics::getVariance() const
+{
+    if (_samples.empty())
+        return 0;
+
+    // Clamp rounding error left by removals.
+    return std::max(0.0, _squaredDeviations / _samples.size());
+}
+
+
+double RollingStatistics::getMinimum() const
+{
+    return _minimums.empty() ? 0 : _minimums.front().value;
+}
+
+
+double RollingStatistics::getMaximum() const
+{
+    return _maximums.empty() ? 0 : _maximums.front().value;
+}
+
+
+void RollingStatistics::_evict(double time)
+{
+    double oldest = time - _window;
+
+    while (!_samples.empty() && _samples.front().time < oldest)
+    {
+        double value = _samples.front().value;
+        _sum -= value;
+        _samples.pop_front();
+
+        // Reverse Welford's update for the departing sample.
+        if (!_samples.empty())
+        {
+            double delta = value - _mean;
+            _mean -= delta / _samples.size();
+            _squaredDeviations -= delta * (value - _mean);
+        }
+    }
+
+    while (!_minimums.empty() && _minimums.front().time < oldest)
+        _minimums.pop_front();
+
+    while (!_maximums.empty() && _maximums.front().time < oldest)
+        _maximums.pop_front();
+
+    // Reset the sums when the window empties so rounding error can't persist.
+    if (_samples.empty())
+    {
+        _sum = 0;
+        _mean = 0;
+        _squaredDeviations = 0;
+    }
+}
+
+
+} } // namespace ofx::Geo
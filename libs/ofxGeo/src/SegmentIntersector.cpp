@@ -0,0 +1,371 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofx/Geo/SegmentIntersector.h"
+#include <algorithm>
+#include <limits>
+#include "ofx/Geo/LocalTangentPlane.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+namespace {
+
+
+/// \brief A projected polyline with repeated vertices removed.
+struct Chain
+{
+    /// \brief The projected vertices.
+    std::vector<glm::dvec2> points;
+
+    /// \brief The polyline's index of the segment starting at each vertex.
+    std::vector<std::size_t> indices;
+
+    /// \brief True if the last vertex joins the first.
+    bool closed = false;
+
+    std::size_t numSegments() const
+    {
+        if (points.size() < 2)
+            return 0;
+
+        return closed ? points.size() : points.size() - 1;
+    }
+
+    const glm::dvec2& start(std::size_t segment) const
+    {
+        return points[segment];
+    }
+
+    const glm::dvec2& end(std::size_t segment) const
+    {
+        return points[segment + 1 < points.size() ? segment + 1 : 0];
+    }
+
+    /// \returns true if the second segment starts where the first ends.
+    bool follows(std::size_t segment0, std::size_t segment1) const
+    {
+        return segment1 == segment0 + 1
+           || (closed && segment0 + 1 == points.size() && segment1 == 0);
+    }
+};
+
+
+/// \brief A segment's extent along the sweep axis.
+struct Segment
+{
+    double min;
+    double max;
+    std::size_t chain;
+    std::size_t index;
+};
+
+
+Chain project(const LocalTangentPlane& plane,
+              const CoordinatePolyline& polyline,
+              bool closed)
+{
+    Chain chain;
+    chain.points.reserve(polyline.size());
+    chain.indices.reserve(polyline.size());
+
+    for (std::size_t i = 0; i < polyline.size(); ++i)
+    {
+        glm::dvec2 point = plane.toLocal(polyline[i]);
+
+        // A repeated vertex starts the segment that leaves it.
+        if (!chain.points.empty() && chain.points.back() == point)
+        {
+            chain.indices.back() = i;
+            continue;
+        }
+
+        chain.points.push_back(point);
+        chain.indices.push_back(i);
+    }
+
+    // A repeated first vertex closes the ring; its closing segment keeps the
+    // index of the segment that ends there.
+    if (closed && chain.points.size() > 1 && chain.points.back() == chain.points.front())
+    {
+        chain.points.pop_back();
+        chain.indices.pop_back();
+    }
+
+    chain.closed = closed && chain.points.size() > 2;
+    return chain;
+}
+
+
+double orient(const glm::dvec2& a, const glm::dvec2& b, const glm::dvec2& c)
+{
+    return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+
+/// \brief Intersect two segments.
+/// \param point Set to the crossing, or the start of the overlap along the
+///     first segment if they are collinear.
+/// \returns true if the segments meet.
+bool intersect(const glm::dvec2& a0,
+               const glm::dvec2& a1,
+               const glm::dvec2& b0,
+               const glm::dvec2& b1,
+               glm::dvec2& point)
+{
+    double o0 = orient(a0, a1, b0);
+    double o1 = orient(a0, a1, b1);
+
+    if ((o0 > 0 && o1 > 0) || (o0 < 0 && o1 < 0))
+        return false;
+
+    glm::dvec2 r = a1 - a0;
+
+    if (o0 == 0 && o1 == 0)
+    {
+        double lengthSquared = glm::dot(r, r);
+        double t0 = glm::dot(b0 - a0, r) / lengthSquared;
+        double t1 = glm::dot(b1 - a0, r) / lengthSquared;
+        double low = std::max(0.0, std::min(t0, t1));
+        double high = std::min(1.0, std::max(t0, t1));
+
+        if (low > high)
+            return false;
+
+        point = low == 0 ? a0 : (low == t0 ? b0 : b1);
+        return true;
+    }
+
+    double o2 = orient(b0, b1, a0);
+    double o3 = orient(b0, b1, a1);
+
+    if ((o2 > 0 && o3 > 0) || (o2 < 0 && o3 < 0))
+        return false;
+
+    // Touching end points are reported exactly.
+    if (o0 == 0)
+        point = b0;
+    else if (o1 == 0)
+        point = b1;
+    else if (o2 == 0)
+        point = a0;
+    else if (o3 == 0)
+        point = a1;
+    else
+        point = a0 + r * (o2 / (o2 - o3));
+
+    return true;
+}
+
+
+/// \brief Determine if a segment doubles back over the one before it.
+/// \param point Set to the end of the overlap away from the shared vertex.
+/// \returns true if the segments overlap.
+bool doublesBack(const glm::dvec2& start,
+                 const glm::dvec2& shared,
+                 const glm::dvec2& end,
+                 glm::dvec2& point)
+{
+    glm::dvec2 d0 = shared - start;
+    glm::dvec2 d1 = end - shared;
+
+    if (orient(start, shared, end) != 0 || glm::dot(d0, d1) >= 0)
+        return false;
+
+    point = glm::dot(d1, d1) >= glm::dot(d0, d0) ? start : end;
+    return true;
+}
+
+
+/// \brief Find intersections between the segments of different chains, or
+///     within a single chain.
+/// \param chains The array of size chains.
+/// \param size The number of chains, 1 to find self-intersections.
+/// \param plane The plane the chains are projected onto.
+/// \param stopAtFirst True to stop after the first intersection.
+/// \param intersections The vector the intersections are appended to.
+/// \returns the number of intersections appended.
+std::size_t sweep(const Chain* chains,
+                  std::size_t size,
+                  const LocalTangentPlane& plane,
+                  bool stopAtFirst,
+                  std::vector<SegmentIntersection>& intersections)
+{
+    std::size_t count = intersections.size();
+
+    glm::dvec2 min(std::numeric_limits<double>::max());
+    glm::dvec2 max(std::numeric_limits<double>::lowest());
+
+    for (std::size_t c = 0; c < size; ++c)
+    {
+        for (const glm::dvec2& point: chains[c].points)
+        {
+            min = glm::min(min, point);
+            max = glm::max(max, point);
+        }
+    }
+
+    // Sweeping along the longer axis keeps fewer segments active at once.
+    int axis = (max.x - min.x) >= (max.y - min.y) ? 0 : 1;
+    int other = 1 - axis;
+
+    std::vector<Segment> segments;
+
+    for (std::size_t c = 0; c < size; ++c)
+    {
+        for (std::size_t i = 0; i < chains[c].numSegments(); ++i)
+        {
+            double a = chains[c].start(i)[axis];
+            double b = chains[c].end(i)[axis];
+            segments.push_back(Segment{ std::min(a, b), std::max(a, b), c, i });
+        }
+    }
+
+    std::sort(segments.begin(), segments.end(), [](const Segment& s0, const Segment& s1)
+    {
+        if (s0.min != s1.min)
+            return s0.min < s1.min;
+
+        if (s0.chain != s1.chain)
+            return s0.chain < s1.chain;
+
+        return s0.index < s1.index;
+    });
+
+    std::vector<std::size_t> active;
+
+    for (std::size_t s = 0; s < segments.size(); ++s)
+    {
+        const Segment& segment = segments[s];
+        const Chain& chain = chains[segment.chain];
+        const glm::dvec2& a0 = chain.start(segment.index);
+        const glm::dvec2& a1 = chain.end(segment.index);
+
+        for (std::size_t i = 0; i < active.size(); )
+        {
+            const Segment& candidate = segments[active[i]];
+
+            // Segments that end before this one starts are done.
+            if (candidate.max < segment.min)
+            {
+                active[i] = active.back();
+                active.pop_back();
+                continue;
+            }
+
+            ++i;
+
+            if (size > 1 && candidate.chain == segment.chain)
+                continue;
+
+            const Chain& candidateChain = chains[candidate.chain];
+            const glm::dvec2& b0 = candidateChain.start(candidate.index);
+            const glm::dvec2& b1 = candidateChain.end(candidate.index);
+
+            if (std::max(a0[other], a1[other]) < std::min(b0[other], b1[other])
+             || std::max(b0[other], b1[other]) < std::min(a0[other], a1[other]))
+            {
+                continue;
+            }
+
+            glm::dvec2 point;
+            bool found = false;
+
+            if (size == 1 && chain.follows(candidate.index, segment.index))
+                found = doublesBack(b0, b1, a1, point);
+            else if (size == 1 && chain.follows(segment.index, candidate.index))
+                found = doublesBack(a0, a1, b1, point);
+            else
+                found = intersect(a0, a1, b0, b1, point);
+
+            if (!found)
+                continue;
+
+            // The first chain's segment, or the lower index, comes first.
+            std::size_t index0 = chain.indices[segment.index];
+            std::size_t index1 = candidateChain.indices[candidate.index];
+
+            if (size > 1 ? candidate.chain < segment.chain : index1 < index0)
+                std::swap(index0, index1);
+
+            intersections.push_back(SegmentIntersection{ index0, index1, plane.toCoordinate(point) });
+
+            if (stopAtFirst)
+                return 1;
+        }
+
+        active.push_back(s);
+    }
+
+    std::sort(intersections.begin() + count, intersections.end(),
+              [](const SegmentIntersection& i0, const SegmentIntersection& i1)
+    {
+        return i0.segment0 < i1.segment0
+           || (i0.segment0 == i1.segment0 && i0.segment1 < i1.segment1);
+    });
+
+    return intersections.size() - count;
+}
+
+
+LocalTangentPlane planeFor(const CoordinatePolyline& polyline0,
+                           const CoordinatePolyline& polyline1)
+{
+    CoordinateBounds bounds = polyline0.getBounds();
+    bounds.growToInclude(polyline1.getBounds());
+    return bounds.isEmpty() ? LocalTangentPlane() : LocalTangentPlane(bounds.getCenter());
+}
+
+
+} // namespace
+
+
+std::size_t SegmentIntersector::findSelfIntersections(const CoordinatePolyline& polyline,
+                                                      std::vector<SegmentIntersection>& intersections,
+                                                      bool closed)
+{
+    LocalTangentPlane plane = planeFor(polyline, polyline);
+    Chain chain = project(plane, polyline, closed);
+    return sweep(&chain, 1, plane, false, intersections);
+}
+
+
+bool SegmentIntersector::hasSelfIntersection(const CoordinatePolyline& polyline,
+                                             bool closed)
+{
+    LocalTangentPlane plane = planeFor(polyline, polyline);
+    Chain chain = project(plane, polyline, closed);
+
+    std::vector<SegmentIntersection> intersections;
+    return sweep(&chain, 1, plane, true, intersections) > 0;
+}
+
+
+std::size_t SegmentIntersector::findIntersections(const CoordinatePolyline& polyline0,
+                                                  const CoordinatePolyline& polyline1,
+                                                  std::vector<SegmentIntersection>& intersections)
+{
+    LocalTangentPlane plane = planeFor(polyline0, polyline1);
+    Chain chains[2] = { project(plane, polyline0, false), project(plane, polyline1, false) };
+    return sweep(chains, 2, plane, false, intersections);
+}
+
+
+bool SegmentIntersector::hasIntersection(const CoordinatePolyline& polyline0,
+                                         const CoordinatePolyline& polyline1)
+{
+    LocalTangentPlane plane = planeFor(polyline0, polyline1);
+    Chain chains[2] = { project(plane, polyline0, false), project(plane, polyline1, false) };
+
+    std::vector<SegmentIntersection> intersections;
+    return sweep(chains, 2, plane, true, intersections) > 0;
+}
+
+
+} } // namespace ofx::Geo
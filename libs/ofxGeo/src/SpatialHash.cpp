@@ -0,0 +1,464 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofx/Geo/SpatialHash.h"
+#include <algorithm>
+#include <cmath>
+#include "ofx/Geo/GeoUtils.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+const double SpatialHash::DEFAULT_CELL_SIZE = 0.01;
+const std::size_t SpatialHash::DEFAULT_NUM_SHARDS = 64;
+
+
+SpatialHash::SpatialHash(double cellSize, std::size_t numShards):
+    _cellSize(cellSize > 0 ? std::min(cellSize, 180.0) : DEFAULT_CELL_SIZE),
+    _numRows(int64_t(std::ceil(180.0 / _cellSize))),
+    _numColumns(int64_t(std::ceil(360.0 / _cellSize))),
+    _bucketShards(std::max(std::size_t(1), numShards)),
+    _recordShards(std::max(std::size_t(1), numShards))
+{
+}
+
+
+SpatialHash::~SpatialHash()
+{
+}
+
+
+bool SpatialHash::insert(std::size_t id, const Coordinate& coordinate)
+{
+    RecordShard& recordShard = _recordShard(id);
+    std::lock_guard<std::mutex> recordLock(recordShard.mutex);
+
+    if (recordShard.records.find(id) != recordShard.records.end())
+        return false;
+
+    Record record;
+    record.latitude = coordinate.getLatitude();
+    record.longitude = coordinate.getLongitude();
+    record.key = _key(_row(record.latitude), _column(record.longitude));
+
+    recordShard.records[id] = record;
+
+    BucketShard& bucketShard = _bucketShard(record.key);
+    std::lock_guard<std::mutex> bucketLock(bucketShard.mutex);
+    std::vector<Entry>& bucket = bucketShard.buckets[record.key];
+
+    // Empty buckets are erased, so an empty bucket was just created.
+    if (bucket.empty())
+        _numBuckets.fetch_add(1, std::memory_order_relaxed);
+
+    bucket.push_back({ id, record.latitude, record.longitude });
+
+    return true;
+}
+
+
+bool SpatialHash::move(std::size_t id, const Coordinate& coordinate)
+{
+    // The id's record stays locked until its bucket entry is updated, so
+    // updates to one id are serialized. Record locks are always taken
+    // before bucket locks.
+    RecordShard& recordShard = _recordShard(id);
+    std::lock_guard<std::mutex> recordLock(recordShard.mutex);
+
+    auto iter = recordShard.records.find(id);
+
+    if (iter == recordShard.records.end())
+        return false;
+
+    Record& record = iter->second;
+
+    double latitude = coordinate.getLatitude();
+    double longitude = coordinate.getLongitude();
+    uint64_t key = _key(_row(latitude), _column(longitude));
+
+    BucketShard& oldShard = _bucketShard(record.key);
+    BucketShard& newShard = _bucketShard(key);
+
+    std::unique_lock<std::mutex> oldLock(oldShard.mutex, std::defer_lock);
+    std::unique_lock<std::mutex> newLock(newShard.mutex, std::defer_lock);
+
+    if (&oldShard == &newShard)
+        oldLock.lock();
+    else
+        std::lock(oldLock, newLock);
+
+    std::vector<Entry>& oldBucket = oldShard.buckets[record.key];
+
+    for (std::size_t i = 0; i < oldBucket.size(); ++i)
+    {
+        if (oldBucket[i].id != id)
+            continue;
+
+        if (key == record.key)
+        {
+            oldBucket[i].latitude = latitude;
+            oldBucket[i].longitude = longitude;
+        }
+        else
+        {
+            oldBucket[i] = oldBucket.back();
+            oldBucket.pop_back();
+
+            if (oldBucket.empty())
+            {
+                oldShard.buckets.erase(record.key);
+                _numBuckets.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            std::vector<Entry>& newBucket = newShard.buckets[key];
+
+            if (newBucket.empty())
+                _numBuckets.fetch_add(1, std::memory_order_relaxed);
+
+            newBucket.push_back({ id, latitude, longitude });
+        }
+
+        break;
+    }
+
+    record.latitude = latitude;
+    record.longitude = longitude;
+    record.key = key;
+
+    return true;
+}
+
+
+void SpatialHash::update(const std::size_t* ids,
+                         const Coordinate* coordinates,
+                         std::size_t size,
+                         const Executor& executor)
+{
+    executor.run(size, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            if (!move(ids[i], coordinates[i]))
+                insert(ids[i], coordinates[i]);
+        }
+    });
+}
+
+
+bool SpatialHash::remove(std::size_t id)
+{
+    RecordShard& recordShard = _recordShard(id);
+    std::lock_guard<std::mutex> recordLock(recordShard.mutex);
+
+    auto iter = recordShard.records.find(id);
+
+    if (iter == recordShard.records.end())
+        return false;
+
+    uint64_t key = iter->second.key;
+
+    recordShard.records.erase(iter);
+
+    BucketShard& bucketShard = _bucketShard(key);
+    std::lock_guard<std::mutex> bucketLock(bucketShard.mutex);
+
+    std::vector<Entry>& bucket = bucketShard.buckets[key];
+
+    for (std::size_t i = 0; i < bucket.size(); ++i)
+    {
+        if (bucket[i].id == id)
+        {
+            bucket[i] = bucket.back();
+            bucket.pop_back();
+            break;
+        }
+    }
+
+    if (bucket.empty())
+    {
+        bucketShard.buckets.erase(key);
+        _numBuckets.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    return true;
+}
+
+
+bool SpatialHash::getCoordinate(std::size_t id, Coordinate& coordinate) const
+{
+    RecordShard& recordShard = _recordShard(id);
+    std::lock_guard<std::mutex> recordLock(recordShard.mutex);
+
+    auto iter = recordShard.records.find(id);
+
+    if (iter == recordShard.records.end())
+        return false;
+
+    coordinate.set(iter->second.latitude, iter->second.longitude);
+
+    return true;
+}
+
+
+bool SpatialHash::contains(std::size_t id) const
+{
+    RecordShard& recordShard = _recordShard(id);
+    std::lock_guard<std::mutex> recordLock(recordShard.mutex);
+    return recordShard.records.find(id) != recordShard.records.end();
+}
+
+
+std::size_t SpatialHash::query(const Coordinate& center,
+                               double radius,
+                               std::vector<std::size_t>& ids) const
+{
+    std::size_t count = ids.size();
+
+    if (radius < 0)
+        return 0;
+
+    CoordinateBounds bounds[2];
+    std::size_t numBounds = GeoUtils::radiusBounds(center, radius, bounds);
+
+    // A circle crossing the antimeridian is scanned as one range starting
+    // west of -180, so no bucket is visited twice.
+    double west = numBounds == 2 ? bounds[0].getWest() - 360 : bounds[0].getWest();
+    double east = numBounds == 2 ? bounds[1].getEast() : bounds[0].getEast();
+
+    _scan(bounds[0].getSouth(),
+          bounds[0].getNorth(),
+          west,
+          east,
+          [&](const Entry& entry)
+          {
+              return GeoUtils::distanceHaversine(center, Coordinate(entry.latitude, entry.longitude)) <= radius;
+          },
+          ids);
+
+    return ids.size() - count;
+}
+
+
+std::size_t SpatialHash::query(const CoordinateBounds& bounds,
+                               std::vector<std::size_t>& ids) const
+{
+    std::size_t count = ids.size();
+
+    if (bounds.isEmpty())
+        return 0;
+
+    // A box crossing the antimeridian starts west of -180.
+    double west = bounds.getWest();
+    double east = west + bounds.getWidth();
+
+    if (east > 180)
+    {
+        west -= 360;
+        east -= 360;
+    }
+
+    _scan(bounds.getSouth(),
+          bounds.getNorth(),
+          west,
+          east,
+          [&](const Entry& entry)
+          {
+              return bounds.contains(Coordinate(entry.latitude, entry.longitude));
+          },
+          ids);
+
+    return ids.size() - count;
+}
+
+
+void SpatialHash::clear()
+{
+    for (RecordShard& recordShard: _recordShards)
+    {
+        std::lock_guard<std::mutex> recordLock(recordShard.mutex);
+        recordShard.records.clear();
+    }
+
+    for (BucketShard& bucketShard: _bucketShards)
+    {
+        std::lock_guard<std::mutex> bucketLock(bucketShard.mutex);
+        _numBuckets.fetch_sub(bucketShard.buckets.size(), std::memory_order_relaxed);
+        bucketShard.buckets.clear();
+    }
+}
+
+
+std::size_t SpatialHash::size() const
+{
+    std::size_t size = 0;
+
+    for (const RecordShard& recordShard: _recordShards)
+    {
+        std::lock_guard<std::mutex> recordLock(recordShard.mutex);
+        size += recordShard.records.size();
+    }
+
+    return size;
+}
+
+
+double SpatialHash::getCellSize() const
+{
+    return _cellSize;
+}
+
+
+std::size_t SpatialHash::getNumShards() const
+{
+    return _bucketShards.size();
+}
+
+
+int64_t SpatialHash::_row(double latitude) const
+{
+    int64_t row = int64_t(std::floor((latitude + 90.0) / _cellSize));
+    return std::max(int64_t(0), std::min(_numRows - 1, row));
+}
+
+
+int64_t SpatialHash::_column(double longitude) const
+{
+    int64_t column = int64_t(std::floor((longitude + 180.0) / _cellSize));
+    return std::max(int64_t(0), std::min(_numColumns - 1, column));
+}
+
+
+uint64_t SpatialHash::_key(int64_t row, int64_t column)
+{
+    return (uint64_t(row) << 32) | uint64_t(column);
+}
+
+
+SpatialHash::BucketShard& SpatialHash::_bucketShard(uint64_t key) const
+{
+    // Mix the key so neighbouring cells land in different shards.
+    uint64_t hash = key * 0x9E3779B97F4A7C15ULL;
+    return _bucketShards[std::size_t(hash >> 32) % _bucketShards.size()];
+}
+
+
+SpatialHash::RecordShard& SpatialHash::_recordShard(std::size_t id) const
+{
+    uint64_t hash = uint64_t(id) * 0x9E3779B97F4A7C15ULL;
+    return _recordShards[std::size_t(hash >> 32) % _recordShards.size()];
+}
+
+
+template <typename Predicate>
+void SpatialHash::_scan(uint64_t key,
+                        const Predicate& predicate,
+                        std::vector<std::size_t>& ids) const
+{
+    const BucketShard& bucketShard = _bucketShard(key);
+    std::lock_guard<std::mutex> bucketLock(bucketShard.mutex);
+
+    auto iter = bucketShard.buckets.find(key);
+
+    if (iter == bucketShard.buckets.end())
+        return;
+
+    for (const Entry& entry: iter->second)
+    {
+        if (predicate(entry))
+            ids.push_back(entry.id);
+    }
+}
+
+
+template <typename Predicate>
+void SpatialHash::_scan(double minLatitude,
+                        double maxLatitude,
+                        double minLongitude,
+                        double maxLongitude,
+                        const Predicate& predicate,
+                        std::vector<std::size_t>& ids) const
+{
+    int64_t minRow = _row(minLatitude);
+    int64_t maxRow = _row(maxLatitude);
+
+    // Split ranges that cross the antimeridian into two column ranges.
+    int64_t ranges[2][2] = { { 0, -1 }, { 0, -1 } };
+
+    if (maxLongitude - minLongitude >= 360)
+    {
+        ranges[0][0] = 0;
+        ranges[0][1] = _numColumns - 1;
+    }
+    else if (minLongitude < -180)
+    {
+        ranges[0][0] = _column(minLongitude + 360);
+        ranges[0][1] = _numColumns - 1;
+        ranges[1][0] = 0;
+        ranges[1][1] = _column(maxLongitude);
+    }
+    else if (maxLongitude > 180)
+    {
+        ranges[0][0] = _column(minLongitude);
+        ranges[0][1] = _numColumns - 1;
+        ranges[1][0] = 0;
+        ranges[1][1] = _column(maxLongitude - 360);
+    }
+    else
+    {
+        ranges[0][0] = _column(minLongitude);
+        ranges[0][1] = _column(maxLongitude);
+    }
+
+    // Two wrapped ranges may overlap when the span is nearly 360 degrees.
+    if (ranges[1][1] >= ranges[0][0])
+    {
+        ranges[0][0] = 0;
+        ranges[0][1] = _numColumns - 1;
+        ranges[1][1] = -1;
+    }
+
+    int64_t numCells = (maxRow - minRow + 1)
+                     * (ranges[0][1] - ranges[0][0] + 1 + std::max(int64_t(0), ranges[1][1] - ranges[1][0] + 1));
+
+    // The count is only a cost estimate, so it is read without locking.
+    std::size_t numBuckets = _numBuckets.load(std::memory_order_relaxed);
+
+    // Large ranges over a sparse grid are cheaper to answer by visiting the
+    // occupied buckets; the predicate is exact either way.
+    if (numCells > int64_t(numBuckets))
+    {
+        for (const BucketShard& bucketShard: _bucketShards)
+        {
+            std::lock_guard<std::mutex> bucketLock(bucketShard.mutex);
+
+            for (const auto& bucket: bucketShard.buckets)
+            {
+                for (const Entry& entry: bucket.second)
+                {
+                    if (predicate(entry))
+                        ids.push_back(entry.id);
+                }
+            }
+        }
+
+        return;
+    }
+
+    for (int64_t row = minRow; row <= maxRow; ++row)
+    {
+        for (int r = 0; r < 2; ++r)
+        {
+            for (int64_t column = ranges[r][0]; column <= ranges[r][1]; ++column)
+                _scan(_key(row, column), predicate, ids);
+        }
+    }
+}
+
+
+} } // namespace ofx::Geo
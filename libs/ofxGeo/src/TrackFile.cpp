@@ -0,0 +1,602 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofx/Geo/TrackFile.h"
+#include "ofx/Geo/CoordinateCodec.h"
+#include "ofx/Geo/GeoUtils.h"
+#include "ofLog.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace ofx {
+namespace Geo {
+
+
+static_assert(sizeof(TrackFile::Header) == 64, "Unexpected TrackFile::Header size.");
+static_assert(sizeof(TrackFile::ChunkInfo) == 72, "Unexpected TrackFile::ChunkInfo size.");
+
+// Headers, the index and uncompressed columns are stored as native structs
+// and doubles, so the format is only read and written on little endian hosts.
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__)
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "TrackFile requires a little endian host.");
+#endif
+
+
+namespace {
+
+
+/// \brief The number of columns stored per chunk.
+const std::size_t NUM_COLUMNS = 4;
+
+
+/// \returns true if the host stores integers least significant byte first.
+bool isLittleEndian()
+{
+    const std::uint32_t value = 1;
+    unsigned char first = 0;
+    std::memcpy(&first, &value, 1);
+    return first == 1;
+}
+
+
+} // namespace
+
+
+const char TrackFile::MAGIC[8] = { 'O', 'F', 'X', 'G', 'E', 'O', 'T', 'F' };
+const std::uint32_t TrackFile::VERSION = 2;
+const std::size_t TrackFile::DEFAULT_CHUNK_SIZE = 65536;
+const double TrackFile::COORDINATE_SCALE = 1e7;
+const double TrackFile::ELEVATION_SCALE = 1e3;
+const double TrackFile::TIME_SCALE = 1e3;
+
+
+CoordinateBounds TrackFile::ChunkInfo::getBounds() const
+{
+    if (numPoints == 0)
+        return CoordinateBounds();
+
+    return CoordinateBounds(minLatitude, minLongitude, maxLatitude, maxLongitude);
+}
+
+
+TrackChunkView::TrackChunkView()
+{
+}
+
+
+TrackChunkView::TrackChunkView(const double* latitudes,
+                               const double* longitudes,
+                               const double* elevations,
+                               const double* times,
+                               std::size_t size):
+    _latitudes(latitudes),
+    _longitudes(longitudes),
+    _elevations(elevations),
+    _times(times),
+    _size(size)
+{
+}
+
+
+std::size_t TrackChunkView::size() const
+{
+    return _size;
+}
+
+
+bool TrackChunkView::empty() const
+{
+    return _size == 0;
+}
+
+
+const double* TrackChunkView::getLatitudes() const
+{
+    return _latitudes;
+}
+
+
+const double* TrackChunkView::getLongitudes() const
+{
+    return _longitudes;
+}
+
+
+const double* TrackChunkView::getElevations() const
+{
+    return _elevations;
+}
+
+
+const double* TrackChunkView::getTimes() const
+{
+    return _times;
+}
+
+
+Coordinate TrackChunkView::getCoordinate(std::size_t index) const
+{
+    return Coordinate(_latitudes[index], _longitudes[index]);
+}
+
+
+ElevatedCoordinate TrackChunkView::getElevatedCoordinate(std::size_t index) const
+{
+    return ElevatedCoordinate(_latitudes[index],
+                              _longitudes[index],
+                              _elevations[index]);
+}
+
+
+double TrackChunkView::getTime(std::size_t index) const
+{
+    return _times[index];
+}
+
+
+CoordinateBounds TrackChunkView::getBounds() const
+{
+    CoordinateBounds bounds;
+
+    for (std::size_t i = 0; i < _size; ++i)
+        bounds.growToInclude(getCoordinate(i));
+
+    return bounds;
+}
+
+
+double TrackChunkView::getLength() const
+{
+    double length = 0;
+
+    for (std::size_t i = 1; i < _size; ++i)
+        length += GeoUtils::distanceHaversine(getCoordinate(i - 1), getCoordinate(i));
+
+    return length;
+}
+
+
+TrackFileWriter::TrackFileWriter()
+{
+}
+
+
+TrackFileWriter::~TrackFileWriter()
+{
+    close();
+}
+
+
+bool TrackFileWriter::open(const std::string& path,
+                           bool compressed,
+                           std::size_t chunkSize)
+{
+    close();
+
+    if (!isLittleEndian())
+    {
+        ofLogError("TrackFileWriter::open") << "Track files require a little endian host.";
+        return false;
+    }
+
+    _stream.open(path, std::ios::binary | std::ios::trunc);
+
+    if (!_stream.is_open())
+    {
+        ofLogError("TrackFileWriter::open") << "Unable to open " << path;
+        return false;
+    }
+
+    _compressed = compressed;
+    _chunkSize = std::max(chunkSize, std::size_t(1));
+    _numPoints = 0;
+    _index.clear();
+
+    _latitudes.reserve(_chunkSize);
+    _longitudes.reserve(_chunkSize);
+    _elevations.reserve(_chunkSize);
+    _times.reserve(_chunkSize);
+
+    // The header is rewritten once the index location is known.
+    TrackFile::Header header;
+    std::memset(&header, 0, sizeof(header));
+    _stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    return _stream.good();
+}
+
+
+void TrackFileWriter::add(const ElevatedCoordinate& coordinate, double time)
+{
+    add(coordinate.getLatitude(),
+        coordinate.getLongitude(),
+        coordinate.getElevation(),
+        time);
+}
+
+
+void TrackFileWriter::add(double latitude,
+                          double longitude,
+                          double elevation,
+                          double time)
+{
+    _latitudes.push_back(latitude);
+    _longitudes.push_back(longitude);
+    _elevations.push_back(elevation);
+    _times.push_back(time);
+
+    if (_latitudes.size() >= _chunkSize)
+        _flush();
+}
+
+
+bool TrackFileWriter::close()
+{
+    if (!_stream.is_open())
+        return false;
+
+    _flush();
+    _pad();
+
+    TrackFile::Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, TrackFile::MAGIC, sizeof(header.magic));
+    header.version = TrackFile::VERSION;
+    header.flags = _compressed ? static_cast<std::uint32_t>(TrackFile::COMPRESSED) : 0;
+    header.numPoints = _numPoints;
+    header.numChunks = _index.size();
+    header.indexOffset = static_cast<std::uint64_t>(_stream.tellp());
+    header.chunkSize = static_cast<std::uint32_t>(_chunkSize);
+
+    _stream.write(reinterpret_cast<const char*>(_index.data()),
+                  _index.size() * sizeof(TrackFile::ChunkInfo));
+    _stream.seekp(0);
+    _stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    bool success = _stream.good();
+
+    _stream.close();
+    _index.clear();
+
+    return success;
+}
+
+
+bool TrackFileWriter::isOpen() const
+{
+    return _stream.is_open();
+}
+
+
+void TrackFileWriter::_flush()
+{
+    if (_latitudes.empty())
+        return;
+
+    TrackFile::ChunkInfo info;
+    std::memset(&info, 0, sizeof(info));
+    info.offset = static_cast<std::uint64_t>(_stream.tellp());
+    info.numPoints = static_cast<std::uint32_t>(_latitudes.size());
+
+    CoordinateBounds bounds;
+
+    for (std::size_t i = 0; i < _latitudes.size(); ++i)
+        bounds.growToInclude(Coordinate(_latitudes[i], _longitudes[i]));
+
+    auto times = std::minmax_element(_times.begin(), _times.end());
+
+    info.minLatitude = bounds.getSouth();
+    info.maxLatitude = bounds.getNorth();
+    info.minLongitude = bounds.getWest();
+    info.maxLongitude = bounds.getEast();
+    info.minTime = *times.first;
+    info.maxTime = *times.second;
+
+    if (_compressed)
+    {
+        _encoded.clear();
+        std::size_t n = _latitudes.size();
+        CoordinateCodec::encodeColumn(_latitudes.data(), n, TrackFile::COORDINATE_SCALE, _encoded);
+        CoordinateCodec::encodeColumn(_longitudes.data(), n, TrackFile::COORDINATE_SCALE, _encoded);
+        CoordinateCodec::encodeColumn(_elevations.data(), n, TrackFile::ELEVATION_SCALE, _encoded);
+        CoordinateCodec::encodeColumn(_times.data(), n, TrackFile::TIME_SCALE, _encoded);
+        _stream.write(reinterpret_cast<const char*>(_encoded.data()),
+                      _encoded.size());
+    }
+    else
+    {
+        for (const auto* column: { &_latitudes, &_longitudes, &_elevations, &_times })
+        {
+            _stream.write(reinterpret_cast<const char*>(column->data()),
+                          column->size() * sizeof(double));
+        }
+    }
+
+    info.byteSize = static_cast<std::uint64_t>(_stream.tellp()) - info.offset;
+
+    _pad();
+
+    _index.push_back(info);
+    _numPoints += info.numPoints;
+
+    _latitudes.clear();
+    _longitudes.clear();
+    _elevations.clear();
+    _times.clear();
+}
+
+
+void TrackFileWriter::_pad()
+{
+    static const char zeros[8] = { 0 };
+    std::size_t remainder = static_cast<std::size_t>(_stream.tellp()) % 8;
+
+    if (remainder != 0)
+        _stream.write(zeros, 8 - remainder);
+}
+
+
+struct TrackFileReader::Mapping
+{
+    ~Mapping()
+    {
+#if defined(_WIN32)
+        if (data != nullptr)
+            UnmapViewOfFile(data);
+        if (mapping != nullptr)
+            CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+#else
+        if (data != nullptr)
+            munmap(const_cast<std::uint8_t*>(data), size);
+        if (file >= 0)
+            ::close(file);
+#endif
+    }
+
+    bool open(const std::string& path)
+    {
+#if defined(_WIN32)
+        file = CreateFileA(path.c_str(),
+                           GENERIC_READ,
+                           FILE_SHARE_READ,
+                           nullptr,
+                           OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL,
+                           nullptr);
+
+        LARGE_INTEGER fileSize;
+
+        if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize))
+            return false;
+
+        size = static_cast<std::size_t>(fileSize.QuadPart);
+
+        if (size == 0)
+            return false;
+
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+        if (mapping == nullptr)
+            return false;
+
+        data = static_cast<const std::uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        return data != nullptr;
+#else
+        file = ::open(path.c_str(), O_RDONLY);
+
+        struct stat status;
+
+        if (file < 0 || fstat(file, &status) != 0 || status.st_size <= 0)
+            return false;
+
+        size = static_cast<std::size_t>(status.st_size);
+
+        void* address = mmap(nullptr, size, PROT_READ, MAP_SHARED, file, 0);
+
+        if (address == MAP_FAILED)
+            return false;
+
+        data = static_cast<const std::uint8_t*>(address);
+        return true;
+#endif
+    }
+
+#if defined(_WIN32)
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int file = -1;
+#endif
+    const std::uint8_t* data = nullptr;
+    std::size_t size = 0;
+
+};
+
+
+TrackFileReader::TrackFileReader()
+{
+}
+
+
+TrackFileReader::~TrackFileReader()
+{
+}
+
+
+bool TrackFileReader::open(const std::string& path)
+{
+    close();
+
+    if (!isLittleEndian())
+    {
+        ofLogError("TrackFileReader::open") << "Track files require a little endian host.";
+        return false;
+    }
+
+    std::unique_ptr<Mapping> mapping(new Mapping());
+
+    if (!mapping->open(path))
+    {
+        ofLogError("TrackFileReader::open") << "Unable to map " << path;
+        return false;
+    }
+
+    if (mapping->size < sizeof(TrackFile::Header))
+    {
+        ofLogError("TrackFileReader::open") << "File is too small: " << path;
+        return false;
+    }
+
+    const auto* header = reinterpret_cast<const TrackFile::Header*>(mapping->data);
+
+    if (std::memcmp(header->magic, TrackFile::MAGIC, sizeof(header->magic)) != 0
+     || header->version != TrackFile::VERSION)
+    {
+        ofLogError("TrackFileReader::open") << "Not a version " << TrackFile::VERSION << " track file: " << path;
+        return false;
+    }
+
+    std::uint64_t maxChunks = (mapping->size - sizeof(TrackFile::Header)) / sizeof(TrackFile::ChunkInfo);
+
+    if (header->indexOffset % 8 != 0
+     || header->numChunks > maxChunks
+     || header->indexOffset > mapping->size - header->numChunks * sizeof(TrackFile::ChunkInfo))
+    {
+        ofLogError("TrackFileReader::open") << "Invalid chunk index: " << path;
+        return false;
+    }
+
+    _header = header;
+    _index = reinterpret_cast<const TrackFile::ChunkInfo*>(mapping->data + header->indexOffset);
+    _mapping = std::move(mapping);
+    return true;
+}
+
+
+void TrackFileReader::close()
+{
+    _header = nullptr;
+    _index = nullptr;
+    _mapping.reset();
+}
+
+
+bool TrackFileReader::isOpen() const
+{
+    return _mapping != nullptr;
+}
+
+
+bool TrackFileReader::isCompressed() const
+{
+    return _header != nullptr && (_header->flags & TrackFile::COMPRESSED) != 0;
+}
+
+
+std::uint64_t TrackFileReader::getNumPoints() const
+{
+    return _header != nullptr ? _header->numPoints : 0;
+}
+
+
+std::size_t TrackFileReader::getNumChunks() const
+{
+    return _header != nullptr ? static_cast<std::size_t>(_header->numChunks) : 0;
+}
+
+
+const TrackFile::ChunkInfo& TrackFileReader::getChunkInfo(std::size_t index) const
+{
+    return _index[index];
+}
+
+
+TrackChunkView TrackFileReader::getChunk(std::size_t index,
+                                         std::vector<double>& buffer) const
+{
+    if (index >= getNumChunks())
+        return TrackChunkView();
+
+    const TrackFile::ChunkInfo& info = _index[index];
+    std::size_t n = info.numPoints;
+
+    if (info.offset % 8 != 0
+     || info.offset > _header->indexOffset
+     || info.byteSize > _header->indexOffset - info.offset)
+    {
+        ofLogError("TrackFileReader::getChunk") << "Invalid chunk " << index;
+        return TrackChunkView();
+    }
+
+    const std::uint8_t* data = _mapping->data + info.offset;
+
+    if (!isCompressed())
+    {
+        if (info.byteSize != NUM_COLUMNS * n * sizeof(double))
+        {
+            ofLogError("TrackFileReader::getChunk") << "Invalid chunk size " << index;
+            return TrackChunkView();
+        }
+
+        const double* columns = reinterpret_cast<const double*>(data);
+        return TrackChunkView(columns, columns + n, columns + 2 * n, columns + 3 * n, n);
+    }
+
+    // The codec stores at least one byte per value, so a point count the
+    // chunk cannot hold is rejected before allocating for it.
+    if (n > info.byteSize / NUM_COLUMNS)
+    {
+        ofLogError("TrackFileReader::getChunk") << "Invalid chunk size " << index;
+        return TrackChunkView();
+    }
+
+    buffer.resize(NUM_COLUMNS * n);
+
+    const std::uint8_t* end = data + info.byteSize;
+    double* columns = buffer.data();
+
+    if (!CoordinateCodec::decodeColumn(data, end, TrackFile::COORDINATE_SCALE, columns, n)
+     || !CoordinateCodec::decodeColumn(data, end, TrackFile::COORDINATE_SCALE, columns + n, n)
+     || !CoordinateCodec::decodeColumn(data, end, TrackFile::ELEVATION_SCALE, columns + 2 * n, n)
+     || !CoordinateCodec::decodeColumn(data, end, TrackFile::TIME_SCALE, columns + 3 * n, n))
+    {
+        ofLogError("TrackFileReader::getChunk") << "Corrupt chunk " << index;
+        return TrackChunkView();
+    }
+
+    return TrackChunkView(columns, columns + n, columns + 2 * n, columns + 3 * n, n);
+}
+
+
+std::vector<std::size_t> TrackFileReader::findChunks(const CoordinateBounds& bounds) const
+{
+    std::vector<std::size_t> chunks;
+
+    for (std::size_t i = 0; i < getNumChunks(); ++i)
+    {
+        if (_index[i].getBounds().intersects(bounds))
+            chunks.push_back(i);
+    }
+
+    return chunks;
+}
+
+
+} } // namespace ofx::Geo
@@ -0,0 +1,483 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofx/Geo/TrackFilter.h"
+#include "ofx/Geo/GeoUtils.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+namespace {
+
+
+void predict(KalmanTrackFilter::Axis& axis, double dt, double q)
+{
+    double dt2 = dt * dt;
+
+    axis.position += axis.velocity * dt;
+    axis.p00 += 2.0 * dt * axis.p01 + dt2 * axis.p11 + q * dt2 * dt / 3.0;
+    axis.p01 += dt * axis.p11 + q * dt2 / 2.0;
+    axis.p11 += q * dt;
+}
+
+
+void correct(KalmanTrackFilter::Axis& axis, double measurement, double r)
+{
+    double s = axis.p00 + r;
+    double k0 = axis.p00 / s;
+    double k1 = axis.p01 / s;
+    double innovation = measurement - axis.position;
+
+    axis.position += k0 * innovation;
+    axis.velocity += k1 * innovation;
+    axis.p11 -= k1 * axis.p01;
+    axis.p00 *= (1.0 - k0);
+    axis.p01 *= (1.0 - k0);
+}
+
+
+/// \brief One Rauch-Tung-Striebel step for an axis.
+/// \param filtered The filtered estimate at step k.
+/// \param predicted The prediction for step k + 1 made from filtered.
+/// \param smoothed The smoothed estimate at step k + 1.
+/// \param dt The time from step k to step k + 1.
+/// \returns the smoothed estimate at step k.
+KalmanTrackFilter::Axis smooth(const KalmanTrackFilter::Axis& filtered,
+                               const KalmanTrackFilter::Axis& predicted,
+                               const KalmanTrackFilter::Axis& smoothed,
+                               double dt)
+{
+    // C = P F' inverse(Pp)
+    double m00 = filtered.p00 + dt * filtered.p01;
+    double m01 = filtered.p01;
+    double m10 = filtered.p01 + dt * filtered.p11;
+    double m11 = filtered.p11;
+
+    double det = predicted.p00 * predicted.p11 - predicted.p01 * predicted.p01;
+
+    KalmanTrackFilter::Axis result = filtered;
+
+    if (det <= 0)
+        return result;
+
+    double i00 = predicted.p11 / det;
+    double i01 = -predicted.p01 / det;
+    double i11 = predicted.p00 / det;
+
+    double c00 = m00 * i00 + m01 * i01;
+    double c01 = m00 * i01 + m01 * i11;
+    double c10 = m10 * i00 + m11 * i01;
+    double c11 = m10 * i01 + m11 * i11;
+
+    double dp = smoothed.position - predicted.position;
+    double dv = smoothed.velocity - predicted.velocity;
+
+    result.position += c00 * dp + c01 * dv;
+    result.velocity += c10 * dp + c11 * dv;
+
+    return result;
+}
+
+
+} // namespace
+
+
+const double SpeedGateFilter::DEFAULT_MAX_SPEED = 100;
+
+
+SpeedGateFilter::SpeedGateFilter(double maxSpeed): _maxSpeed(maxSpeed)
+{
+}
+
+
+SpeedGateFilter::~SpeedGateFilter()
+{
+}
+
+
+bool SpeedGateFilter::accept(const ElevatedCoordinate& coordinate, double time)
+{
+    if (_hasReference)
+    {
+        double distance = GeoUtils::distanceHaversine(_reference.coordinate, coordinate) * 1000.0;
+        double duration = time - _reference.time;
+
+        // A fix at the same time as (or before) the reference is only
+        // plausible at the same position.
+        if (duration <= 0 ? distance > 0 : distance > _maxSpeed * duration)
+            return false;
+    }
+
+    _reference.coordinate = coordinate;
+    _reference.time = time;
+    _hasReference = true;
+    return true;
+}
+
+
+void SpeedGateFilter::reset()
+{
+    _hasReference = false;
+}
+
+
+void SpeedGateFilter::setMaxSpeed(double maxSpeed)
+{
+    _maxSpeed = maxSpeed;
+}
+
+
+double SpeedGateFilter::getMaxSpeed() const
+{
+    return _maxSpeed;
+}
+
+
+const double KalmanTrackFilter::DEFAULT_ACCELERATION_NOISE = 1;
+const double KalmanTrackFilter::DEFAULT_HORIZONTAL_ACCURACY = 5;
+const double KalmanTrackFilter::DEFAULT_VERTICAL_ACCURACY = 10;
+const double KalmanTrackFilter::INITIAL_VELOCITY_ACCURACY = 50;
+const double KalmanTrackFilter::REANCHOR_DISTANCE = 10000;
+
+
+KalmanTrackFilter::KalmanTrackFilter(double accelerationNoise,
+                                     double horizontalAccuracy,
+                                     double verticalAccuracy):
+    _accelerationNoise(accelerationNoise),
+    _horizontalAccuracy(horizontalAccuracy),
+    _verticalAccuracy(verticalAccuracy)
+{
+    reset();
+}
+
+
+KalmanTrackFilter::~KalmanTrackFilter()
+{
+}
+
+
+void KalmanTrackFilter::update(const ElevatedCoordinate& coordinate, double time)
+{
+    update(coordinate, time, _horizontalAccuracy, _verticalAccuracy);
+}
+
+
+void KalmanTrackFilter::update(const ElevatedCoordinate& coordinate,
+                               double time,
+                               double horizontalAccuracy,
+                               double verticalAccuracy)
+{
+    _lastOriginShift = glm::dvec2(0, 0);
+
+    double horizontalVariance = horizontalAccuracy * horizontalAccuracy;
+    double verticalVariance = verticalAccuracy * verticalAccuracy;
+    double velocityVariance = INITIAL_VELOCITY_ACCURACY * INITIAL_VELOCITY_ACCURACY;
+
+    if (!_initialized)
+    {
+        _plane.setOrigin(coordinate);
+
+        double variances[3] = { horizontalVariance, horizontalVariance, verticalVariance };
+        double positions[3] = { 0, 0, coordinate.getElevation() };
+
+        _state.time = time;
+
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            Axis& axis = _state.axes[i];
+            axis.position = positions[i];
+            axis.velocity = 0;
+            axis.p00 = variances[i];
+            axis.p01 = 0;
+            axis.p11 = velocityVariance;
+        }
+
+        _predicted = _state;
+        _initialized = true;
+        return;
+    }
+
+    double dt = std::max(time - _state.time, 0.0);
+
+    _predicted = _state;
+    _predicted.time = std::max(time, _state.time);
+
+    for (auto& axis: _predicted.axes)
+        predict(axis, dt, _accelerationNoise);
+
+    glm::dvec2 measured = _plane.toLocal(coordinate);
+
+    _state = _predicted;
+    correct(_state.axes[0], measured.x, horizontalVariance);
+    correct(_state.axes[1], measured.y, horizontalVariance);
+    correct(_state.axes[2], coordinate.getElevation(), verticalVariance);
+
+    glm::dvec2 position(_state.axes[0].position, _state.axes[1].position);
+
+    if (glm::length(position) > REANCHOR_DISTANCE)
+    {
+        _plane.setOrigin(_plane.toCoordinate(position));
+        _lastOriginShift = position;
+
+        for (State* state: { &_state, &_predicted })
+        {
+            state->axes[0].position -= position.x;
+            state->axes[1].position -= position.y;
+        }
+    }
+}
+
+
+void KalmanTrackFilter::reset()
+{
+    _initialized = false;
+    _lastOriginShift = glm::dvec2(0, 0);
+    _state = State();
+    _predicted = State();
+}
+
+
+bool KalmanTrackFilter::isInitialized() const
+{
+    return _initialized;
+}
+
+
+TrackFix KalmanTrackFilter::getFix() const
+{
+    return toFix(_state);
+}
+
+
+TrackFix KalmanTrackFilter::toFix(const State& state) const
+{
+    Coordinate position = _plane.toCoordinate(glm::dvec2(state.axes[0].position,
+                                                         state.axes[1].position));
+    TrackFix fix;
+    fix.coordinate.set(position.getLatitude(),
+                       position.getLongitude(),
+                       state.axes[2].position);
+    fix.time = state.time;
+    return fix;
+}
+
+
+glm::dvec3 KalmanTrackFilter::getVelocity() const
+{
+    return glm::dvec3(_state.axes[0].velocity,
+                      _state.axes[1].velocity,
+                      _state.axes[2].velocity);
+}
+
+
+const KalmanTrackFilter::State& KalmanTrackFilter::getState() const
+{
+    return _state;
+}
+
+
+const KalmanTrackFilter::State& KalmanTrackFilter::getPredictedState() const
+{
+    return _predicted;
+}
+
+
+const LocalTangentPlane& KalmanTrackFilter::getPlane() const
+{
+    return _plane;
+}
+
+
+const glm::dvec2& KalmanTrackFilter::getLastOriginShift() const
+{
+    return _lastOriginShift;
+}
+
+
+const std::size_t FixedLagSmoother::DEFAULT_LAG = 5;
+
+
+FixedLagSmoother::FixedLagSmoother(std::size_t lag,
+                                   const KalmanTrackFilter& filter):
+    _lag(lag),
+    _filter(filter),
+    _entries(lag + 1)
+{
+    _filter.reset();
+}
+
+
+FixedLagSmoother::~FixedLagSmoother()
+{
+}
+
+
+bool FixedLagSmoother::update(const ElevatedCoordinate& coordinate,
+                              double time,
+                              TrackFix& output)
+{
+    _filter.update(coordinate, time);
+
+    const glm::dvec2& shift = _filter.getLastOriginShift();
+
+    if (shift.x != 0 || shift.y != 0)
+    {
+        for (std::size_t i = 0; i < _count; ++i)
+        {
+            Entry& entry = _entries[(_head + i) % _entries.size()];
+
+            for (KalmanTrackFilter::State* state: { &entry.filtered, &entry.predicted })
+            {
+                state->axes[0].position -= shift.x;
+                state->axes[1].position -= shift.y;
+            }
+        }
+    }
+
+    Entry& entry = _entries[(_head + _count) % _entries.size()];
+    entry.filtered = _filter.getState();
+    entry.predicted = _filter.getPredictedState();
+    ++_count;
+
+    if (_count < _entries.size())
+        return false;
+
+    return flush(output);
+}
+
+
+bool FixedLagSmoother::flush(TrackFix& output)
+{
+    if (_count == 0)
+        return false;
+
+    output = _filter.toFix(_smoothOldest());
+
+    _head = (_head + 1) % _entries.size();
+    --_count;
+
+    return true;
+}
+
+
+void FixedLagSmoother::reset()
+{
+    _filter.reset();
+    _head = 0;
+    _count = 0;
+}
+
+
+std::size_t FixedLagSmoother::getLag() const
+{
+    return _lag;
+}
+
+
+const KalmanTrackFilter& FixedLagSmoother::getFilter() const
+{
+    return _filter;
+}
+
+
+KalmanTrackFilter::State FixedLagSmoother::_smoothOldest() const
+{
+    KalmanTrackFilter::State smoothed = _entry(_count - 1).filtered;
+
+    for (std::size_t age = _count - 1; age-- > 0;)
+    {
+        const Entry& current = _entry(age);
+        const Entry& next = _entry(age + 1);
+        double dt = next.predicted.time - current.filtered.time;
+
+        KalmanTrackFilter::State result = current.filtered;
+
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            result.axes[i] = smooth(current.filtered.axes[i],
+                                    next.predicted.axes[i],
+                                    smoothed.axes[i],
+                                    dt);
+        }
+
+        smoothed = result;
+    }
+
+    return smoothed;
+}
+
+
+const FixedLagSmoother::Entry& FixedLagSmoother::_entry(std::size_t age) const
+{
+    return _entries[(_head + age) % _entries.size()];
+}
+
+
+TrackFilter::TrackFilter(const TrackFilterSettings& settings):
+    _settings(settings),
+    _speedGate(settings.maxSpeed),
+    _kalmanFilter(settings.accelerationNoise,
+                  settings.horizontalAccuracy,
+                  settings.verticalAccuracy),
+    _smoother(settings.smootherLag, _kalmanFilter)
+{
+}
+
+
+TrackFilter::~TrackFilter()
+{
+}
+
+
+bool TrackFilter::process(const ElevatedCoordinate& coordinate,
+                          double time,
+                          TrackFix& output)
+{
+    if (_settings.useSpeedGate && !_speedGate.accept(coordinate, time))
+        return false;
+
+    if (!_settings.useKalmanFilter)
+    {
+        output.coordinate = coordinate;
+        output.time = time;
+        return true;
+    }
+
+    if (_settings.smootherLag > 0)
+        return _smoother.update(coordinate, time, output);
+
+    _kalmanFilter.update(coordinate, time);
+    output = _kalmanFilter.getFix();
+    return true;
+}
+
+
+bool TrackFilter::flush(TrackFix& output)
+{
+    return _settings.useKalmanFilter
+        && _settings.smootherLag > 0
+        && _smoother.flush(output);
+}
+
+
+void TrackFilter::reset()
+{
+    _speedGate.reset();
+    _kalmanFilter.reset();
+    _smoother.reset();
+}
+
+
+const TrackFilterSettings& TrackFilter::getSettings() const
+{
+    return _settings;
+}
+
+
+} } // namespace ofx::Geo
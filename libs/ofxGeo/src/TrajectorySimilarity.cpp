@@ -0,0 +1,382 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofx/Geo/TrajectorySimilarity.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "ofx/Geo/LocalTangentPlane.h"
+
+
+namespace ofx {
+namespace Geo {
+
+
+namespace {
+
+
+const double INFINITE_DISTANCE = std::numeric_limits<double>::infinity();
+
+
+/// \brief Buffers reused across comparisons.
+struct Workspace
+{
+    std::vector<glm::dvec2> points0;
+    std::vector<glm::dvec2> points1;
+    std::vector<double> previous;
+    std::vector<double> current;
+};
+
+
+/// \returns the squared distance between two points.
+double distanceSquared(const glm::dvec2& p0, const glm::dvec2& p1)
+{
+    glm::dvec2 delta = p1 - p0;
+    return delta.x * delta.x + delta.y * delta.y;
+}
+
+
+/// \brief Project a polyline onto a plane.
+void project(const LocalTangentPlane& plane,
+             const CoordinatePolyline& polyline,
+             std::vector<glm::dvec2>& points)
+{
+    points.resize(polyline.size());
+    plane.toLocal(polyline.getVertices().data(), polyline.size(), points.data());
+}
+
+
+/// \returns a plane centered on the bounds of both polylines, so swapping
+///     them does not change the projection.
+LocalTangentPlane planeFor(const CoordinatePolyline& polyline0,
+                           const CoordinatePolyline& polyline1)
+{
+    CoordinateBounds bounds = polyline0.getBounds();
+    bounds.growToInclude(polyline1.getBounds());
+    return bounds.isEmpty() ? LocalTangentPlane() : LocalTangentPlane(bounds.getCenter());
+}
+
+
+/// \returns the distance between the bounding boxes of two point sets.
+double boxGap(const glm::dvec2* points0, std::size_t size0,
+              const glm::dvec2* points1, std::size_t size1)
+{
+    glm::dvec2 min0 = points0[0];
+    glm::dvec2 max0 = points0[0];
+    glm::dvec2 min1 = points1[0];
+    glm::dvec2 max1 = points1[0];
+
+    for (std::size_t i = 1; i < size0; ++i)
+    {
+        min0 = glm::min(min0, points0[i]);
+        max0 = glm::max(max0, points0[i]);
+    }
+
+    for (std::size_t i = 1; i < size1; ++i)
+    {
+        min1 = glm::min(min1, points1[i]);
+        max1 = glm::max(max1, points1[i]);
+    }
+
+    glm::dvec2 gap = glm::max(glm::max(min0 - max1, min1 - max0), glm::dvec2(0, 0));
+    return glm::length(gap);
+}
+
+
+double lowerBound(TrajectorySimilarity::Measure measure,
+                  const glm::dvec2* points0, std::size_t size0,
+                  const glm::dvec2* points1, std::size_t size1)
+{
+    double gap = boxGap(points0, size0, points1, size1);
+
+    if (measure == TrajectorySimilarity::HAUSDORFF)
+        return gap;
+
+    double first = std::sqrt(distanceSquared(points0[0], points1[0]));
+    double last = std::sqrt(distanceSquared(points0[size0 - 1], points1[size1 - 1]));
+
+    if (measure == TrajectorySimilarity::FRECHET)
+        return std::max(gap, std::max(first, last));
+
+    // A warping path visits at least max(size0, size1) pairs, starting and
+    // ending with the end points, and every pair is at least the gap apart.
+    std::size_t length = std::max(size0, size1);
+
+    if (length == 1)
+        return first;
+
+    return first + last + gap * double(length - 2);
+}
+
+
+double frechet(const glm::dvec2* points0, std::size_t size0,
+               const glm::dvec2* points1, std::size_t size1,
+               double threshold,
+               Workspace& workspace)
+{
+    // Squared distances preserve the order of max and min.
+    std::vector<double>& previous = workspace.previous;
+    std::vector<double>& current = workspace.current;
+
+    previous.resize(size1);
+    current.resize(size1);
+
+    for (std::size_t i = 0; i < size0; ++i)
+    {
+        double rowMinimum = INFINITE_DISTANCE;
+
+        for (std::size_t j = 0; j < size1; ++j)
+        {
+            double d = distanceSquared(points0[i], points1[j]);
+            double reach = 0;
+
+            if (i == 0 && j == 0)
+                reach = d;
+            else if (i == 0)
+                reach = std::max(d, current[j - 1]);
+            else if (j == 0)
+                reach = std::max(d, previous[0]);
+            else
+                reach = std::max(d, std::min(std::min(previous[j], previous[j - 1]),
+                                             current[j - 1]));
+
+            current[j] = reach;
+            rowMinimum = std::min(rowMinimum, reach);
+        }
+
+        // Every coupling passes through each row.
+        if (std::sqrt(rowMinimum) > threshold)
+            return INFINITE_DISTANCE;
+
+        std::swap(previous, current);
+    }
+
+    return std::sqrt(previous[size1 - 1]);
+}
+
+
+/// \brief Get the directed Hausdorff distance, squared.
+/// \param result The distance found so far, which is raised if exceeded.
+/// \returns false if the distance exceeds the threshold.
+bool directedHausdorff(const glm::dvec2* points0, std::size_t size0,
+                       const glm::dvec2* points1, std::size_t size1,
+                       double threshold,
+                       double& result)
+{
+    for (std::size_t i = 0; i < size0; ++i)
+    {
+        double nearest = INFINITE_DISTANCE;
+
+        for (std::size_t j = 0; j < size1; ++j)
+        {
+            nearest = std::min(nearest, distanceSquared(points0[i], points1[j]));
+
+            // This point can no longer raise the result.
+            if (nearest <= result)
+                break;
+        }
+
+        if (nearest > result)
+        {
+            result = nearest;
+
+            if (std::sqrt(result) > threshold)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
+double hausdorff(const glm::dvec2* points0, std::size_t size0,
+                 const glm::dvec2* points1, std::size_t size1,
+                 double threshold)
+{
+    double result = 0;
+
+    if (!directedHausdorff(points0, size0, points1, size1, threshold, result)
+     || !directedHausdorff(points1, size1, points0, size0, threshold, result))
+    {
+        return INFINITE_DISTANCE;
+    }
+
+    return std::sqrt(result);
+}
+
+
+double dynamicTimeWarping(const glm::dvec2* points0, std::size_t size0,
+                          const glm::dvec2* points1, std::size_t size1,
+                          double threshold,
+                          Workspace& workspace)
+{
+    std::vector<double>& previous = workspace.previous;
+    std::vector<double>& current = workspace.current;
+
+    previous.resize(size1);
+    current.resize(size1);
+
+    for (std::size_t i = 0; i < size0; ++i)
+    {
+        double rowMinimum = INFINITE_DISTANCE;
+
+        for (std::size_t j = 0; j < size1; ++j)
+        {
+            double cost = std::sqrt(distanceSquared(points0[i], points1[j]));
+
+            if (i == 0 && j > 0)
+                cost += current[j - 1];
+            else if (i > 0 && j == 0)
+                cost += previous[0];
+            else if (i > 0)
+                cost += std::min(std::min(previous[j], previous[j - 1]), current[j - 1]);
+
+            current[j] = cost;
+            rowMinimum = std::min(rowMinimum, cost);
+        }
+
+        // Costs only grow along a warping path, which passes through each row.
+        if (rowMinimum > threshold)
+            return INFINITE_DISTANCE;
+
+        std::swap(previous, current);
+    }
+
+    return previous[size1 - 1];
+}
+
+
+double compare(TrajectorySimilarity::Measure measure,
+               const glm::dvec2* points0, std::size_t size0,
+               const glm::dvec2* points1, std::size_t size1,
+               double threshold,
+               Workspace& workspace)
+{
+    if (size0 == 0 || size1 == 0)
+        return INFINITE_DISTANCE;
+
+    if (lowerBound(measure, points0, size0, points1, size1) > threshold)
+        return INFINITE_DISTANCE;
+
+    double result = INFINITE_DISTANCE;
+
+    switch (measure)
+    {
+        case TrajectorySimilarity::FRECHET:
+            result = frechet(points0, size0, points1, size1, threshold, workspace);
+            break;
+        case TrajectorySimilarity::HAUSDORFF:
+            result = hausdorff(points0, size0, points1, size1, threshold);
+            break;
+        case TrajectorySimilarity::DYNAMIC_TIME_WARPING:
+            result = dynamicTimeWarping(points0, size0, points1, size1, threshold, workspace);
+            break;
+    }
+
+    return result > threshold ? INFINITE_DISTANCE : result;
+}
+
+
+} // namespace
+
+
+const double TrajectorySimilarity::NO_THRESHOLD = std::numeric_limits<double>::max();
+
+
+double TrajectorySimilarity::frechet(const CoordinatePolyline& polyline0,
+                                     const CoordinatePolyline& polyline1,
+                                     double threshold)
+{
+    return distance(FRECHET, polyline0, polyline1, threshold);
+}
+
+
+double TrajectorySimilarity::hausdorff(const CoordinatePolyline& polyline0,
+                                       const CoordinatePolyline& polyline1,
+                                       double threshold)
+{
+    return distance(HAUSDORFF, polyline0, polyline1, threshold);
+}
+
+
+double TrajectorySimilarity::dynamicTimeWarping(const CoordinatePolyline& polyline0,
+                                                const CoordinatePolyline& polyline1,
+                                                double threshold)
+{
+    return distance(DYNAMIC_TIME_WARPING, polyline0, polyline1, threshold);
+}
+
+
+double TrajectorySimilarity::distance(Measure measure,
+                                      const CoordinatePolyline& polyline0,
+                                      const CoordinatePolyline& polyline1,
+                                      double threshold)
+{
+    LocalTangentPlane plane = planeFor(polyline0, polyline1);
+
+    Workspace workspace;
+    project(plane, polyline0, workspace.points0);
+    project(plane, polyline1, workspace.points1);
+
+    return compare(measure,
+                   workspace.points0.data(), workspace.points0.size(),
+                   workspace.points1.data(), workspace.points1.size(),
+                   threshold,
+                   workspace);
+}
+
+
+void TrajectorySimilarity::distance(Measure measure,
+                                    const CoordinatePolyline& query,
+                                    const CoordinatePolyline* polylines,
+                                    std::size_t size,
+                                    double* distances,
+                                    double threshold,
+                                    const Executor& executor)
+{
+    executor.run(size, [&](std::size_t begin, std::size_t end)
+    {
+        Workspace workspace;
+
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            LocalTangentPlane plane = planeFor(query, polylines[i]);
+            project(plane, query, workspace.points0);
+            project(plane, polylines[i], workspace.points1);
+
+            distances[i] = compare(measure,
+                                   workspace.points0.data(), workspace.points0.size(),
+                                   workspace.points1.data(), workspace.points1.size(),
+                                   threshold,
+                                   workspace);
+        }
+    });
+}
+
+
+double TrajectorySimilarity::lowerBound(Measure measure,
+                                        const CoordinatePolyline& polyline0,
+                                        const CoordinatePolyline& polyline1)
+{
+    if (polyline0.empty() || polyline1.empty())
+        return INFINITE_DISTANCE;
+
+    LocalTangentPlane plane = planeFor(polyline0, polyline1);
+
+    std::vector<glm::dvec2> points0;
+    std::vector<glm::dvec2> points1;
+    project(plane, polyline0, points0);
+    project(plane, polyline1, points1);
+
+    return Geo::lowerBound(measure,
+                           points0.data(), points0.size(),
+                           points1.data(), points1.size());
+}
+
+
+} } // namespace ofx::Geo
@@ -6,22 +6,38 @@
 
 
 #include "ofx/Geo/UTMLocationBounds.h"
+#include <algorithm>
+#include "ofx/Geo/CoordinateBounds.h"
+#include "ofx/Geo/GeoUtils.h"
 
 
 namespace ofx {
 namespace Geo {
 
 
+const std::size_t UTMLocationBounds::EDGE_SAMPLES = 16;
+
+
 UTMLocationBounds::UTMLocationBounds()
 {
 }
 
 
 UTMLocationBounds::UTMLocationBounds(const UTMLocation& northwest,
-                                     const UTMLocation& southeast):
-    _northwest(northwest),
-    _southeast(southeast)
+                                     const UTMLocation& southeast)
+{
+    growToInclude(northwest);
+    growToInclude(southeast);
+}
+
+
+UTMLocationBounds::UTMLocationBounds(const CoordinateBounds& bounds)
 {
+    if (bounds.isEmpty())
+        return;
+
+    _setReferenceZone(GeoUtils::toUTM(bounds.getCenter()));
+    _include(bounds);
 }
 
 
@@ -30,27 +46,320 @@ UTMLocationBounds::~UTMLocationBounds()
 }
 
 
-const UTMLocation& UTMLocationBounds::getNorthwest() const
+void UTMLocationBounds::growToInclude(const UTMLocation& location)
+{
+    if (_unset)
+        _setReferenceZone(location);
+
+    UTMPoint point = _toReferenceZone(location);
+    _include(point.easting, point.northing);
+}
+
+
+void UTMLocationBounds::growToInclude(const UTMLocationBounds& bounds)
+{
+    if (bounds._unset)
+        return;
+
+    if (_unset || (_zoneNumber == bounds._zoneNumber && _hemisphere == bounds._hemisphere))
+    {
+        growToInclude(bounds.getSouthwest());
+        growToInclude(bounds.getNortheast());
+    }
+    else
+    {
+        // The other bounds' edges are curved in this zone.
+        _include(bounds.toCoordinateBounds());
+    }
+}
+
+
+bool UTMLocationBounds::contains(const UTMLocation& location) const
+{
+    if (_unset)
+        return false;
+
+    UTMPoint point = _toReferenceZone(location);
+    return contains(point.easting, point.northing);
+}
+
+
+bool UTMLocationBounds::contains(double easting, double northing) const
+{
+    return !_unset
+        && easting >= _minEasting
+        && easting <= _maxEasting
+        && northing >= _minNorthing
+        && northing <= _maxNorthing;
+}
+
+
+std::size_t UTMLocationBounds::contains(const double* eastings,
+                                        const double* northings,
+                                        std::size_t size,
+                                        std::uint8_t* results) const
+{
+    if (_unset)
+    {
+        std::fill(results, results + size, 0);
+        return 0;
+    }
+
+    // Copy to locals so the compiler knows they are not aliased by results.
+    const double minEasting = _minEasting;
+    const double maxEasting = _maxEasting;
+    const double minNorthing = _minNorthing;
+    const double maxNorthing = _maxNorthing;
+
+    std::size_t count = 0;
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        std::uint8_t inside = (eastings[i] >= minEasting)
+                            & (eastings[i] <= maxEasting)
+                            & (northings[i] >= minNorthing)
+                            & (northings[i] <= maxNorthing);
+        results[i] = inside;
+        count += inside;
+    }
+
+    return count;
+}
+
+
+bool UTMLocationBounds::intersects(const UTMLocationBounds& bounds) const
+{
+    if (_unset || bounds._unset)
+        return false;
+
+    UTMLocationBounds other;
+
+    if (_zoneNumber == bounds._zoneNumber && _hemisphere == bounds._hemisphere)
+        other = bounds;
+    else
+    {
+        other._zone = _zone;
+        other._zoneNumber = _zoneNumber;
+        other._hemisphere = _hemisphere;
+        other._include(bounds.toCoordinateBounds());
+    }
+
+    return other._minEasting <= _maxEasting
+        && other._maxEasting >= _minEasting
+        && other._minNorthing <= _maxNorthing
+        && other._maxNorthing >= _minNorthing;
+}
+
+
+bool UTMLocationBounds::isEmpty() const
+{
+    return _unset;
+}
+
+
+double UTMLocationBounds::getWidth() const
+{
+    return _maxEasting - _minEasting;
+}
+
+
+double UTMLocationBounds::getHeight() const
+{
+    return _maxNorthing - _minNorthing;
+}
+
+
+double UTMLocationBounds::getArea() const
+{
+    return getWidth() * getHeight();
+}
+
+
+const std::string& UTMLocationBounds::getZone() const
+{
+    return _zone;
+}
+
+
+UTMLocation UTMLocationBounds::getNorthwest() const
 {
-    return _northwest;
+    return _location(_minEasting, _maxNorthing);
 }
 
 
 void UTMLocationBounds::setNorthwest(const UTMLocation& northwest)
 {
-    _northwest = northwest;
+    if (_unset)
+    {
+        growToInclude(northwest);
+        return;
+    }
+
+    UTMPoint point = _toReferenceZone(northwest);
+    _minEasting = point.easting;
+    _maxNorthing = point.northing;
+    _normalize();
 }
 
 
-const UTMLocation& UTMLocationBounds::getSoutheast() const
+UTMLocation UTMLocationBounds::getSoutheast() const
 {
-    return _southeast;
+    return _location(_maxEasting, _minNorthing);
 }
 
 
 void UTMLocationBounds::setSoutheast(const UTMLocation& southeast)
 {
-    _southeast = southeast;
+    if (_unset)
+    {
+        growToInclude(southeast);
+        return;
+    }
+
+    UTMPoint point = _toReferenceZone(southeast);
+    _maxEasting = point.easting;
+    _minNorthing = point.northing;
+    _normalize();
+}
+
+
+UTMLocation UTMLocationBounds::getSouthwest() const
+{
+    return _location(_minEasting, _minNorthing);
+}
+
+
+UTMLocation UTMLocationBounds::getNortheast() const
+{
+    return _location(_maxEasting, _maxNorthing);
+}
+
+
+CoordinateBounds UTMLocationBounds::toCoordinateBounds() const
+{
+    CoordinateBounds bounds;
+
+    if (_unset)
+        return bounds;
+
+    UTMPoint point;
+    point.zoneNumber = _zoneNumber;
+    point.band = 'Z';
+    point.hemisphere = _hemisphere;
+
+    for (std::size_t i = 0; i <= EDGE_SAMPLES; ++i)
+    {
+        double t = double(i) / EDGE_SAMPLES;
+        double easting = glm::mix(_minEasting, _maxEasting, t);
+        double northing = glm::mix(_minNorthing, _maxNorthing, t);
+
+        for (const auto& position: { glm::dvec2(easting, _minNorthing),
+                                     glm::dvec2(easting, _maxNorthing),
+                                     glm::dvec2(_minEasting, northing),
+                                     glm::dvec2(_maxEasting, northing) })
+        {
+            point.easting = position.x;
+            point.northing = position.y;
+            bounds.growToInclude(GeoUtils::toCoordinate(point));
+        }
+    }
+
+    return bounds;
+}
+
+
+std::string UTMLocationBounds::toString() const
+{
+    return getSouthwest().toString() + ", " + getNortheast().toString();
+}
+
+
+UTMPoint UTMLocationBounds::_toReferenceZone(const UTMLocation& location) const
+{
+    UTMPoint point = GeoUtils::toUTMPoint(location);
+
+    if (point.zoneNumber == _zoneNumber && point.hemisphere == _hemisphere)
+        return point;
+
+    return GeoUtils::toUTMPoint(GeoUtils::toCoordinate(point),
+                                _zoneNumber,
+                                _hemisphere);
+}
+
+
+void UTMLocationBounds::_setReferenceZone(const UTMLocation& location)
+{
+    UTMPoint point = GeoUtils::toUTMPoint(location);
+    _zone = location.getZone();
+    _zoneNumber = point.zoneNumber;
+    _hemisphere = point.hemisphere;
+}
+
+
+void UTMLocationBounds::_include(double easting, double northing)
+{
+    if (_unset)
+    {
+        _minEasting = _maxEasting = easting;
+        _minNorthing = _maxNorthing = northing;
+        _unset = false;
+        return;
+    }
+
+    _minEasting = std::min(easting, _minEasting);
+    _maxEasting = std::max(easting, _maxEasting);
+    _minNorthing = std::min(northing, _minNorthing);
+    _maxNorthing = std::max(northing, _maxNorthing);
+}
+
+
+void UTMLocationBounds::_normalize()
+{
+    // A corner past the opposite corner swaps the extents, so the box is
+    // spanned by the two corners as in the constructor.
+    if (_minEasting > _maxEasting)
+        std::swap(_minEasting, _maxEasting);
+
+    if (_minNorthing > _maxNorthing)
+        std::swap(_minNorthing, _maxNorthing);
+}
+
+
+void UTMLocationBounds::_include(const CoordinateBounds& bounds)
+{
+    double south = bounds.getSouth();
+    double north = bounds.getNorth();
+    double west = bounds.getWest();
+
+    // Sample eastward from the west edge, which may cross the antimeridian.
+    double east = west + bounds.getWidth();
+
+    for (std::size_t i = 0; i <= EDGE_SAMPLES; ++i)
+    {
+        double t = double(i) / EDGE_SAMPLES;
+        double latitude = glm::mix(south, north, t);
+        double longitude = glm::mix(west, east, t);
+
+        if (longitude > 180)
+            longitude -= 360;
+
+        for (const auto& coordinate: { Coordinate(latitude, west),
+                                       Coordinate(latitude, east > 180 ? east - 360 : east),
+                                       Coordinate(south, longitude),
+                                       Coordinate(north, longitude) })
+        {
+            UTMPoint point = GeoUtils::toUTMPoint(coordinate,
+                                                  _zoneNumber,
+                                                  _hemisphere);
+            _include(point.easting, point.northing);
+        }
+    }
+}
+
+
+UTMLocation UTMLocationBounds::_location(double easting, double northing) const
+{
+    return UTMLocation(easting, northing, _zone);
 }
 
 
@@ -0,0 +1,200 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofx/Geo/WebMercator.h"
+#include <algorithm>
+#include <cmath>
+
+
+namespace ofx {
+namespace Geo {
+
+
+const double WebMercator::EARTH_RADIUS_M = 6378137.0;
+const double WebMercator::MAX_LATITUDE = 85.0511287798066;
+const double WebMercator::TILE_SIZE = 256;
+const int WebMercator::MAX_ZOOM = 30;
+
+
+glm::dvec2 WebMercator::toMeters(const Coordinate& coordinate)
+{
+    glm::dvec2 normalized = _toNormalized(coordinate.getLatitude(),
+                                          coordinate.getLongitude());
+
+    double size = glm::two_pi<double>() * EARTH_RADIUS_M;
+
+    return glm::dvec2((normalized.x - 0.5) * size, (0.5 - normalized.y) * size);
+}
+
+
+Coordinate WebMercator::fromMeters(const glm::dvec2& meters)
+{
+    double size = glm::two_pi<double>() * EARTH_RADIUS_M;
+
+    return _fromNormalized(glm::dvec2(meters.x / size + 0.5, 0.5 - meters.y / size));
+}
+
+
+glm::dvec2 WebMercator::toPixel(const Coordinate& coordinate,
+                                double zoom,
+                                double tileSize)
+{
+    return _toNormalized(coordinate.getLatitude(), coordinate.getLongitude())
+         * (tileSize * std::exp2(zoom));
+}
+
+
+Coordinate WebMercator::fromPixel(const glm::dvec2& pixel,
+                                  double zoom,
+                                  double tileSize)
+{
+    return _fromNormalized(pixel / (tileSize * std::exp2(zoom)));
+}
+
+
+Tile WebMercator::toTile(const Coordinate& coordinate, int zoom)
+{
+    zoom = std::max(0, std::min(MAX_ZOOM, zoom));
+
+    int numTiles = 1 << zoom;
+
+    glm::dvec2 position = _toNormalized(coordinate.getLatitude(),
+                                        coordinate.getLongitude()) * double(numTiles);
+
+    Tile tile;
+    tile.x = std::max(0, std::min(numTiles - 1, int(std::floor(position.x))));
+    tile.y = std::max(0, std::min(numTiles - 1, int(std::floor(position.y))));
+    tile.zoom = zoom;
+    return tile;
+}
+
+
+CoordinateBounds WebMercator::getBounds(const Tile& tile)
+{
+    double numTiles = double(1 << std::max(0, std::min(MAX_ZOOM, tile.zoom)));
+
+    Coordinate northwest = _fromNormalized(glm::dvec2(tile.x, tile.y) / numTiles);
+    Coordinate southeast = _fromNormalized(glm::dvec2(tile.x + 1, tile.y + 1) / numTiles);
+
+    return CoordinateBounds(northwest, southeast);
+}
+
+
+std::size_t WebMercator::getTiles(const CoordinateBounds& bounds,
+                                  int zoom,
+                                  std::vector<Tile>& tiles)
+{
+    std::size_t count = tiles.size();
+
+    zoom = std::max(0, std::min(MAX_ZOOM, zoom));
+
+    CoordinateBounds boxes[2];
+    std::size_t numBoxes = bounds.split(boxes);
+
+    if (numBoxes == 0)
+        return 0;
+
+    // Rows are shared by both halves of a split box.
+    Tile north = toTile(Coordinate(bounds.getNorth(), 0), zoom);
+    Tile south = toTile(Coordinate(bounds.getSouth(), 0), zoom);
+
+    int columns[2][2] = { { 0, -1 }, { 0, -1 } };
+
+    for (std::size_t i = 0; i < numBoxes; ++i)
+    {
+        columns[i][0] = toTile(Coordinate(0, boxes[i].getWest()), zoom).x;
+        columns[i][1] = toTile(Coordinate(0, boxes[i].getEast()), zoom).x;
+    }
+
+    // Halves meeting in the same column, e.g. at zoom 0, become one range.
+    if (numBoxes == 2 && columns[1][1] >= columns[0][0])
+    {
+        columns[0][0] = 0;
+        columns[0][1] = (1 << zoom) - 1;
+        columns[1][1] = -1;
+    }
+
+    for (int y = north.y; y <= south.y; ++y)
+    {
+        // List columns west to east across the antimeridian.
+        for (int i = 0; i < 2; ++i)
+        {
+            for (int x = columns[i][0]; x <= columns[i][1]; ++x)
+                tiles.push_back({ x, y, zoom });
+        }
+    }
+
+    return tiles.size() - count;
+}
+
+
+void WebMercator::toPixels(const Coordinate* coordinates,
+                           std::size_t size,
+                           double zoom,
+                           const glm::dvec2& origin,
+                           float* vertices,
+                           std::size_t stride,
+                           double tileSize)
+{
+    double scale = tileSize * std::exp2(zoom);
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        glm::dvec2 pixel = _toNormalized(coordinates[i].getLatitude(),
+                                         coordinates[i].getLongitude()) * scale;
+
+        vertices[i * stride] = float(pixel.x - origin.x);
+        vertices[i * stride + 1] = float(pixel.y - origin.y);
+    }
+}
+
+
+void WebMercator::toPixels(const double* latitudes,
+                           const double* longitudes,
+                           std::size_t size,
+                           double zoom,
+                           const glm::dvec2& origin,
+                           float* vertices,
+                           std::size_t stride,
+                           double tileSize)
+{
+    double scale = tileSize * std::exp2(zoom);
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        glm::dvec2 pixel = _toNormalized(latitudes[i], longitudes[i]) * scale;
+
+        vertices[i * stride] = float(pixel.x - origin.x);
+        vertices[i * stride + 1] = float(pixel.y - origin.y);
+    }
+}
+
+
+glm::dvec2 WebMercator::_toNormalized(double latitude, double longitude)
+{
+    latitude = std::max(-MAX_LATITUDE, std::min(MAX_LATITUDE, latitude));
+
+    double sinLatitude = std::sin(glm::radians(latitude));
+
+    // ln(tan(pi / 4 + lat / 2)) written with a single sine.
+    double y = 0.5 - std::log((1.0 + sinLatitude) / (1.0 - sinLatitude))
+                   / (4.0 * glm::pi<double>());
+
+    return glm::dvec2((longitude + 180.0) / 360.0, y);
+}
+
+
+Coordinate WebMercator::_fromNormalized(const glm::dvec2& normalized)
+{
+    double n = glm::pi<double>() * (1.0 - 2.0 * normalized.y);
+
+    return Coordinate(glm::degrees(std::atan(std::sinh(n))),
+                      normalized.x * 360.0 - 180.0);
+}
+
+
+} } // namespace ofx::Geo
@@ -9,9 +9,36 @@
 
 
 #include "UTM/UTM.h"
+#include "ofx/Geo/CellId.h"
+#include "ofx/Geo/CellIndex.h"
+#include "ofx/Geo/Clustering.h"
+#include "ofx/Geo/CompensatedSum.h"
+#include "ofx/Geo/ConvexHull.h"
 #include "ofx/Geo/Coordinate.h"
+#include "ofx/Geo/CoordinateBounds.h"
+#include "ofx/Geo/CoordinateCodec.h"
 #include "ofx/Geo/CoordinatePolyline.h"
+#include "ofx/Geo/CoordinateTrack.h"
+#include "ofx/Geo/Corridor.h"
+#include "ofx/Geo/ElevationProfile.h"
+#include "ofx/Geo/Executor.h"
+#include "ofx/Geo/GreatCircleArc.h"
+#include "ofx/Geo/LocalTangentPlane.h"
+#include "ofx/Geo/MarkerIndex.h"
+#include "ofx/Geo/NVector.h"
+#include "ofx/Geo/PointQuery.h"
+#include "ofx/Geo/PolygonMeasure.h"
+#include "ofx/Geo/PolylineClipper.h"
+#include "ofx/Geo/PolylinePyramid.h"
+#include "ofx/Geo/RollingStatistics.h"
+#include "ofx/Geo/SegmentIntersector.h"
+#include "ofx/Geo/SpatialHash.h"
+#include "ofx/Geo/TrackFile.h"
+#include "ofx/Geo/TrackFilter.h"
+#include "ofx/Geo/TrajectorySimilarity.h"
 #include "ofx/Geo/UTMLocation.h"
+#include "ofx/Geo/UTMLocationBounds.h"
+#include "ofx/Geo/WebMercator.h"
 #include "ofx/Geo/GeoUtils.h"
 
 